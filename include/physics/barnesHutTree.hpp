@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/vec2.hpp"
+
+class world;
+class ThreadPool;
+
+// ====================================================================
+// --- BARNES-HUT QUADTREE (mutual gravity) ---
+// Bodies are sorted by the Morton code of their position inside the square
+// bounding box of the step, and the quadtree is built top-down over the sorted
+// ranges. Nodes are stored SoA in depth-first preorder: the first child of an
+// internal node is the next node, and next[n] skips the whole subtree, so
+// traversals need no stack. Every node carries the mass and center of mass of
+// its bodies; far nodes stand in for all of them.
+// ====================================================================
+class BarnesHutTree
+{
+public:
+    // Node columns. Bodies of node n are order[body_begin[n] .. body_end[n]).
+    std::vector<int> next;
+    std::vector<int> body_begin;
+    std::vector<int> body_end;
+    std::vector<uint8_t> leaf;
+    std::vector<uint8_t> depth;
+    std::vector<float> center_x; // Square cell of the node
+    std::vector<float> center_y;
+    std::vector<float> half_size;
+    std::vector<float> mass;
+    std::vector<float> com_x; // Center of mass
+    std::vector<float> com_y;
+
+    // Body indices in Morton order, and their positions and masses in that order
+    std::vector<int> order;
+    std::vector<float> sorted_x;
+    std::vector<float> sorted_y;
+    std::vector<float> sorted_mass;
+
+    // Group nodes in preorder: the largest nodes with at most 32 bodies. Their
+    // slot ranges tile [0, bodies); each shares one interaction list.
+    std::vector<int> groups;
+
+    // Far cells and near bodies seen from one group (per-thread scratch)
+    struct InteractionList
+    {
+        std::vector<float> mass;
+        std::vector<float> x;
+        std::vector<float> y;
+    };
+
+    // Rebuild over the world's bodies (those with mass <= 0 exert no pull).
+    // pool may be null: everything then runs on the calling thread.
+    void build(const world &simulation_world, ThreadPool *pool = nullptr);
+
+    // Gravitational acceleration (per unit of G) at the body in Morton slot
+    // `slot`, opening nodes whose size / distance is at least theta.
+    // softening is the Plummer length added to every distance.
+    vec2 acceleration_at_slot(int slot, float theta, float softening) const;
+
+    // Acceleration (per unit of G) of every body of groups[group_index],
+    // written to ax/ay[slot] for its Morton slots. The tree is walked once for
+    // the whole group: a cell is taken whole when its size / distance to the
+    // group's bounding box is below theta, which is never looser than the
+    // per-body test.
+    void group_accelerations(int group_index, float theta, float softening, InteractionList &list, float *ax, float *ay) const;
+
+    // Same, by direct summation over every body (reference for tests).
+    vec2 direct_acceleration_at_slot(int slot, float softening) const;
+
+    size_t num_nodes() const { return next.size(); }
+
+private:
+    std::vector<uint32_t> codes;
+    std::vector<uint32_t> code_scratch;
+    std::vector<int> order_scratch;
+    // Per-worker bounding boxes and aggregation subtrees of build(), kept
+    // across builds so a steady-state step does not allocate
+    std::vector<float> worker_bounds;
+    std::vector<int> task_roots;
+
+    void sort_by_code();
+    int build_node(int begin, int end, int level, float cx, float cy, float half, uint8_t node_depth, bool grouped);
+    void aggregate(int node);
+};
@@ -1,6 +1,7 @@
 
 
 #pragma once
+#include <cstdint>
 #include "math/vec2.hpp"
 
 struct body
@@ -16,6 +17,10 @@ struct body
     float damping = 0.0f;
     float friction = 0.0f;
     float restitution = 1.0f;
+    // Collision layer bit(s) this body belongs to, and the layers it collides with.
+    // A pair collides only if each body's category intersects the other's mask.
+    uint32_t collision_category = 1u;
+    uint32_t collision_mask = ~0u;
 
     body();
     body(const vec2 &position,
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/vec2.hpp"
+
+struct world;
+
+enum class CollisionEventType : uint8_t
+{
+    Begin,   // First step the pair is in contact
+    Persist, // Pair still in contact (only reported when report_persist is set)
+    End      // First step the pair is no longer in contact
+};
+
+struct CollisionEvent
+{
+    CollisionEventType type;
+    int body_A;    // Lower SoA index of the pair
+    int body_B;    // Higher SoA index of the pair
+    float impulse; // Normal impulse of the step (last contact step for End events)
+    vec2 normal;   // Direction from A to B
+    vec2 point;    // Contact point on the surface of A
+};
+
+struct CollisionEventFilter
+{
+    uint32_t layer_mask = ~0u;  // Keep events where either body's category intersects this mask
+    float min_impulse = 0.0f;   // Keep events whose impulse is at least this large
+};
+
+// Collision events of one step, in one contiguous array. Events come from the
+// contact cache, which collisionSystem feeds on one thread in contact order
+// (even when islands are resolved concurrently), so a single writer appends.
+class CollisionEventStream
+{
+public:
+    bool report_persist = false;
+
+    // Clear the previous step's events.
+    void begin_step() { step_events.clear(); }
+
+    void push(const CollisionEvent &event) { step_events.push_back(event); }
+
+    // Deterministic order independent of how work was split: by pair, then type.
+    void sort();
+
+    const std::vector<CollisionEvent> &events() const { return step_events; }
+
+    // Append the events passing `filter` to `out`.
+    void filter(const world &simulation_world, const CollisionEventFilter &filter, std::vector<CollisionEvent> &out) const;
+
+private:
+    std::vector<CollisionEvent> step_events;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "math/vec2.hpp"
+
+// ====================================================================
+// --- CONSTRAINTS (distance, spring, pin) ---
+// Position-level constraints between bodies, stored SoA. Distance and spring
+// rows share one layout (a spring is a distance row with stiffness below 1);
+// pins hold one body at a world-space anchor. Rows are graph-coloured so that
+// no two rows of one colour share a body: a colour batch can be relaxed in
+// any order, split across threads and packed into SIMD lanes.
+// ====================================================================
+
+class ConstraintSet
+{
+public:
+    // Relaxation passes per step (constraintSystem; XPBD uses one per substep)
+    int iterations = 8;
+
+    // Distance / spring rows
+    std::vector<int> body_a;
+    std::vector<int> body_b;
+    std::vector<float> rest_length;
+    std::vector<float> stiffness;  // Verlet relaxation: fraction of the length error removed per pass, in (0, 1]
+    std::vector<float> compliance; // XPBD: inverse stiffness (m/N); 0 is rigid
+
+    // Pins
+    std::vector<int> pin_body;
+    std::vector<float> pin_x;
+    std::vector<float> pin_y;
+
+    // Each returns the new row (or pin) index.
+    int add_distance(int a, int b, float rest_length);
+    // stiffness drives the Verlet relaxation, compliance the XPBD integrator.
+    int add_spring(int a, int b, float rest_length, float stiffness, float compliance = 0.0f);
+    int add_pin(int body, const vec2 &anchor);
+
+    void clear();
+
+    size_t num_rows() const { return body_a.size(); }
+    size_t num_pins() const { return pin_body.size(); }
+    bool empty() const { return body_a.empty() && pin_body.empty(); }
+
+    // Colouring: the rows of colour c are colored_rows[color_start[c] .. color_start[c + 1]).
+    std::vector<int> color_start;
+    std::vector<int> colored_rows;
+    size_t num_colors() const { return color_start.empty() ? 0 : color_start.size() - 1; }
+
+    // Recolour if rows were added or removed (or the body count changed) since the last call.
+    void update_colors(size_t num_bodies);
+    // Call after editing body_a/body_b directly.
+    void mark_dirty() { dirty = true; }
+
+    // Follow world::remove_body's swap-removal: rows and pins on `removed` are
+    // dropped and body `moved` is renumbered to `removed`.
+    void on_body_removed(int removed, int moved);
+
+private:
+    bool dirty = false;
+    size_t colored_bodies = 0; // Body count of the last colouring
+};
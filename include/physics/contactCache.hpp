@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/vec2.hpp"
+
+// ====================================================================
+// --- COLLISION DATA STRUCTURES ---
+// The ContactManifold structure stores all key collision information
+// for one body pair. Bodies are referenced by SoA index (idxA < idxB).
+// ====================================================================
+
+struct ContactManifold
+{
+    int body_A = -1;                    // Index of the first body involved
+    int body_B = -1;                    // Index of the second body involved
+    vec2 normal_direction;              // Unit vector of the collision (direction from A to B)
+    float penetration_depth = 0.0f;     // Magnitude of the overlap between bodies
+    float effective_restitution = 0.0f; // Average coefficient of restitution
+    float inverse_mass_sum = 0.0f;      // Sum of inverse masses (1/mA + 1/mB)
+    float normal_impulse = 0.0f;        // Normal impulse applied to the pair this step
+};
+
+struct ContactCacheEntry
+{
+    uint64_t key = 0;
+    ContactManifold manifold;
+    float previous_impulse = 0.0f; // normal_impulse of the previous step (warm start)
+    uint32_t first_frame = 0;      // Frame the contact began
+    uint32_t last_frame = 0;       // Last frame the contact was touched
+};
+
+// Persistent contact cache keyed by the packed body pair. Open addressing with
+// linear probing over flat arrays, so steady-state frames do not allocate.
+// Entries survive `max_age_frames` frames without contact before eviction,
+// which gives begin / persist / end contact states across frames.
+// Keys are SoA indices: world::remove_body reports each swap-removal, and the
+// cache drops the removed body's entries and re-keys the moved body's. The
+// renumbering of a run of removals is applied in one pass on the next access.
+class ContactCache
+{
+public:
+    uint32_t max_age_frames = 4;
+
+    static uint64_t make_key(int idxA, int idxB)
+    {
+        uint32_t lo = uint32_t(idxA < idxB ? idxA : idxB);
+        uint32_t hi = uint32_t(idxA < idxB ? idxB : idxA);
+        return (uint64_t(lo) << 32) | hi;
+    }
+
+    // Advance the frame counter; call once before recording a step's contacts.
+    void begin_frame() { ++frame; }
+
+    // Record a contact found this frame, keeping the previous impulse for warm
+    // starting. The entry's manifold is stored with body_A < body_B.
+    ContactCacheEntry &record(const ContactManifold &manifold);
+
+    // Entry for the pair, or null when it is not cached.
+    const ContactCacheEntry *find(int idxA, int idxB) const;
+
+    // Drop entries untouched for more than max_age_frames frames.
+    void evict_stale();
+
+    void clear();
+
+    // world::remove_body swap-removed `idx`: body `last` now lives at `idx`.
+    void on_body_removed(int idx, int last);
+
+    uint32_t current_frame() const { return frame; }
+    size_t size() const
+    {
+        apply_removals();
+        return count;
+    }
+
+    // Contact state relative to the current frame
+    bool began(const ContactCacheEntry &e) const { return e.first_frame == frame; }
+    bool touching(const ContactCacheEntry &e) const { return e.last_frame == frame; }
+    bool ended(const ContactCacheEntry &e) const { return e.last_frame + 1 == frame; }
+
+    // Visit every live entry (order unspecified).
+    template <typename F>
+    void for_each(F &&fn) const
+    {
+        apply_removals();
+        for (const auto &slot : slots)
+            if (slot.key != EMPTY_KEY)
+                fn(slot);
+    }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t(0);
+    static const ContactCacheEntry EMPTY_ENTRY; // Free slot (key == EMPTY_KEY)
+
+    size_t probe_start(uint64_t key) const;
+    void rehash(size_t new_capacity);
+    // Re-key or drop the entries touched by the removals since the last access
+    void apply_removals() const;
+
+    // Mutable: the pending renumbering is applied lazily, also by const readers
+    mutable std::vector<ContactCacheEntry> slots;
+    mutable std::vector<ContactCacheEntry> scratch;
+    mutable size_t count = 0;
+    uint32_t frame = 0;
+
+    // Pending removals as a permutation: index of each body when the run of
+    // removals began -> its index now (-1 once removed), and the inverse
+    mutable std::vector<int> current_of;
+    mutable std::vector<int> original_at;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "math/vec2.hpp"
+
+struct GridInfo;
+
+enum class ForceFieldType : uint8_t
+{
+    GravityWell,  // Pull towards the center, fading linearly to 0 at the radius (negative strength repels)
+    Wind,         // Uniform acceleration inside an axis-aligned box
+    RadialImpulse // One-shot outward velocity change, fading linearly to 0 at the radius
+};
+
+// ====================================================================
+// --- FORCE FIELDS (gravity wells, wind zones, radial impulses) ---
+// Localized external accelerations, stored SoA. Every field has an AABB and
+// is binned into a uniform grid with the body grid's bounds and cell size
+// (CSR, like StaticGeometry), so a body only evaluates the fields whose AABB
+// touches its cell instead of every field in the world.
+// ====================================================================
+class ForceFieldSet
+{
+public:
+    // Field columns. Wells and impulses use (center, extent_x = radius);
+    // wind zones use (center, half extents) and (direction_x, direction_y)
+    // as their acceleration.
+    std::vector<ForceFieldType> type;
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> extent_x;
+    std::vector<float> extent_y;
+    std::vector<float> strength;  // Well: acceleration at the center; impulse: velocity change at the center
+    std::vector<float> direction_x;
+    std::vector<float> direction_y;
+
+    // Each returns the new field's index.
+    int add_gravity_well(const vec2 &center, float radius, float strength);
+    int add_wind(const vec2 &min, const vec2 &max, const vec2 &acceleration);
+    int add_radial_impulse(const vec2 &center, float radius, float speed);
+
+    // Moving a field re-bins it on the next bake.
+    void set_center(int field, const vec2 &center);
+
+    void clear();
+    size_t size() const { return type.size(); }
+
+    // Impulses act for one step: forceFieldSystem drops them after applying them.
+    void remove_impulses();
+
+    // Bin every field into a grid with `grid`'s bounds and cell size. Fields
+    // reaching outside the bounds are clamped to the border cells, like the
+    // lookups of bodies outside the grid. forceFieldSystem bakes lazily.
+    void bake(const GridInfo &grid);
+    bool needs_bake() const { return dirty; }
+
+    // Acceleration of one field at a point (zero outside it). An impulse acts
+    // as delta_v / delta_time for the single step it lives.
+    vec2 field_acceleration(int field, float x, float y, float delta_time) const;
+
+    // Sum over the fields binned in the point's cell. Requires a bake.
+    vec2 acceleration_at(float x, float y, float delta_time) const;
+
+private:
+    bool dirty = false;
+
+    // Baked grid
+    float grid_min_x = 0.0f;
+    float grid_min_y = 0.0f;
+    float cell_size = 1.0f;
+    int num_cells_x = 0;
+    int num_cells_y = 0;
+    std::vector<int> cell_start; // num_cells + 1 entries
+    std::vector<int> cell_fields;
+
+    int cell_x(float x) const { return std::min(std::max(int((x - grid_min_x) / cell_size), 0), num_cells_x - 1); }
+    int cell_y(float y) const { return std::min(std::max(int((y - grid_min_y) / cell_size), 0), num_cells_y - 1); }
+
+    int add_field(ForceFieldType field_type, const vec2 &center, float half_x, float half_y, float field_strength, const vec2 &direction);
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class world;
+
+// ====================================================================
+// --- VERLET NEIGHBOUR LIST (skin distance) ---
+// Candidate pairs closer than radius_a + radius_b + skin, kept across frames
+// in CSR form. While no body has moved more than skin / 2 since the build,
+// every pair that can be touching is still in the list, so the broad phase
+// can be skipped. Built from the grid's candidate pairs, so it relies on
+// radius_a + radius_b + skin <= GridInfo::cell_size: collisionSystem clamps
+// the skin to cell_size - 2 * max radius, and uses the grid pairs directly
+// when that leaves no skin.
+// ====================================================================
+class NeighborList
+{
+public:
+    // Pairs of body i are (i, neighbors[k]) for k in [start[i], start[i + 1]).
+    std::vector<int> start;
+    std::vector<int> neighbors;
+
+    // Positions and skin at the last build
+    std::vector<float> reference_x;
+    std::vector<float> reference_y;
+    float built_skin = 0.0f;
+
+    // Builds over the list's lifetime (for profiling)
+    uint64_t rebuild_count = 0;
+
+    // True when the list is missing, was invalidated, the body count or skin
+    // changed, or some body moved more than skin / 2 since the build.
+    bool needs_rebuild(const world &simulation_world, float skin) const;
+
+    // Keep the candidate pairs within radius_a + radius_b + skin.
+    void build(const world &simulation_world, const std::pair<int, int> *pairs, size_t count, float skin);
+
+    // world::add_body / remove_body call this; so must code that edits radius.
+    void invalidate() { valid = false; }
+
+    bool contains(int a, int b) const;
+    size_t num_pairs() const { return neighbors.size(); }
+
+private:
+    bool valid = false;
+};
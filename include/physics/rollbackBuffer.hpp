@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class world;
+
+// ====================================================================
+// --- ROLLBACK BUFFER (recent world states for resimulation) ---
+// Ring of the last capacity() saved frames. A frame keeps only the columns a
+// step changes: position, previous position and velocity. Everything else
+// (mass, radius, layers, fields...) is assumed unchanged between the saved
+// frame and the restore, so saving and restoring are six memcpys.
+//
+// Restoring also drops what the step derives from positions (the neighbour
+// list, the incremental grid order), so a restored world resimulates the same
+// way every time. Frames can only be restored while the body count is the one
+// they were saved with.
+//
+// Dirty tracking (optional): each save records which blocks of
+// DIRTY_BLOCK_BODIES bodies differ from the previous save. restore_dirty()
+// then copies only the blocks that changed after the target frame, which is
+// exact when the world has not been stepped since the newest save (the usual
+// save-every-step, restore-on-late-input pattern). Sleeping or resting parts
+// of a large world are skipped.
+// ====================================================================
+class RollbackBuffer
+{
+public:
+    static constexpr size_t DIRTY_BLOCK_BODIES = 512;
+
+    explicit RollbackBuffer(size_t capacity = 16, bool track_dirty_blocks = false);
+
+    // Save the world as `frame`. Frames are held while saved consecutively:
+    // saving a frame at or before the newest one replaces it and drops the
+    // newer ones (that history was rolled back and is being resimulated), and
+    // skipping frames forgets the older ones.
+    void save(const world &world, uint64_t frame);
+
+    // Restore a saved frame; false when it is no longer (or not yet) held, or
+    // the body count changed since it was saved.
+    bool restore(world &world, uint64_t frame) const;
+    // Same, copying only the blocks changed since `frame` (see above). Falls
+    // back to a full restore when dirty tracking is off.
+    bool restore_dirty(world &world, uint64_t frame) const;
+
+    bool holds(uint64_t frame) const { return count > 0 && frame <= newest && newest - frame < count; }
+    uint64_t newest_frame() const { return newest; }
+    uint64_t oldest_frame() const { return newest + 1 - count; }
+    size_t frames_held() const { return count; }
+    size_t capacity() const { return slots.size(); }
+
+    // Blocks copied by the last restore (for measurements).
+    mutable size_t last_restored_blocks = 0;
+
+private:
+    static constexpr int COLUMNS = 6; // x, y, previous x, previous y, vx, vy
+
+    struct Slot
+    {
+        uint64_t frame = 0;
+        size_t bodies = 0;
+        std::vector<float> data;          // COLUMNS columns of `bodies` floats
+        std::vector<uint8_t> dirty_block; // 1 where the block differs from the previous save
+    };
+
+    std::vector<Slot> slots;
+    bool track_dirty = false;
+    size_t count = 0;
+    uint64_t newest = 0;
+
+    const Slot &slot_of(uint64_t frame) const { return slots[frame % slots.size()]; }
+    void copy_to_world(const Slot &slot, world &world, size_t first_body, size_t last_body) const;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "math/vec2.hpp"
+
+struct world;
+class ThreadPool;
+
+// ====================================================================
+// --- SPATIAL QUERIES over the broad-phase grid ---
+// Read-only view over the CSR grid that collisionSystem builds each step
+// (world::particle_start_indices / sorted_indices). Results reflect body
+// positions at the time of the last collisionSystem update; bodies outside
+// the grid bounds are not indexed and never reported. While the grid is stale
+// (bodies added or removed since that update) every query returns nothing.
+// The largest body radius is taken when the view is constructed, so build a
+// fresh spatialQuery after each step rather than keeping one across steps.
+// ====================================================================
+
+struct AABB
+{
+    vec2 min;
+    vec2 max;
+};
+
+struct Ray
+{
+    vec2 origin;
+    vec2 direction;     // Need not be normalized
+    float max_distance; // Segment length along the normalized direction
+};
+
+struct RayHit
+{
+    int body = -1;         // -1 when nothing was hit
+    float distance = 0.0f; // Distance from the ray origin to the hit point
+    vec2 point;
+    vec2 normal; // Surface normal of the body at the hit point
+};
+
+// Results of a batched query in CSR form: the hits of query q are
+// indices[offsets[q] .. offsets[q + 1]). Reuse one instance across frames
+// to keep its buffers warm.
+struct QueryResults
+{
+    std::vector<int> offsets;
+    std::vector<int> indices;
+    std::vector<std::vector<int>> worker_indices; // per-worker scratch
+    std::vector<int> counts;                      // per-query scratch
+
+    size_t num_queries() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    const int *begin(size_t q) const { return indices.data() + offsets[q]; }
+    const int *end(size_t q) const { return indices.data() + offsets[q + 1]; }
+};
+
+class spatialQuery
+{
+private:
+    const world &simulation_world;
+    ThreadPool *pool;
+    float max_radius = 0.0f; // At construction
+
+    // The grid still describes the world's bodies (see the header comment)
+    bool grid_is_current() const;
+
+    // Clamped cell coordinates of a world-space point
+    int cell_x(float x) const;
+    int cell_y(float y) const;
+
+    template <typename Visit>
+    void visit_cells(float min_x, float min_y, float max_x, float max_y, Visit &&visit) const;
+
+    template <typename Query>
+    void run_batch(size_t count, QueryResults &results, Query &&query) const;
+
+public:
+    // Bodies whose circle overlaps the box.
+    void query_aabb(const AABB &box, std::vector<int> &out) const;
+
+    // Bodies whose circle overlaps the disc (center, query_radius).
+    void query_radius(const vec2 &center, float query_radius, std::vector<int> &out) const;
+
+    // The k bodies with centers closest to point, nearest first.
+    void query_k_nearest(const vec2 &point, int k, std::vector<int> &out) const;
+
+    // First body hit by the segment origin + t * normalize(direction), t in [0, max_distance].
+    // Walks the grid cells along the segment with a DDA.
+    bool raycast(const Ray &ray, RayHit &hit) const;
+
+    // Batched variants: answer `count` queries at once, split across the pool's workers.
+    void query_aabb_batch(const AABB *boxes, size_t count, QueryResults &results) const;
+    void query_radius_batch(const vec2 *centers, const float *radii, size_t count, QueryResults &results) const;
+    void query_k_nearest_batch(const vec2 *points, size_t count, int k, QueryResults &results) const;
+    void raycast_batch(const Ray *rays, size_t count, RayHit *hits) const;
+
+    // pool may be null: batched queries then run on the calling thread.
+    explicit spatialQuery(const world &simulation_world, ThreadPool *pool = nullptr);
+};
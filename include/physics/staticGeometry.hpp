@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "math/vec2.hpp"
+
+struct GridInfo;
+
+enum class StaticShapeType : uint8_t
+{
+    Segment, // Two-sided line segment (2 vertices)
+    Polygon  // Convex polygon, counter-clockwise (3+ vertices)
+};
+
+// Contact between a circle and a static shape.
+struct StaticContact
+{
+    int shape = -1;
+    vec2 normal;                    // Unit vector from the shape towards the circle center
+    float penetration_depth = 0.0f; // Overlap along the normal
+};
+
+// ====================================================================
+// --- STATIC GEOMETRY (level colliders) ---
+// Segments and convex polygons that never move. Shapes are stored SoA and
+// binned once into their own uniform grid (CSR, same layout as the body
+// grid); per frame the collision system only queries it with the circle of
+// each dynamic body, so level geometry adds no pairs and no re-binning.
+// ====================================================================
+class StaticGeometry
+{
+public:
+    // Shape columns. The vertices of shape s are
+    // vertex_x/vertex_y[shape_first[s] .. shape_first[s] + shape_vertex_count[s]).
+    std::vector<StaticShapeType> shape_type;
+    std::vector<int> shape_first;
+    std::vector<int> shape_vertex_count;
+    std::vector<float> shape_restitution;
+    std::vector<uint32_t> shape_category;
+    std::vector<uint32_t> shape_mask;
+
+    // Vertex columns. For polygons, edge_normal_x/y[v] is the outward normal of
+    // the edge from vertex v to the next one (unused for segments).
+    std::vector<float> vertex_x;
+    std::vector<float> vertex_y;
+    std::vector<float> edge_normal_x;
+    std::vector<float> edge_normal_y;
+
+    // Returns the new shape's index.
+    int add_segment(const vec2 &a, const vec2 &b, float restitution = 0.5f, uint32_t category = 1u, uint32_t mask = ~0u);
+
+    // Convex polygon in either winding (stored counter-clockwise). Returns -1
+    // for fewer than 3 vertices or zero area. Convexity is not checked.
+    int add_polygon(const vec2 *vertices, int count, float restitution = 0.5f, uint32_t category = 1u, uint32_t mask = ~0u);
+
+    void clear();
+
+    size_t size() const { return shape_type.size(); }
+
+    // Bin every shape into a grid with `grid`'s bounds and cell size. Shapes
+    // reaching outside the bounds are clamped to the border cells.
+    // collisionSystem bakes lazily whenever shapes were added since the last bake.
+    void bake(const GridInfo &grid);
+    bool needs_bake() const { return dirty; }
+
+    // Exact test of a circle against one shape.
+    bool collide_circle(int shape, float cx, float cy, float radius, StaticContact &contact) const;
+
+    // Visits the contact of the circle with every overlapping shape whose layers
+    // interact with (category, mask). A shape spanning several cells is visited
+    // once. Requires a bake.
+    template <typename Visit>
+    void for_each_circle_contact(float cx, float cy, float radius, uint32_t category, uint32_t mask, Visit &&visit) const;
+
+private:
+    bool dirty = false;
+
+    // Baked grid
+    float grid_min_x = 0.0f;
+    float grid_min_y = 0.0f;
+    float cell_size = 1.0f;
+    int num_cells_x = 0;
+    int num_cells_y = 0;
+    std::vector<int> cell_start; // num_cells + 1 entries
+    std::vector<int> cell_shapes;
+    // First covered cell of each shape: a shape found in several cells of a query
+    // is only tested in the first cell shared by both ranges.
+    std::vector<int> shape_cell_min_x;
+    std::vector<int> shape_cell_min_y;
+
+    int cell_x(float x) const { return std::min(std::max(int((x - grid_min_x) / cell_size), 0), num_cells_x - 1); }
+    int cell_y(float y) const { return std::min(std::max(int((y - grid_min_y) / cell_size), 0), num_cells_y - 1); }
+
+    int add_shape(StaticShapeType type, int vertex_count, float restitution, uint32_t category, uint32_t mask);
+};
+
+template <typename Visit>
+void StaticGeometry::for_each_circle_contact(float cx, float cy, float radius, uint32_t category, uint32_t mask, Visit &&visit) const
+{
+    if (num_cells_x == 0 || num_cells_y == 0)
+        return;
+    int x0 = cell_x(cx - radius), x1 = cell_x(cx + radius);
+    int y0 = cell_y(cy - radius), y1 = cell_y(cy + radius);
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            int c = y * num_cells_x + x;
+            for (int s = cell_start[c]; s < cell_start[c + 1]; ++s)
+            {
+                int shape = cell_shapes[s];
+                if (x != std::max(x0, shape_cell_min_x[shape]) || y != std::max(y0, shape_cell_min_y[shape]))
+                    continue;
+                if ((category & shape_mask[shape]) == 0 || (shape_category[shape] & mask) == 0)
+                    continue;
+                StaticContact contact;
+                if (collide_circle(shape, cx, cy, radius, contact))
+                    visit(contact);
+            }
+        }
+    }
+}
@@ -1,7 +1,16 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "math/vec2.hpp"
 #include "physics/body.hpp"
+#include "physics/contactCache.hpp"
+#include "physics/collisionEvents.hpp"
+#include "physics/staticGeometry.hpp"
+#include "physics/constraints.hpp"
+#include "physics/forceFields.hpp"
+#include "physics/neighborList.hpp"
+#include "utils/frameArena.hpp"
 struct GridInfo
 {
     float min_x = -100.0f;
@@ -13,7 +22,65 @@ struct GridInfo
 
     int num_cells_x = 0;
     int num_cells_y = 0;
+
+    // Periodic (wrap-around) axes: bodies leaving one side re-enter on the
+    // other, neighbour cells wrap and displacements use the minimum image.
+    // resize_grid rounds a periodic extent up to whole cells; an axis needs at
+    // least 3 cells to wrap (fewer would visit the same cell pair twice).
+    bool periodic_x = false;
+    bool periodic_y = false;
+
+    float period_x() const { return max_x - min_x; }
+    float period_y() const { return max_y - min_y; }
+    bool wraps_x() const { return periodic_x && num_cells_x >= 3; }
+    bool wraps_y() const { return periodic_y && num_cells_y >= 3; }
+
+    // Shortest displacement under the wrap; identity on non-periodic axes.
+    // Assumes |d| < period, which holds for positions inside the domain.
+    float minimum_image_x(float dx) const
+    {
+        if (!wraps_x())
+            return dx;
+        float half = 0.5f * period_x();
+        return dx > half ? dx - period_x() : (dx < -half ? dx + period_x() : dx);
+    }
+    float minimum_image_y(float dy) const
+    {
+        if (!wraps_y())
+            return dy;
+        float half = 0.5f * period_y();
+        return dy > half ? dy - period_y() : (dy < -half ? dy + period_y() : dy);
+    }
+
+    // Half-shell stencil: each cell is paired with itself and these 4 forward
+    // neighbours, so every adjacent cell pair is visited exactly once.
+    static constexpr int NUM_NEIGHBORS = 4;
+    static constexpr int NEIGHBOR_OFFSETS[NUM_NEIGHBORS][2] = {
+        {1, 0},  // Right
+        {-1, 1}, // Down-Left
+        {0, 1},  // Down
+        {1, 1}   // Down-Right
+    };
+
+    // Forward neighbours of cell c: cell_neighbors[c * NUM_NEIGHBORS + k] is the
+    // cell at NEIGHBOR_OFFSETS[k] (wrapped on periodic axes), or -1 outside the
+    // grid. Built by resize_grid.
+    std::vector<int> cell_neighbors;
+
+    void build_neighbor_table();
 };
+
+// Time integration scheme of a world (see movementSystem / xpbdSystem).
+// All modes but XPBD share the movement/constraint/collision pipeline and
+// only differ in movementSystem's integration kernel.
+enum class IntegratorMode : uint8_t
+{
+    Verlet,            // Position Verlet + one resolution pass per frame
+    XPBD,              // Substepped extended position-based dynamics (xpbdSystem)
+    ExplicitEuler,     // x += v dt, then v += a dt (unstable, for comparison)
+    SemiImplicitEuler  // v += a dt, then x += v dt
+};
+
 struct world
 {
 
@@ -29,6 +96,13 @@ struct world
     // Interpreted as 1/s in the integrator and applied as exp(-d * dt).
     // small default damping to mimic air resistance / energy loss (1/s)
     float global_damping = 0.02f;
+    // Integrator selection. In XPBD mode xpbdSystem runs the whole step
+    // (integration, constraints, contacts, boundaries) in xpbd_substeps
+    // substeps; the other systems leave the world alone.
+    IntegratorMode integrator = IntegratorMode::Verlet;
+    int xpbd_substeps = 8;
+    // Contact compliance (inverse stiffness, m/N) of XPBD contacts; 0 is rigid.
+    float contact_compliance = 0.0f;
     // Per-frame collision phase timing accumulators (microseconds)
     unsigned long long broad_phase_us = 0;
     unsigned long long narrow_phase_us = 0;
@@ -36,26 +110,153 @@ struct world
 
     // The world is SoA-first and exposes SoA accessors for direct usage.
 
+    // Grid (counting-sorted, CSR layout): the bodies of cell c are
+    // sorted_indices[particle_start_indices[c] .. particle_start_indices[c + 1]).
+    // particle_cell_id[i] is the cell of body i, or -1 when it lies outside the grid.
     std::vector<int> particle_cell_id;
     std::vector<int> particle_start_indices;
     std::vector<int> sorted_indices;
-    // Grid: each cell holds a list of particle indices
-    std::vector<std::vector<int>> grid;
+    // Inverse of sorted_indices: slot of body i inside sorted_indices (-1 outside the grid).
+    std::vector<int> particle_sorted_slot;
+
+    // Incremental grid maintenance: instead of re-sorting every body each step,
+    // only bodies whose cell changed are moved between cells. Falls back to a
+    // full rebuild when bodies are added/removed, the grid is resized, or many
+    // bodies changed cell at once.
+    bool incremental_grid = false;
+    // Set by add_body/remove_body/resize_grid; the next grid update re-sorts everything.
+    bool grid_rebuild_required = true;
+    // Bodies re-binned by the last grid update (every body on a full rebuild).
+    size_t grid_moved_bodies = 0;
+
+    // Tiled broad phase: traverse the grid in blocks of cells whose bodies are
+    // gathered into contiguous scratch, testing overlaps while they are hot.
+    // Finds the same contacts as the default pair list, in block order.
+    bool tiled_broad_phase = false;
+
+    // Verlet neighbour list: candidate pairs within radius_a + radius_b +
+    // neighbor_skin are kept across frames and the broad phase only runs again
+    // once some body has moved more than neighbor_skin / 2 (the grid itself is
+    // still maintained every step). Takes precedence over tiled_broad_phase.
+    // The skin is clamped to grid_info.cell_size - 2 * max radius.
+    bool neighbor_lists = false;
+    float neighbor_skin = 0.5f;
+    NeighborList neighbor_list;
+
+    // Contact islands: resolved contacts are grouped by a union-find over the
+    // dynamic bodies they touch (static bodies never join islands), and when
+    // collisionSystem has a thread pool the islands are resolved concurrently,
+    // largest first. Each island keeps the serial contact order, so the result
+    // is the same as the serial loop. XPBD worlds ignore it (and
+    // simd_contact_solver): their substep contact pass is always serial.
+    bool island_solving = false;
+    // Islands found by the last step (0 when island_solving is off).
+    size_t contact_island_count = 0;
+
+    // SIMD contact solver: contacts are coloured once per step into batches of
+    // 4 that share no dynamic body and each batch is solved as SoA rows with
+    // SSE (contacts left without a colour are resolved one by one afterwards).
+    // Contacts are resolved in colour order instead of pair order, so results
+    // differ slightly from the scalar loop. Off by default: on the benchmark
+    // scene it only breaks even with the scalar loop at 20k bodies and is
+    // slower below that. Ignored when island_solving is set.
+    bool simd_contact_solver = false;
+    // Batches solved by the last step (0 when the SIMD solver is off).
+    size_t contact_batch_count = 0;
+
+    // Persistent contacts: when enabled, collisionSystem records every resolved
+    // contact in `contacts` (normal, depth, impulse) so they carry across frames.
+    bool persistent_contacts = false;
+    ContactCache contacts;
+
+    // Begin/end contact events of the last step (implies persistent_contacts).
+    bool report_collision_events = false;
+    CollisionEventStream collision_events;
+
+    // Static level colliders (segments, convex polygons). Baked into their own
+    // grid on first use after shapes are added; bodies collide against them
+    // after the body-body pass.
+    StaticGeometry static_geometry;
+
+    // Distance / spring / pin constraints, relaxed by constraintSystem.
+    ConstraintSet constraints;
+
+    // Gravity wells, wind zones and radial impulses, evaluated into
+    // acc_x/acc_y by forceFieldSystem.
+    ForceFieldSet force_fields;
+
+    // Mutual gravity between bodies (mutualGravitySystem, Barnes-Hut): every
+    // body with mass > 0 pulls every dynamic body with G m / (d^2 + softening^2).
+    // Cells whose size / distance is below barnes_hut_theta are taken as one
+    // body at their center of mass (0 is exact, larger is faster).
+    bool mutual_gravity = false;
+    float gravitational_constant = 1.0f;
+    float barnes_hut_theta = 0.5f;
+    float gravity_softening = 0.1f;
+
+    // SPH fluid (fluidSystem): bodies flagged in `fluid` are fluid particles.
+    // Density, pressure and viscosity are summed over the fluid neighbours
+    // found in the broad-phase grid that collisionSystem built on the previous
+    // step, so the smoothing radius is capped at grid_info.cell_size. Fluid
+    // particles still collide as bodies: their radius is a minimum spacing.
+    bool sph_fluid = false;
+    float fluid_smoothing_radius = 2.5f;
+    float fluid_rest_density = 1.0f;  // Mass per unit area
+    float fluid_stiffness = 20.0f;    // Pressure per unit of density above rest
+    float fluid_viscosity = 0.5f;
+
+    // Chunk streaming (streamingSystem): chunks of the grid domain within
+    // stream_load_radius of an observer are resident; chunks beyond
+    // stream_evict_radius are written to disk and their bodies removed. With
+    // no observers every chunk stays resident.
+    std::vector<vec2> stream_observers;
+    float stream_load_radius = 100.0f;
+    float stream_evict_radius = 130.0f; // Above the load radius, so chunks don't thrash
+
+    // Scratch memory for per-step temporaries (candidate pairs, sort cursors...).
+    // Reset by each system that uses it at the start of its update.
+    FrameArena frame_arena;
     std::vector<float> vel_x;
     std::vector<float> vel_y;
+    // Per-body external acceleration on top of gravity, read by the
+    // integrators. While the world has force fields, mutual gravity or SPH
+    // fluid it is reset to the body's base acceleration at the start of every
+    // step (begin_step) and forceFieldSystem, mutualGravitySystem and
+    // fluidSystem add their terms to it.
     std::vector<float> acc_x;
     std::vector<float> acc_y;
+    // Acceleration each body was given (body::acceleration in add_body); the
+    // field, gravity and fluid terms are added onto it.
+    std::vector<float> base_acc_x;
+    std::vector<float> base_acc_y;
     std::vector<float> mass;
     std::vector<float> inv_mass;
     std::vector<float> radius;
     std::vector<float> damping;
     std::vector<float> friction;
     std::vector<float> restitution;
+    std::vector<uint32_t> collision_category;
+    std::vector<uint32_t> collision_mask;
+    // 1 for SPH fluid particles (see sph_fluid)
+    std::vector<uint8_t> fluid;
+
+    // remove_body calls over the world's lifetime. Removal swaps the last body
+    // into the freed index, so per-index data kept from before it no longer
+    // lines up once this changes.
+    uint64_t bodies_removed = 0;
+
+    // acc_x/acc_y hold terms accumulated by the last step (see begin_step).
+    bool accelerations_accumulated = false;
 
     // Helpers
     size_t size() const { return position_x.size(); }
     void add_body(const body &b);
     void remove_body(size_t idx);
+    // Start of a step, before any system runs (systemManager::update). While
+    // a system accumulates into acc_x/acc_y, and on the step after the last
+    // one stops, the columns go back to base_acc_x/base_acc_y, so no term
+    // carries over to the next step whichever systems are added.
+    void begin_step();
     vec2 get_position(size_t idx) const;
     void set_position(size_t idx, const vec2 &p);
     // Legacy conversion helpers removed: world is pure SoA now.
@@ -71,6 +272,11 @@ struct world
     float get_restitution(size_t idx) const;
     float get_damping(size_t idx) const;
     float get_friction(size_t idx) const;
+    uint32_t get_collision_category(size_t idx) const;
+    uint32_t get_collision_mask(size_t idx) const;
+    // True when the layer filters of both bodies allow them to collide
+    bool layers_collide(size_t idxA, size_t idxB) const;
+    void set_fluid(size_t idx, bool is_fluid);
 
     // SoA constructor: accept pre-filled SoA vectors (move semantics).
     world(const std::vector<float> &position_x_in, const std::vector<float> &position_y_in, const vec2 &gravity_vec, float delta_time_in);
@@ -99,4 +305,8 @@ struct world
         std::vector<float> &&radius_in);
 
     int get_grid_index(const vec2 &position) const;
+    // Recompute num_cells_x/num_cells_y from the grid_info bounds and resize grid storage.
+    // Call after changing grid_info.min_x/max_x/min_y/max_y or the periodic flags.
+    void resize_grid();
+    int num_grid_cells() const { return grid_info.num_cells_x * grid_info.num_cells_y; }
 };
\ No newline at end of file
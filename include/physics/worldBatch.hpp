@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/vec2.hpp"
+
+class world;
+class ThreadPool;
+
+// ====================================================================
+// --- WORLD BATCH (many small independent worlds) ---
+// Thousands of small worlds (tens to hundreds of bodies) packed into one set
+// of SoA columns: the bodies of world w are [body_start[w], body_start[w + 1]).
+// step() advances every world in one parallel pass; each task takes a run of
+// whole worlds and integrates, collides and clamps them while their bodies
+// are in cache. Worlds never interact.
+//
+// The per-world pipeline is the plain Verlet one (gravity, global damping,
+// body-body contacts, walls at the world bounds); force fields, constraints,
+// static geometry and the other world features are not batched. Contacts are
+// found by a sweep along x over a per-world order kept across steps, which
+// at these sizes is cheaper than a grid per world, and resolved after the
+// sweep with collisionSystem's response (sim/contactResponse.hpp).
+// ====================================================================
+class WorldBatch
+{
+public:
+    // Body columns, world after world
+    std::vector<float> position_x;
+    std::vector<float> position_y;
+    std::vector<float> previous_position_x;
+    std::vector<float> previous_position_y;
+    std::vector<float> vel_x;
+    std::vector<float> vel_y;
+    std::vector<float> inv_mass;
+    std::vector<float> radius;
+    std::vector<float> restitution;
+
+    // World columns
+    std::vector<int> body_start; // num_worlds() + 1 entries
+    std::vector<float> gravity_x;
+    std::vector<float> gravity_y;
+    std::vector<float> delta_time;
+    std::vector<float> global_damping;
+    std::vector<float> min_x; // Walls
+    std::vector<float> max_x;
+    std::vector<float> min_y;
+    std::vector<float> max_y;
+    std::vector<uint32_t> contact_count; // Contacts resolved by the last step
+
+    // Copies the prototype's bodies, gravity, delta_time, global damping and
+    // grid bounds into a new world and returns its index. The copied state is
+    // also what reset_world restores.
+    int add_world(const world &prototype);
+
+    // Back to the state the world was added with; the steps that follow
+    // repeat the first run exactly.
+    void reset_world(int world_index);
+
+    // Advance every world by its own delta_time. pool may be null: the worlds
+    // are then stepped on the calling thread.
+    void step(ThreadPool *pool = nullptr);
+
+    size_t num_worlds() const { return body_start.empty() ? 0 : body_start.size() - 1; }
+    size_t num_bodies() const { return position_x.size(); }
+    int world_size(int world_index) const { return body_start[world_index + 1] - body_start[world_index]; }
+    vec2 position(int world_index, int body_index) const
+    {
+        int i = body_start[world_index] + body_index;
+        return vec2(position_x[i], position_y[i]);
+    }
+
+private:
+    // State at add_world, for reset_world
+    std::vector<float> initial_position_x;
+    std::vector<float> initial_position_y;
+    std::vector<float> initial_previous_x;
+    std::vector<float> initial_previous_y;
+    std::vector<float> initial_vel_x;
+    std::vector<float> initial_vel_y;
+
+    // Per-world sweep order (local body indices sorted by min x), kept across
+    // steps so the insertion sort only fixes what moved
+    std::vector<int> sweep_order;
+
+    void step_world(int world_index);
+    void integrate_world(int world_index);
+    void collide_world(int world_index);
+    void clamp_world(int world_index);
+};
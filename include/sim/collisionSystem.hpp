@@ -1,59 +1,113 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include "sim/ISystem.hpp"
 #include "math/vec2.hpp"
+#include "physics/contactCache.hpp"
 
 class body;
 class world;
+class ThreadPool;
 
-// ====================================================================
-// --- COLLISION DATA STRUCTURES ---
-// The ContactManifold structure stores all key collision information
-// so that resolve_collision can be cleaner.
-// ====================================================================
-
-struct ContactManifold
+// Candidate pairs produced by the broad phase (and contact pairs produced by
+// the narrow phase). The storage lives in the world's frame arena and is only
+// valid for the current step.
+struct CandidatePairs
 {
-    body *body_A;                // Pointer to the first body involved
-    body *body_B;                // Pointer to the second body involved
-    vec2 normal_direction;       // Unit vector of the collision (direction from A to B)
-    float penetration_depth;     // Magnitude of the overlap between bodies
-    float effective_restitution; // Average coefficient of restitution
-    float inverse_mass_sum;      // Sum of inverse masses (1/mA + 1/mB)
+    std::pair<int, int> *pairs = nullptr;
+    size_t count = 0;
 };
 
 class collisionSystem : public ISystem
 {
 private:
+    ThreadPool *pool;
+
     // --- SPATIAL GRID PHASES (Spatial Hashing) ---
     void clear_spatial_grid(world &simulation_world);
     void populate_spatial_grid(world &simulation_world);
+    // Incremental mode: re-bins only bodies whose cell changed since the last update.
+    // Returns false (grid untouched) when a full rebuild is needed instead.
+    bool update_spatial_grid_incremental(world &simulation_world);
 
     // --- COLLISION DETECTION PHASES ---
     // Broad Phase: Generates a list of pairs of nearby bodies (candidates).
-    // Returns pairs of particle indices (SoA-friendly)
-    std::vector<std::pair<int, int>> broad_phase_generate_pairs(world &simulation_world);
+    // Returns pairs of particle indices (SoA-friendly), allocated from the frame arena.
+    CandidatePairs broad_phase_generate_pairs(world &simulation_world);
+
+    // Tiled variant (world::tiled_broad_phase): walks the grid in square blocks of
+    // cells, copies each block and its halo into contiguous scratch and runs the
+    // overlap test there, so it returns contacts directly (no narrow phase pass).
+    CandidatePairs broad_phase_tiled_contacts(world &simulation_world);
+
+    // Neighbour-list variant (world::neighbor_lists): rebuilds world.neighbor_list
+    // from the pair list only when a body moved more than half the skin, and
+    // otherwise emits the stored pairs (frame arena).
+    CandidatePairs broad_phase_neighbor_list(world &simulation_world);
 
     // Narrow Phase: Iterates over candidate pairs to check and resolve exact collisions.
     void narrow_phase_check_and_resolve(world &simulation_world);
 
+    // Batched overlap test: gathers candidate pairs into SoA tiles, runs the distance
+    // test branch-free across the tile and compacts the hits into a contact list
+    // (frame arena). Only true contacts reach resolution.
+    CandidatePairs narrow_phase_collect_contacts(world &simulation_world, const CandidatePairs &candidates);
+
+    // Island solving (world::island_solving): union-find over the contacts,
+    // then every island is resolved as one task on the pool. Fills manifolds[p]
+    // and resolved[p] for contact p; recording happens afterwards, in order.
+    void solve_contact_islands(world &simulation_world, const CandidatePairs &contacts, ContactManifold *manifolds, uint8_t *resolved);
+
+    // SIMD contact solver (world::simd_contact_solver): colours the contacts
+    // once per step into batches with no shared dynamic body, precomputes
+    // normal, correction and masses per SoA row, solves the lanes of each batch
+    // together and scatters the results; contacts without a free colour are
+    // resolved scalar at the end. Same outputs as solve_contact_islands.
+    void solve_contact_batches(world &simulation_world, const CandidatePairs &contacts, ContactManifold *manifolds, uint8_t *resolved);
+
     // Circle-Circle Check: Uses squared distances for efficiency.
     // Index-based variant for SoA arrays
     bool check_for_overlap(int idxA, int idxB, world &simulation_world);
 
     // Resolution: Applies positional correction and velocity impulse.
-    // Index-based variant for SoA arrays
-    void resolve_contact_with_impulse(int idxA, int idxB, world &simulation_world);
+    // Index-based variant for SoA arrays. Fills `manifold` and returns true when
+    // the pair was in contact. Static bodies are never written.
+    bool resolve_contact_with_impulse(int idxA, int idxB, world &simulation_world, ContactManifold &manifold);
+
+    // Dynamic bodies against world.static_geometry: pushed out along the contact
+    // normal, approaching normal velocity reflected with the averaged restitution.
+    void solve_static_contacts(world &simulation_world);
 
-    // World Boundary Collisions (floor, walls).
+    // World Boundary Collisions (floor, walls). Periodic axes wrap instead.
     void solve_boundary_contacts(world &simulation_world);
 
 public:
-    // Main update loop of the collision simulation.
+    // Main update loop of the collision simulation. Does nothing for
+    // IntegratorMode::XPBD worlds (xpbdSystem solves their contacts and feeds
+    // the contact cache and events through the recording calls below).
     void update(world &simulation_world, float delta_time) override;
 
-    collisionSystem();
+    // One step of world.contacts / world.collision_events, when
+    // persistent_contacts or report_collision_events is set (no-ops otherwise):
+    // begin, record every contact resolved in the step, then end, which emits
+    // the End events and evicts stale entries.
+    void begin_contact_recording(world &simulation_world);
+    void record_contact(world &simulation_world, const ContactManifold &manifold);
+    void end_contact_recording(world &simulation_world);
+
+    // Rebuild the spatial grid and return the broad-phase candidate pairs
+    // (frame arena) without resolving anything. Used by xpbdSystem, which
+    // solves the contacts itself in every substep.
+    CandidatePairs collect_candidate_pairs(world &simulation_world);
+
+    // Wrap positions on periodic axes back into the domain (previous positions
+    // move by the same amount, so Verlet velocities are kept).
+    void wrap_periodic_positions(world &simulation_world);
+
+    // pool may be null: islands then run on the calling thread.
+    explicit collisionSystem(ThreadPool *pool = nullptr);
     ~collisionSystem();
 };
\ No newline at end of file
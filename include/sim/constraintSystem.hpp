@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include "sim/ISystem.hpp"
+
+class world;
+class ThreadPool;
+
+// Relaxes world.constraints with position-based Verlet projection: after the
+// integrator has moved the bodies, every row pulls its two bodies towards the
+// rest length, colour batch by colour batch, for ConstraintSet::iterations
+// passes. Velocities follow from the corrected positions, as in Verlet.
+class constraintSystem : public ISystem
+{
+private:
+    ThreadPool *pool;
+
+    // Relax rows colored_rows[begin, end) of one colour batch.
+    void solve_batch(world &simulation_world, const float *inv_mass, size_t begin, size_t end);
+
+public:
+    void update(world &simulation_world, float delta_time) override;
+
+    // pool may be null: batches then run on the calling thread.
+    explicit constraintSystem(ThreadPool *pool = nullptr);
+    ~constraintSystem();
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// ====================================================================
+// --- CIRCLE CONTACT RESPONSE (shared by collisionSystem and WorldBatch) ---
+// Positional correction along the normal, restitution impulse when the
+// bodies approach, Verlet previous positions matched to the new velocities,
+// resolved bodies kept inside the walls and tiny velocities snapped to zero.
+// Static bodies (inv_mass 0) are never written, so contacts that only share
+// static bodies can be resolved concurrently.
+// ====================================================================
+
+const float POSITION_CORRECTION_SLOP = 0.001f;  // Minimum penetration before correcting
+const float POSITION_CORRECTION_PERCENT = 0.2f; // Percentage of penetration to correct (smaller to avoid energy loss)
+const float VELOCITY_EPSILON = 1e-6f;           // Threshold to snap velocity to zero (smaller to avoid early sleeping)
+const float BOUNDARY_EPS = 1e-4f;               // Resolved bodies are kept this far inside the walls
+
+// Body columns a contact reads and writes (a world's SoA arrays or one
+// world of a WorldBatch).
+struct ContactBodyColumns
+{
+    float *position_x;
+    float *position_y;
+    float *previous_position_x;
+    float *previous_position_y;
+    float *vel_x;
+    float *vel_y;
+    const float *inv_mass;
+    const float *radius;
+};
+
+// Walls resolved bodies are clamped to; an axis without clamp is periodic.
+struct ContactWalls
+{
+    float min_x, max_x, min_y, max_y;
+    bool clamp_x = true;
+    bool clamp_y = true;
+};
+
+// What one contact did, for the contact cache.
+struct ContactResult
+{
+    bool in_contact = false;
+    float normal_x = 0.0f;
+    float normal_y = 0.0f;
+    float penetration_depth = 0.0f;
+    float inverse_mass_sum = 0.0f;
+    float normal_impulse = 0.0f; // 0 when the bodies were separating
+};
+
+// Resolve bodies a and b, with (dx, dy) the displacement from a to b and
+// restitution the pair's effective restitution. Does nothing (in_contact
+// false) unless they overlap and at least one is dynamic.
+inline ContactResult resolve_circle_contact(const ContactBodyColumns &bodies, int a, int b, float dx, float dy, float restitution, float dt, const ContactWalls &walls)
+{
+    ContactResult result;
+    float distance_squared = dx * dx + dy * dy;
+    if (distance_squared <= 1e-6f)
+        return result;
+
+    float distance = std::sqrt(distance_squared);
+    float penetration_depth = bodies.radius[a] + bodies.radius[b] - distance;
+    if (penetration_depth <= 0.0f)
+        return result;
+
+    const float inverse_mass_a = bodies.inv_mass[a];
+    const float inverse_mass_b = bodies.inv_mass[b];
+    const float inverse_mass_sum = inverse_mass_a + inverse_mass_b;
+    if (inverse_mass_sum <= 0.0f)
+        return result;
+
+    const float inverse_distance = 1.0f / distance;
+    const float nx = dx * inverse_distance;
+    const float ny = dy * inverse_distance;
+    result.in_contact = true;
+    result.normal_x = nx;
+    result.normal_y = ny;
+    result.penetration_depth = penetration_depth;
+    result.inverse_mass_sum = inverse_mass_sum;
+
+    // 1. Positional correction
+    float correction_magnitude = std::max(penetration_depth - POSITION_CORRECTION_SLOP, 0.0f) / inverse_mass_sum * POSITION_CORRECTION_PERCENT;
+    float correction_x = nx * correction_magnitude;
+    float correction_y = ny * correction_magnitude;
+    const bool dynamic_a = inverse_mass_a > 0.0f;
+    const bool dynamic_b = inverse_mass_b > 0.0f;
+    if (dynamic_a)
+    {
+        bodies.position_x[a] -= correction_x * inverse_mass_a;
+        bodies.position_y[a] -= correction_y * inverse_mass_a;
+    }
+    if (dynamic_b)
+    {
+        bodies.position_x[b] += correction_x * inverse_mass_b;
+        bodies.position_y[b] += correction_y * inverse_mass_b;
+    }
+
+    // 2. Restitution impulse, only when approaching
+    float velocity_along_normal = (bodies.vel_x[b] - bodies.vel_x[a]) * nx + (bodies.vel_y[b] - bodies.vel_y[a]) * ny;
+    if (velocity_along_normal > 0.0f)
+        return result;
+
+    float impulse = -(1.0f + restitution) * velocity_along_normal;
+    impulse /= inverse_mass_sum;
+    result.normal_impulse = impulse;
+    float impulse_x = nx * impulse;
+    float impulse_y = ny * impulse;
+
+    // 3. Velocities, previous positions, walls and low-velocity snapping
+    auto settle = [&](int k, float sign, float inverse_mass)
+    {
+        float vx = bodies.vel_x[k] + sign * impulse_x * inverse_mass;
+        float vy = bodies.vel_y[k] + sign * impulse_y * inverse_mass;
+        bodies.vel_x[k] = vx;
+        bodies.vel_y[k] = vy;
+        if (dt > 0.0f)
+        {
+            bodies.previous_position_x[k] = bodies.position_x[k] - vx * dt;
+            bodies.previous_position_y[k] = bodies.position_y[k] - vy * dt;
+        }
+        const float r = bodies.radius[k];
+        if (walls.clamp_x)
+            bodies.position_x[k] = std::min(std::max(bodies.position_x[k], walls.min_x + r + BOUNDARY_EPS), walls.max_x - r - BOUNDARY_EPS);
+        if (walls.clamp_y)
+            bodies.position_y[k] = std::min(std::max(bodies.position_y[k], walls.min_y + r + BOUNDARY_EPS), walls.max_y - r - BOUNDARY_EPS);
+        if (std::fabs(bodies.vel_x[k]) < VELOCITY_EPSILON)
+            bodies.vel_x[k] = 0.0f;
+        if (std::fabs(bodies.vel_y[k]) < VELOCITY_EPSILON)
+            bodies.vel_y[k] = 0.0f;
+    };
+    if (dynamic_a)
+        settle(a, -1.0f, inverse_mass_a);
+    if (dynamic_b)
+        settle(b, 1.0f, inverse_mass_b);
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "sim/ISystem.hpp"
+
+class world;
+class ThreadPool;
+
+// SPH fluid (world::sph_fluid): density, pressure and viscosity accelerations
+// of the bodies flagged in world::fluid, added to acc_x/acc_y. Neighbours
+// come from the broad-phase grid collisionSystem built on the previous step
+// (3x3 cells around each particle's cell), so there is no second neighbour
+// search; the step after bodies are added or removed, while the grid is
+// stale, has no fluid forces. The columns are reset by world::begin_step at
+// the start of every step while sph_fluid is on. Add it after
+// forceFieldSystem (which rewrites the columns) and before the integrator.
+class fluidSystem : public ISystem
+{
+public:
+    // Neighbours of one particle gathered as SoA rows (per-thread scratch)
+    struct NeighborRows
+    {
+        std::vector<float> dx; // Neighbour position minus particle position
+        std::vector<float> dy;
+        std::vector<float> mass;
+        std::vector<float> density;
+        std::vector<float> pressure;
+        std::vector<float> dvx; // Neighbour velocity minus particle velocity
+        std::vector<float> dvy;
+    };
+
+private:
+    ThreadPool *pool;
+    // Fluid particles in grid order, and per-body density / pressure of the last step
+    std::vector<int> particles;
+    std::vector<float> density;
+    std::vector<float> pressure;
+    std::vector<NeighborRows> rows;
+
+    // Appends every fluid particle within the smoothing radius of body i
+    // (itself included) to `out`. with_state also gathers density, pressure and
+    // relative velocity for the force pass.
+    void gather_neighbors(const world &simulation_world, int i, float smoothing_radius, bool with_state, NeighborRows &out) const;
+
+public:
+    void update(world &simulation_world, float delta_time) override;
+
+    // Density of body i on the last step (0 for bodies that are not fluid).
+    float density_of(size_t i) const { return i < density.size() ? density[i] : 0.0f; }
+    size_t num_particles() const { return particles.size(); }
+
+    // pool may be null: both passes then run on the calling thread.
+    explicit fluidSystem(ThreadPool *pool = nullptr);
+    ~fluidSystem();
+};
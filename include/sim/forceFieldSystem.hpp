@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sim/ISystem.hpp"
+
+class world;
+
+// Evaluates world.force_fields for every dynamic body and writes the body's
+// base acceleration (base_acc_x/y) plus the result into acc_x/acc_y, ahead of
+// the integrator (add it before movementSystem / xpbdSystem). While a world
+// has fields, mutual gravity or SPH fluid, the acceleration columns belong to
+// this system: they are rewritten every step (the base acceleration where no
+// field acts) and mutualGravitySystem / fluidSystem add to them afterwards. Radial impulses are dropped after the step that applies them.
+class forceFieldSystem : public ISystem
+{
+private:
+    // The columns still hold field accelerations from the previous step and
+    // must go back to the base acceleration once the last field is gone.
+    bool wrote_last_step = false;
+
+public:
+    void update(world &simulation_world, float delta_time) override;
+
+    forceFieldSystem();
+    ~forceFieldSystem();
+};
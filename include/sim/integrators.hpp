@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include "physics/world.hpp"
+
+// ====================================================================
+// --- INTEGRATION KERNELS (policy x feature flags) ---
+// One templated loop over the SoA body columns. The integrator policy decides
+// how a body advances along one axis; the feature flags compile the optional
+// terms in or out, so every combination is a loop without per-body feature
+// branches. movementSystem picks the instantiation once per frame.
+// See docs/integradores.md for when to use each scheme.
+// ====================================================================
+
+// Per-frame time terms, computed once.
+struct IntegrationStep
+{
+    float dt;
+    float dt_squared;
+    float half_inverse_dt;
+};
+
+// A policy advances one axis of one body given its acceleration, then
+// applies an exponential velocity decay factor.
+struct VerletPolicy
+{
+    // x' = 2x - x_prev + a dt^2, velocity by centered difference
+    static void advance(float &x, float &previous, float &v, float a, const IntegrationStep &step)
+    {
+        float before = previous;
+        float next = (x * 2.0f) - previous + a * step.dt_squared;
+        previous = x;
+        x = next;
+        v = (next - before) * step.half_inverse_dt;
+    }
+    // Velocity lives in (x - previous): move previous to match the damped velocity
+    static void decay(float x, float &previous, float &v, float factor, const IntegrationStep &step)
+    {
+        v *= factor;
+        previous = x - v * step.dt;
+    }
+};
+
+struct SemiImplicitEulerPolicy
+{
+    // v' = v + a dt, x' = x + v' dt
+    static void advance(float &x, float &previous, float &v, float a, const IntegrationStep &step)
+    {
+        previous = x;
+        v += a * step.dt;
+        x += v * step.dt;
+    }
+    static void decay(float, float &, float &v, float factor, const IntegrationStep &) { v *= factor; }
+};
+
+struct ExplicitEulerPolicy
+{
+    // x' = x + v dt, v' = v + a dt
+    static void advance(float &x, float &previous, float &v, float a, const IntegrationStep &step)
+    {
+        previous = x;
+        x += v * step.dt;
+        v += a * step.dt;
+    }
+    static void decay(float, float &, float &v, float factor, const IntegrationStep &) { v *= factor; }
+};
+
+// Damping:     per-body damping as drag plus exponential decay by
+//              (global_damping + damping[i]).
+// Friction:    per-body friction as drag along the velocity.
+// GravityOnly: skip the per-body acc_x/acc_y columns.
+template <class Integrator, bool Damping, bool Friction, bool GravityOnly>
+void integrate_bodies(world &simulation_world, const IntegrationStep &step)
+{
+    size_t n = simulation_world.position_x.size();
+    float *px = simulation_world.position_x.data();
+    float *py = simulation_world.position_y.data();
+    float *prev_x = simulation_world.previous_position_x.data();
+    float *prev_y = simulation_world.previous_position_y.data();
+    float *vx = simulation_world.vel_x.data();
+    float *vy = simulation_world.vel_y.data();
+    const float *acc_x = simulation_world.acc_x.data();
+    const float *acc_y = simulation_world.acc_y.data();
+    const float *inv_mass = simulation_world.inv_mass.data();
+    const float *damping = simulation_world.damping.data();
+    const float *friction = simulation_world.friction.data();
+    const float gravity_x = simulation_world.gravity_x;
+    const float gravity_y = simulation_world.gravity_y;
+    const float global_damping = simulation_world.global_damping;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (inv_mass[i] <= 0.0f)
+            continue; // static
+
+        float ax = gravity_x;
+        float ay = gravity_y;
+        if (!GravityOnly)
+        {
+            ax += acc_x[i];
+            ay += acc_y[i];
+        }
+        if (Damping)
+        {
+            ax -= vx[i] * damping[i];
+            ay -= vy[i] * damping[i];
+        }
+        if (Friction)
+        {
+            float speed = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+            float inverse_speed = speed > 1e-6f ? 1.0f / speed : 0.0f;
+            float drag = friction[i] * speed;
+            ax -= (vx[i] * inverse_speed) * drag;
+            ay -= (vy[i] * inverse_speed) * drag;
+        }
+
+        Integrator::advance(px[i], prev_x[i], vx[i], ax, step);
+        Integrator::advance(py[i], prev_y[i], vy[i], ay, step);
+
+        if (Damping)
+        {
+            float combined_damping = global_damping + damping[i];
+            if (combined_damping > 0.0f)
+            {
+                float factor = std::exp(-combined_damping * step.dt);
+                Integrator::decay(px[i], prev_x[i], vx[i], factor, step);
+                Integrator::decay(py[i], prev_y[i], vy[i], factor, step);
+            }
+        }
+    }
+}
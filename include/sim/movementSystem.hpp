@@ -4,8 +4,9 @@ class world;
 class movementSystem : public ISystem
 {
 private:
-    /* data */
-    void verlet_integration(world &world);
+    // Picks the integration kernel for the world's integrator and the features
+    // in use this frame (see sim/integrators.hpp), then runs it.
+    void integrate(world &world);
 
 public:
     void update(world &, float dt) override;
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include "sim/ISystem.hpp"
+#include "physics/barnesHutTree.hpp"
+
+class world;
+class ThreadPool;
+
+// Pairwise attraction between bodies (world::mutual_gravity) with a
+// Barnes-Hut quadtree rebuilt every step. Adds G * sum(m_j d / (d^2 + eps^2)^1.5)
+// to acc_x/acc_y of every dynamic body, which world::begin_step resets at the
+// start of every step while mutual gravity is on. Add it after
+// forceFieldSystem (which rewrites the columns) and before the integrator. Boundaries are ignored: periodic worlds are not wrapped.
+class mutualGravitySystem : public ISystem
+{
+private:
+    ThreadPool *pool;
+    BarnesHutTree tree;
+    // Per-worker interaction lists and per-slot accelerations, kept across steps
+    std::vector<BarnesHutTree::InteractionList> lists;
+    std::vector<float> slot_acc_x;
+    std::vector<float> slot_acc_y;
+
+public:
+    void update(world &simulation_world, float delta_time) override;
+
+    const BarnesHutTree &last_tree() const { return tree; }
+
+    // pool may be null: the tree and the force pass then run on the calling thread.
+    explicit mutualGravitySystem(ThreadPool *pool = nullptr);
+    ~mutualGravitySystem();
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "math/vec2.hpp"
+#include "physics/world.hpp"
+#include "utils/tripleBuffer.hpp"
+
+class systemManager;
+
+// What the renderer needs from one physics step: every body's position
+// before and after the step (so frames can be interpolated between them),
+// the per-body values the UI shows, and a few world settings.
+struct RenderSnapshot
+{
+    uint64_t step = 0;                                // Steps taken when the snapshot was made
+    std::chrono::steady_clock::time_point stepped_at; // When that step finished
+    bool stepped = false;                             // False while paused: previous == position
+
+    std::vector<float> previous_x;
+    std::vector<float> previous_y;
+    std::vector<float> position_x;
+    std::vector<float> position_y;
+    std::vector<float> radius;
+    std::vector<float> mass;
+    std::vector<float> inv_mass;
+    std::vector<float> restitution;
+    std::vector<float> damping;
+    std::vector<float> friction;
+
+    float gravity_y = 0.0f;
+    float global_damping = 0.0f;
+    IntegratorMode integrator = IntegratorMode::Verlet;
+    int xpbd_substeps = 0;
+    bool mutual_gravity = false;
+    bool sph_fluid = false;
+
+    size_t size() const { return position_x.size(); }
+
+    // Position of body i, alpha of the way from the previous step to this one.
+    vec2 interpolated_position(size_t i, float alpha) const
+    {
+        return vec2(previous_x[i] + (position_x[i] - previous_x[i]) * alpha, previous_y[i] + (position_y[i] - previous_y[i]) * alpha);
+    }
+
+    // Fraction of a step elapsed since this one finished, in [0, 1].
+    float alpha_at(std::chrono::steady_clock::time_point now, float fixed_dt) const;
+};
+
+// Steps a systemManager at a fixed rate on its own thread and publishes a
+// RenderSnapshot after every step through a lock-free triple buffer, so a slow
+// step never blocks the render loop (it only delays the next snapshot).
+// While the runner is started the world belongs to the physics thread: other
+// threads change it by posting edits, which run between steps in posting order,
+// or, on hot paths, by pushing WorldCommands to the manager's lock-free queue.
+class physicsRunner
+{
+public:
+    physicsRunner(world &simulation_world, systemManager &manager, float fixed_dt);
+    ~physicsRunner();
+
+    physicsRunner(const physicsRunner &) = delete;
+    physicsRunner &operator=(const physicsRunner &) = delete;
+
+    void start();
+    void stop(); // Joins the thread; pending edits are applied first
+
+    // Run edit(world) on the physics thread before its next step (takes a lock;
+    // prefer manager.commands() for frequent impulses, teleports and spawns).
+    void post(std::function<void(world &)> edit);
+
+    void set_paused(bool paused);
+    bool is_paused() const { return paused.load(std::memory_order_relaxed); }
+    // While paused: take exactly one step.
+    void request_step() { step_once.store(true, std::memory_order_relaxed); }
+
+    // Render thread only: the newest snapshot (kept until a newer one arrives).
+    const RenderSnapshot &latest_snapshot();
+
+    float fixed_dt() const { return step_dt; }
+    uint64_t steps_taken() const { return steps.load(std::memory_order_relaxed); }
+
+private:
+    world &simulation_world;
+    systemManager &manager;
+    const float step_dt;
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> paused{false};
+    std::atomic<bool> step_once{false};
+    std::atomic<uint64_t> steps{0};
+
+    // Edits posted by other threads; swapped out whole by the physics thread
+    std::mutex edits_mutex;
+    std::vector<std::function<void(world &)>> pending_edits;
+    std::vector<std::function<void(world &)>> applying_edits;
+
+    TripleBuffer<RenderSnapshot> snapshots;
+    std::vector<float> before_x; // Positions before the step (physics thread)
+    std::vector<float> before_y;
+    uint64_t removals_before = 0; // world::bodies_removed before the step
+
+    void run();
+    void apply_edits();
+    void publish(bool stepped);
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim/ISystem.hpp"
+
+class world;
+
+// Chunk streaming: the grid domain is split into square chunks of chunk_size.
+// Each step, bodies in chunks farther than world::stream_evict_radius from
+// every observer are packed into a compact binary record, handed to a
+// background I/O thread that appends it to the chunk's file, and removed from
+// the world. When an observer comes within world::stream_load_radius of a
+// chunk on disk, the I/O thread reads the file back, and the next step appends
+// its bodies to the world. The step thread never touches the disk, so memory
+// and step cost follow the active area only.
+//
+// Add it first in the pipeline. Bodies are removed with world::remove_body,
+// so body indices change whenever a chunk is evicted; constraints on evicted
+// bodies are dropped. Chunk files live in `directory` and are scratch: the
+// ones still held are deleted when the system is destroyed.
+//
+// I/O failures are reported on std::cerr (the first one) and counted in
+// io_failures(). Without `directory` nothing is evicted. A write that fails
+// hands its bodies back to the world on the next step, and the partial record
+// is cut off so the chunk's earlier records stay readable. The chunk goes back
+// to the state it had before that eviction and is not evicted again for a
+// while (longer after each failure), so a failing disk is not retried every
+// step.
+class streamingSystem : public ISystem
+{
+public:
+    enum class ChunkState : uint8_t
+    {
+        Resident, // Its bodies (if any) are in the world
+        OnDisk,   // Evicted: its file holds the bodies
+        Loading   // Being read back by the I/O thread
+    };
+
+    // Bodies of one chunk as stored on disk, column after column
+    struct ChunkBodies
+    {
+        static constexpr int FLOAT_COLUMNS = 14; // x, y, previous x/y, vx, vy, base ax/ay, mass, inv_mass, radius, damping, friction, restitution
+        uint32_t count = 0;
+        std::vector<float> floats;     // FLOAT_COLUMNS * count
+        std::vector<uint32_t> layers;  // category, mask (2 * count)
+        std::vector<uint8_t> fluid;    // count
+    };
+
+    void update(world &simulation_world, float delta_time) override;
+
+    // Block until every queued write and read is done (loads are applied to
+    // the world on the next update).
+    void flush();
+
+    ChunkState state_of(int chunk_x, int chunk_y) const;
+    int num_chunks_x() const { return chunks_x; }
+    int num_chunks_y() const { return chunks_y; }
+    size_t resident_chunks() const;
+    size_t bodies_on_disk() const { return stored_bodies; }
+    uint64_t bytes_written() const { return written_bytes.load(std::memory_order_relaxed); }
+    uint64_t io_failures() const { return failures.load(std::memory_order_relaxed); }
+
+    explicit streamingSystem(const std::string &directory, float chunk_size = 50.0f);
+    ~streamingSystem();
+
+    streamingSystem(const streamingSystem &) = delete;
+    streamingSystem &operator=(const streamingSystem &) = delete;
+
+private:
+    struct IoJob
+    {
+        bool write = true;
+        bool truncate = false; // First write since the chunk was last loaded
+        int chunk = 0;
+        ChunkBodies bodies;
+        // Writes: the chunk before this eviction, restored if the write fails
+        ChunkState previous_state = ChunkState::Resident;
+        uint8_t previous_on_disk = 0;
+        uint32_t serial = 0; // write_serial of the chunk at this eviction
+    };
+
+    const std::string directory;
+    const float chunk_size;
+    float origin_x = 0.0f, origin_y = 0.0f;
+    int chunks_x = 0, chunks_y = 0;
+    std::vector<ChunkState> states;
+    std::vector<uint8_t> on_disk; // Chunk has a file (written, not yet loaded back)
+    std::vector<uint32_t> write_serial;    // Evictions of each chunk so far
+    std::vector<uint8_t> failed_writes;    // Failed writes of each chunk (sets its back-off)
+    std::vector<uint64_t> evict_after;     // Step before which a chunk that failed to write stays resident
+    uint64_t steps = 0;
+    size_t stored_bodies = 0;
+    std::atomic<uint64_t> written_bytes{0};
+    std::atomic<uint64_t> failures{0};
+    bool directory_ok = false;
+
+    // Step-thread scratch
+    std::vector<uint8_t> keep;
+    std::vector<int> chunk_of_body;
+    std::vector<int> evicted;
+
+    // I/O thread
+    std::thread io_thread;
+    std::mutex io_mutex;
+    std::condition_variable io_wake;
+    std::condition_variable io_idle;
+    std::deque<IoJob> jobs;
+    std::vector<IoJob> loaded; // Read back (or a failed write handed back), not yet applied
+    std::vector<uint8_t> write_left_no_file; // I/O thread only: a failed write removed the chunk's file
+    bool io_busy = false;
+    bool stopping = false;
+
+    void io_loop();
+    void report_failure(const std::string &what);
+    void enqueue(IoJob job);
+    std::string chunk_path(int chunk) const;
+    int chunk_at(float x, float y) const;
+    void apply_loaded(world &simulation_world);
+    void evict(world &simulation_world);
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "sim/ISystem.hpp"
+#include "sim/worldCommands.hpp"
 #include <vector>
 #include <memory>
 
@@ -12,12 +13,20 @@ class systemManager
 {
 private:
     std::vector<std::unique_ptr<ISystem>> systems;
+    WorldCommandQueue command_queue;
 
 public:
     void addSystem(std::unique_ptr<ISystem> sys);
 
+    // Applies the queued commands, starts the world's step (world::begin_step),
+    // then runs every system in order.
     void update(world &world, float dt);
 
+    // Mutations from other threads; update() applies them before the systems run.
+    WorldCommandQueue &commands() { return command_queue; }
+    // Apply queued commands without stepping (e.g. while paused).
+    size_t apply_commands(world &world) { return command_queue.apply(world); }
+
     systemManager();
     ~systemManager() = default;
 };
\ No newline at end of file
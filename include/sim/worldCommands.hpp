@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/vec2.hpp"
+#include "utils/mpscQueue.hpp"
+
+class world;
+
+enum class WorldCommandType : uint8_t
+{
+    ApplyImpulse, // velocity += (x, y) * inv_mass
+    SetVelocity,  // velocity = (x, y)
+    Teleport,     // world::set_position(body, (x, y)), which also stops the body
+    Remove,       // world::remove_body(body)
+    Spawn,        // add a body at (x, y) moving at (vx, vy)
+};
+
+// One mutation posted from outside the step. Plain data so it can be copied
+// through the lock-free queue.
+struct WorldCommand
+{
+    WorldCommandType type = WorldCommandType::ApplyImpulse;
+    uint32_t body = 0; // Target body (ignored by Spawn)
+    float x = 0.0f, y = 0.0f;
+    // Spawn only
+    float vx = 0.0f, vy = 0.0f;
+    float mass = 1.0f, radius = 1.0f, restitution = 1.0f, damping = 0.0f, friction = 0.0f;
+    uint32_t order = 0; // Arrival order within a drain (set by the queue)
+
+    static WorldCommand impulse(uint32_t body, const vec2 &impulse);
+    static WorldCommand set_velocity(uint32_t body, const vec2 &velocity);
+    static WorldCommand teleport(uint32_t body, const vec2 &position);
+    static WorldCommand remove(uint32_t body);
+    static WorldCommand spawn(const vec2 &position, const vec2 &velocity, float mass, float radius, float restitution = 1.0f,
+                              float damping = 0.0f, float friction = 0.0f);
+};
+
+// Commands posted by any thread (network, input) and applied by the physics
+// thread at one point of the step: systemManager::update drains the queue
+// before its first system runs. Pushing never locks or allocates.
+// A drain is applied as one batch ordered for cache locality:
+//   1. per-body commands by ascending body index (arrival order per body),
+//   2. removals by descending index, so swap-removes never move a body that
+//      is still to be removed,
+//   3. spawns in arrival order.
+// Commands naming a body that does not exist (any more) are dropped, and so
+// are repeated removals of one body within a drain.
+class WorldCommandQueue
+{
+public:
+    explicit WorldCommandQueue(size_t capacity = 4096);
+
+    // Any thread. False when the queue is full: the caller decides whether to
+    // retry next frame or drop the command.
+    bool push(const WorldCommand &command) { return queue.try_push(command); }
+
+    // Physics thread only. Returns the number of commands applied.
+    size_t apply(world &world);
+
+    size_t capacity() const { return queue.capacity(); }
+
+private:
+    MpscQueue<WorldCommand> queue;
+    std::vector<WorldCommand> batch; // Reused between drains
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include "sim/ISystem.hpp"
+#include "sim/collisionSystem.hpp"
+
+class world;
+
+// Extended position-based dynamics (world::integrator == IntegratorMode::XPBD).
+// The frame is split into world.xpbd_substeps substeps of one solver pass each
+// instead of one step with many iterations: predict positions from velocity,
+// project constraints and contacts with compliance (alpha / h^2), derive the
+// velocity from the displacement, then apply restitution in a velocity pass.
+// Contact candidates are gathered once per frame with a speculative margin
+// covering the frame's motion. The pairs that touched in any substep are
+// recorded in world.contacts / world.collision_events like collisionSystem's
+// (normal and depth of their last touching substep, normal impulse summed
+// over the frame). The contact pass
+// is serial: island_solving and simd_contact_solver do not apply. Verlet
+// worlds are left alone.
+class xpbdSystem : public ISystem
+{
+private:
+    // Grid rebuild + broad phase only; contacts are solved here.
+    collisionSystem broad_phase;
+
+    // Per-frame contact candidates (frame arena)
+    struct ContactRows
+    {
+        int *body_a = nullptr;
+        int *body_b = nullptr;
+        float *normal_x = nullptr;
+        float *normal_y = nullptr;
+        float *approach_speed = nullptr; // Normal velocity before the position solve
+        float *penetration = nullptr;    // Overlap before the last touching position solve
+        float *impulse = nullptr;        // Normal impulse over the frame (position + velocity passes)
+        unsigned char *touching = nullptr;
+        unsigned char *touched = nullptr; // Touching in some substep of the frame
+        size_t count = 0;
+    };
+
+    ContactRows gather_contacts(world &simulation_world, float delta_time);
+
+    // --- SUBSTEP PHASES ---
+    void solve_constraints(world &simulation_world, const float *inv_mass, float h);
+    void solve_contacts(world &simulation_world, ContactRows &contacts, const float *inv_mass, float h);
+    void solve_contact_velocities(world &simulation_world, ContactRows &contacts, const float *inv_mass, float h);
+    // Static level geometry and world boundaries: projected, normal velocity reflected.
+    void solve_static_and_boundary(world &simulation_world, const float *inv_mass);
+    // Contacts of the frame into the contact cache and event stream.
+    void record_contacts(world &simulation_world, const ContactRows &contacts);
+
+public:
+    void update(world &simulation_world, float delta_time) override;
+
+    xpbdSystem();
+    ~xpbdSystem();
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Linear (bump) allocator for per-step temporaries.
+// Every system that allocates from world::frame_arena resets it at the start
+// of its own update, so a pointer handed out is only valid until that
+// system's update returns, and calling a system directly (without a
+// systemManager) never grows the arena.
+// Blocks are only requested from the heap while the arena is still growing:
+// overflow blocks are coalesced into a single block on reset(), so once the
+// high-water mark is reached a step performs no heap allocation at all.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t initial_bytes = 64 * 1024) : initial_capacity(initial_bytes) {}
+
+    // Copies start with an empty arena: temporaries never outlive a step.
+    FrameArena(const FrameArena &other) : initial_capacity(other.initial_capacity) {}
+    FrameArena &operator=(const FrameArena &) { return *this; }
+    FrameArena(FrameArena &&) = default;
+    FrameArena &operator=(FrameArena &&) = default;
+
+    // Uninitialized storage for `count` objects of trivially destructible type T.
+    template <typename T>
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(allocate_bytes(count * sizeof(T), alignof(T)));
+    }
+
+    void *allocate_bytes(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        if (bytes == 0)
+            bytes = 1;
+        size_t aligned = align_offset(alignment);
+        if (!block || aligned + bytes > capacity)
+        {
+            grow(bytes + alignment);
+            aligned = align_offset(alignment);
+        }
+        offset = aligned + bytes;
+        used += bytes;
+        return block.get() + aligned;
+    }
+
+    // Release every allocation made since the last reset.
+    void reset()
+    {
+        if (!retired.empty())
+        {
+            // Coalesce: next step fits in one block.
+            size_t total = capacity;
+            for (auto &b : retired)
+                total += b.size;
+            retired.clear();
+            block.reset(new unsigned char[total]);
+            capacity = total;
+            ++heap_allocations;
+        }
+        offset = 0;
+        used = 0;
+    }
+
+    // Number of heap blocks requested over the arena's lifetime.
+    uint64_t allocation_count() const { return heap_allocations; }
+    size_t bytes_in_use() const { return used; }
+    size_t bytes_reserved() const
+    {
+        size_t total = capacity;
+        for (auto &b : retired)
+            total += b.size;
+        return total;
+    }
+
+private:
+    struct RetiredBlock
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+
+    // Alignment is applied to the address, not the offset, so requests wider
+    // than the allocator's default alignment (e.g. SIMD tiles) are honoured.
+    size_t align_offset(size_t alignment) const
+    {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+        uintptr_t p = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        return size_t(p - base);
+    }
+
+    void grow(size_t min_bytes)
+    {
+        size_t next = capacity > 0 ? capacity * 2 : initial_capacity;
+        while (next < min_bytes)
+            next *= 2;
+        if (block)
+        {
+            retired.reserve(8);
+            retired.push_back({std::move(block), capacity});
+        }
+        block.reset(new unsigned char[next]);
+        capacity = next;
+        offset = 0;
+        ++heap_allocations;
+    }
+
+    size_t initial_capacity;
+    std::unique_ptr<unsigned char[]> block;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t used = 0;
+    std::vector<RetiredBlock> retired;
+    uint64_t heap_allocations = 0;
+};
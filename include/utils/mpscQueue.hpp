@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free multi-producer / single-consumer queue.
+// Every slot carries a sequence number: a producer claims a position with one
+// compare-exchange on the tail and marks the slot readable once it is written;
+// the consumer only reads slots whose sequence says they are complete, so it
+// never sees a half-written value. Neither side takes a lock or allocates.
+template <typename T>
+class MpscQueue
+{
+public:
+    // Capacity is rounded up to a power of two.
+    explicit MpscQueue(size_t min_capacity = 1024)
+    {
+        size_t capacity = 2;
+        while (capacity < min_capacity)
+            capacity <<= 1;
+        mask = capacity - 1;
+        slots.reset(new Slot[capacity]);
+        for (size_t i = 0; i < capacity; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // Any thread. False when the queue is full (the value is not queued).
+    bool try_push(const T &value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot &slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false; // Full: the consumer has not freed this slot yet
+            else
+                position = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer thread only. False when nothing complete is queued.
+    bool try_pop(T &value)
+    {
+        Slot &slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+        value = slot.value;
+        // Free the slot for the producer one lap ahead
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> tail{0}; // Shared by producers
+    alignas(64) size_t head = 0;             // Consumer only
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads for data-parallel loops.
+// The calling thread takes part as worker 0, so a pool of size 1 spawns no
+// threads and runs everything inline.
+class ThreadPool
+{
+public:
+    // num_workers == 0 picks std::thread::hardware_concurrency().
+    explicit ThreadPool(unsigned num_workers = 0)
+    {
+        if (num_workers == 0)
+            num_workers = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned w = 1; w < num_workers; ++w)
+            threads.emplace_back([this, w] { worker_loop(w); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : threads)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const { return unsigned(threads.size()) + 1; }
+
+    // Run fn(worker) once on every worker and return when all have finished.
+    void run(const std::function<void(unsigned)> &fn)
+    {
+        if (threads.empty())
+        {
+            fn(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            pending = unsigned(threads.size());
+            ++generation;
+        }
+        wake.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+    // Split [0, count) into one contiguous range per worker, in order, and run
+    // fn(begin, end, worker) on each. Worker w always receives the w-th range,
+    // so per-worker outputs concatenate back into index order.
+    template <typename F>
+    void parallel_for(size_t count, F &&fn)
+    {
+        unsigned workers = (unsigned)std::min<size_t>(size(), std::max<size_t>(count, 1));
+        if (workers <= 1)
+        {
+            fn(size_t(0), count, 0u);
+            return;
+        }
+        run([&](unsigned w)
+        {
+            if (w >= workers)
+                return;
+            size_t begin = count * w / workers;
+            size_t end = count * (w + 1) / workers;
+            fn(begin, end, w);
+        });
+    }
+
+private:
+    void worker_loop(unsigned worker)
+    {
+        unsigned long long seen = 0;
+        for (;;)
+        {
+            const std::function<void(unsigned)> *task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                task = job;
+            }
+            (*task)(worker);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --pending;
+            }
+            done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(unsigned)> *job = nullptr;
+    unsigned pending = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
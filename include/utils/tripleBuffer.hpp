@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer triple buffer.
+// The producer fills its back slot and swaps it with the shared middle slot;
+// the consumer swaps its front slot with the middle one when it holds a newer
+// value. Neither side ever waits for the other, and the consumer always reads
+// the latest complete value (intermediate ones are skipped).
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Producer: the slot to fill, then publish() it.
+    T &back() { return slots[back_index]; }
+
+    void publish()
+    {
+        // Release: the filled slot is visible to the consumer that takes it
+        uint8_t previous = middle.exchange(uint8_t(back_index | FRESH), std::memory_order_acq_rel);
+        back_index = previous & INDEX_MASK;
+    }
+
+    // Consumer: swap in the newest published value, if any. Returns true when
+    // front() changed.
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        uint8_t previous = middle.exchange(front_index, std::memory_order_acq_rel);
+        front_index = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T &front() const { return slots[front_index]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4; // Middle slot holds a value the consumer has not taken
+
+    T slots[3];
+    uint8_t back_index = 0;  // Producer only
+    uint8_t front_index = 1; // Consumer only
+    std::atomic<uint8_t> middle{2};
+};
@@ -1,10 +1,20 @@
 #include "raylib.h"
 #include "physics/world.hpp"
 #include "physics/body.hpp"
+#include "physics/rollbackBuffer.hpp"
 #include "math/vec2.hpp"
 #include "sim/systemManager.hpp"
 #include "sim/movementSystem.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/constraintSystem.hpp"
+#include "sim/xpbdSystem.hpp"
+#include "sim/fluidSystem.hpp"
+#include "sim/forceFieldSystem.hpp"
+#include "sim/mutualGravitySystem.hpp"
+#include "sim/physicsRunner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <iostream>
 #include <vector>
@@ -124,31 +134,32 @@ int main()
     sim_world.grid_info.min_y = vis_min_y;
     sim_world.grid_info.max_y = vis_max_y;
 
-    // Recompute grid sizes and resize grid storage (same logic as in world constructor)
-    {
-        float width = sim_world.grid_info.max_x - sim_world.grid_info.min_x;
-        float height = sim_world.grid_info.max_y - sim_world.grid_info.min_y;
-        int numCellsX = static_cast<int>(std::ceil(width / sim_world.grid_info.cell_size));
-        int numCellsY = static_cast<int>(std::ceil(height / sim_world.grid_info.cell_size));
-        sim_world.grid_info.num_cells_x = numCellsX;
-        sim_world.grid_info.num_cells_y = numCellsY;
-        int totalCells = std::max(1, numCellsX * numCellsY);
-        sim_world.grid.clear();
-        sim_world.grid.resize(totalCells);
-    }
+    // Recompute grid sizes and resize grid storage for the new bounds
+    sim_world.resize_grid();
 
     // Note: previous_position was already initialized in the initial bodies vector before
     // constructing `sim_world` so the SoA previous_position arrays are correct.
 
     // Systems setup
     systemManager manager;
+    manager.addSystem(std::make_unique<forceFieldSystem>());
+    manager.addSystem(std::make_unique<mutualGravitySystem>());
+    manager.addSystem(std::make_unique<fluidSystem>());
     manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<constraintSystem>());
     manager.addSystem(std::make_unique<collisionSystem>());
+    manager.addSystem(std::make_unique<xpbdSystem>());
+
+    // Physics runs on its own thread from here on: the loop below only reads
+    // snapshots and posts edits (the world belongs to the runner).
+    // Static geometry is drawn from a copy, since collisionSystem bakes the original.
+    const StaticGeometry level_geometry = sim_world.static_geometry;
+    physicsRunner runner(sim_world, manager, fixed_dt);
+    runner.start();
 
-    float accumulator = 0.0f;
     // --- Selection and on-screen UI ---
     int selected_body_index = -1;
-    auto select_body_at_screen = [&](int mx, int my) -> int
+    auto select_body_at_screen = [&](const RenderSnapshot &frame, int mx, int my) -> int
     {
         // Convert screen to world
         float wx = (mx - center_x) / world_scale;
@@ -157,12 +168,12 @@ int main()
 
         float best_dist2 = 1e30f;
         int best_idx = -1;
-        size_t n = sim_world.size();
+        size_t n = frame.size();
         for (size_t i = 0; i < n; ++i)
         {
-            float px = sim_world.position_x[i];
-            float py = sim_world.position_y[i];
-            float r = (i < sim_world.radius.size()) ? sim_world.radius[i] : 0.0f;
+            float px = frame.position_x[i];
+            float py = frame.position_y[i];
+            float r = (i < frame.radius.size()) ? frame.radius[i] : 0.0f;
             float dx = px - click_world.x;
             float dy = py - click_world.y;
             float d2 = dx * dx + dy * dy;
@@ -182,7 +193,6 @@ int main()
     static vec2 mouse_history[8];
     static int mouse_history_idx = 0;
     static int mouse_history_count = 0;
-    vec2 last_mouse_world = vec2(0, 0);
 
     // Spawn parameters (modifiable with keys)
     static float spawn_mass = 1.0f;
@@ -198,136 +208,71 @@ int main()
 
     // Other code continues...
 
-    // --- 3. Main render and simulation loop ---
+    // --- 3. Main render loop (physics steps on the runner's thread) ---
     while (!WindowShouldClose())
     {
-
-        // --- A. Time Stepping (Stable physics with fixed step) ---
-        accumulator += GetFrameTime();
+        // --- A. Latest physics state ---
+        const RenderSnapshot &frame = runner.latest_snapshot();
+        const float alpha = frame.alpha_at(std::chrono::steady_clock::now(), fixed_dt);
 
         // --- Pause/step/snapshot controls ---
-        static bool paused = false;
-        static bool step_next = false;
-        static std::vector<body> snapshot;
+        // The snapshot is only touched by edits, i.e. on the physics thread.
+        // It holds the mutable columns only: loading needs the same bodies.
+        static RollbackBuffer snapshot(1);
 
         if (IsKeyPressed(KEY_P))
         {
-            paused = !paused;
+            runner.set_paused(!runner.is_paused());
+        }
+        if (IsKeyPressed(KEY_I))
+        {
+            runner.post([](world &w)
+            { w.integrator = w.integrator == IntegratorMode::Verlet ? IntegratorMode::XPBD : IntegratorMode::Verlet; });
+        }
+        if (IsKeyPressed(KEY_J))
+        {
+            runner.post([](world &w) { w.mutual_gravity = !w.mutual_gravity; });
+        }
+        if (IsKeyPressed(KEY_K))
+        {
+            // every body present becomes a fluid particle (or stops being one)
+            runner.post([](world &w)
+            {
+                w.sph_fluid = !w.sph_fluid;
+                for (size_t i = 0; i < w.size(); ++i)
+                    w.set_fluid(i, w.sph_fluid);
+            });
         }
         if (IsKeyPressed(KEY_N))
         {
             // single step
-            if (paused)
-                step_next = true;
+            if (runner.is_paused())
+                runner.request_step();
         }
         if (IsKeyPressed(KEY_O))
         {
-            // copy current state by building an in-memory snapshot from SoA arrays
-            snapshot.clear();
-            size_t n = sim_world.size();
-            snapshot.resize(n);
-            for (size_t i = 0; i < n; ++i)
-            {
-                snapshot[i].position = sim_world.get_position(i);
-                snapshot[i].previous_position = vec2(sim_world.previous_position_x[i], sim_world.previous_position_y[i]);
-                snapshot[i].velocity = vec2(sim_world.vel_x[i], sim_world.vel_y[i]);
-                snapshot[i].acceleration = vec2(sim_world.acc_x[i], sim_world.acc_y[i]);
-                snapshot[i].mass = (i < sim_world.mass.size()) ? sim_world.mass[i] : 0.0f;
-                snapshot[i].inv_mass = (i < sim_world.inv_mass.size()) ? sim_world.inv_mass[i] : 0.0f;
-                snapshot[i].radius = (i < sim_world.radius.size()) ? sim_world.radius[i] : 0.0f;
-                snapshot[i].damping = (i < sim_world.damping.size()) ? sim_world.damping[i] : 0.0f;
-                snapshot[i].friction = (i < sim_world.friction.size()) ? sim_world.friction[i] : 0.0f;
-                snapshot[i].restitution = (i < sim_world.restitution.size()) ? sim_world.restitution[i] : 1.0f;
-            }
+            runner.post([](world &sim_world) { snapshot.save(sim_world, 0); });
         }
         if (IsKeyPressed(KEY_L))
         {
-            if (!snapshot.empty())
-            {
-                // prepare snapshot: recompute inv_mass and previous_position before restoring
-                for (auto &b : snapshot)
-                {
-                    b.inv_mass = (b.mass > 0.0f) ? 1.0f / b.mass : 0.0f;
-                    float dt = sim_world.delta_time;
-                    if (dt > 0.0f)
-                        b.previous_position = b.position - b.velocity * dt;
-                }
-                // Restore by clearing and re-adding bodies (simple approach)
-                // Note: this keeps other per-world state (grid bounds)
-                // but resets per-particle SoA arrays to snapshot values.
-                sim_world.position_x.clear();
-                sim_world.position_y.clear();
-                sim_world.previous_position_x.clear();
-                sim_world.previous_position_y.clear();
-                sim_world.vel_x.clear();
-                sim_world.vel_y.clear();
-                sim_world.acc_x.clear();
-                sim_world.acc_y.clear();
-                sim_world.mass.clear();
-                sim_world.inv_mass.clear();
-                sim_world.radius.clear();
-                sim_world.damping.clear();
-                sim_world.friction.clear();
-                sim_world.restitution.clear();
-                for (auto &b : snapshot)
-                {
-                    sim_world.add_body(b);
-                }
-            }
-        }
-
-        // Run physics only when not paused, or single-step requested
-        while (accumulator >= fixed_dt)
-        {
-            if (!paused || step_next)
+            runner.post([](world &sim_world)
             {
-                // Apply runtime gravity scaling before the physics step
-                sim_world.gravity_x = gravity.x * gravity_scale;
-                sim_world.gravity_y = gravity.y * gravity_scale;
-                manager.update(sim_world, fixed_dt); // Update physics
-                static bool printed_after_step = false;
-                if (!printed_after_step)
-                {
-                    std::cout << "SIM_DEBUG_POST: after first update" << "\n";
-                    for (size_t i = 0; i < sim_world.size(); ++i)
-                    {
-                        std::cout << "SIM_DEBUG_POST: B" << i << " pos=(" << sim_world.position_x[i] << "," << sim_world.position_y[i] << ") ";
-                        std::cout << "prev=(" << sim_world.previous_position_x[i] << "," << sim_world.previous_position_y[i] << ") ";
-                        std::cout << "vel=(" << sim_world.vel_x[i] << "," << sim_world.vel_y[i] << ")\n";
-                    }
-                    printed_after_step = true;
-                }
-                step_next = false;
-            }
-            accumulator -= fixed_dt;
-            if (paused)
-                break; // when paused, only run one step per keypress
+                if (!snapshot.restore(sim_world, 0))
+                    std::cout << "Snapshot not loaded: bodies were added or removed since it was saved\n";
+            });
         }
 
-        // boundary clamping removed: collisionSystem now handles wall/ground bounces
-
         // Smoothly move selected/dragged body towards mouse while dragging
-        if (dragging && dragging_idx >= 0 && dragging_idx < (int)sim_world.size())
+        if (dragging && dragging_idx >= 0 && dragging_idx < (int)frame.size())
         {
-            // Update position: set_position updates SoA arrays.
-            // For velocity/previous_position we update the internal arrays directly.
-            // Acquire new position below and assign via set_position.
             // latest mouse world
             vec2 latest_mouse = mouse_history[(mouse_history_idx - 1 + 8) % 8];
             // lerp factor (0..1) smaller = smoother
             float lerp_f = 0.25f;
-            vec2 oldpos = sim_world.get_position(dragging_idx);
+            vec2 oldpos(frame.position_x[dragging_idx], frame.position_y[dragging_idx]);
             vec2 newpos = oldpos * (1.0f - lerp_f) + latest_mouse * lerp_f;
-            sim_world.set_position(dragging_idx, newpos);
-            // zero velocity while dragging to avoid physics fighting the drag
-            sim_world.vel_x[dragging_idx] = 0.0f;
-            sim_world.vel_y[dragging_idx] = 0.0f;
-            float dt = sim_world.delta_time;
-            if (dt > 0.0f)
-            {
-                sim_world.previous_position_x[dragging_idx] = newpos.x - 0.0f * dt;
-                sim_world.previous_position_y[dragging_idx] = newpos.y - 0.0f * dt;
-            }
+            // Teleport also zeroes velocity, so physics doesn't fight the drag
+            manager.commands().push(WorldCommand::teleport(uint32_t(dragging_idx), newpos));
         }
 
         // --- INPUT: Drag / Spawn / Selection and property modification ---
@@ -339,7 +284,7 @@ int main()
             {
                 int mx = GetMouseX();
                 int my = GetMouseY();
-                int idx = select_body_at_screen(mx, my);
+                int idx = select_body_at_screen(frame, mx, my);
                 if (idx >= 0)
                 {
                     dragging = true;
@@ -358,11 +303,10 @@ int main()
 
         if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON))
         {
-            if (dragging && dragging_idx >= 0 && dragging_idx < (int)sim_world.size())
+            if (dragging && dragging_idx >= 0 && dragging_idx < (int)frame.size())
             {
-                // Update velocity on release. We update the SoA velocity and previous_position arrays
-                // and keep internal SoA arrays updated.
-                // compute average mouse velocity from history
+                // Throw velocity: average mouse velocity from history (fallback: none)
+                vec2 throw_velocity(0.0f, 0.0f);
                 if (mouse_history_count >= 2)
                 {
                     int oldest = (mouse_history_idx - mouse_history_count + 8) % 8;
@@ -372,22 +316,9 @@ int main()
                     float dt_total = (float)mouse_history_count * (1.0f / 60.0f); // approximate frame dt
                     vec2 mouse_vel = (dt_total > 0.0f) ? delta * (1.0f / dt_total) : vec2(0, 0);
                     // apply a scaled down version as throw velocity
-                    sim_world.vel_x[dragging_idx] = (mouse_vel * 0.5f).x;
-                    sim_world.vel_y[dragging_idx] = (mouse_vel * 0.5f).y;
-                }
-                else
-                {
-                    // fallback: small nudge
-                    sim_world.vel_x[dragging_idx] = 0.0f;
-                    sim_world.vel_y[dragging_idx] = 0.0f;
-                }
-                float dt = sim_world.delta_time;
-                if (dt > 0.0f)
-                {
-                    vec2 pos = sim_world.get_position(dragging_idx);
-                    sim_world.previous_position_x[dragging_idx] = pos.x - sim_world.vel_x[dragging_idx] * dt;
-                    sim_world.previous_position_y[dragging_idx] = pos.y - sim_world.vel_y[dragging_idx] * dt;
+                    throw_velocity = mouse_vel * 0.5f;
                 }
+                manager.commands().push(WorldCommand::set_velocity(uint32_t(dragging_idx), throw_velocity));
             }
             dragging = false;
             dragging_idx = -1;
@@ -400,11 +331,30 @@ int main()
             int my = GetMouseY();
             float wx = (mx - center_x) / world_scale;
             float wy = (center_y - my) / world_scale;
-            body nb = create_body(wx, wy, 0.0f, 0.0f, spawn_mass, spawn_radius, spawn_restitution, spawn_damping, spawn_friction);
-            float dt = sim_world.delta_time;
-            if (dt > 0.0f)
-                nb.previous_position = nb.position - nb.velocity * dt;
-            sim_world.add_body(nb);
+            manager.commands().push(WorldCommand::spawn(vec2(wx, wy), vec2(0.0f, 0.0f), spawn_mass, spawn_radius, spawn_restitution, spawn_damping, spawn_friction));
+        }
+
+        // E: explosion at mouse, F: move the attractor (gravity well) to the mouse
+        if (IsKeyPressed(KEY_E) || IsKeyPressed(KEY_F))
+        {
+            float wx = (GetMouseX() - center_x) / world_scale;
+            float wy = (center_y - GetMouseY()) / world_scale;
+            bool explode = IsKeyPressed(KEY_E);
+            bool attract = IsKeyPressed(KEY_F);
+            runner.post([wx, wy, explode, attract](world &w)
+            {
+                ForceFieldSet &fields = w.force_fields;
+                if (explode)
+                    fields.add_radial_impulse(vec2(wx, wy), 15.0f, 25.0f);
+                if (attract)
+                {
+                    auto well = std::find(fields.type.begin(), fields.type.end(), ForceFieldType::GravityWell);
+                    if (well == fields.type.end())
+                        fields.add_gravity_well(vec2(wx, wy), 20.0f, 30.0f);
+                    else
+                        fields.set_center(int(well - fields.type.begin()), vec2(wx, wy));
+                }
+            });
         }
 
         // Spawn parameter keys: 1/2 mass, 3/4 restitution, 5/6 radius
@@ -422,14 +372,23 @@ int main()
             spawn_radius += 0.1f;
         // Tweak global damping
         if (IsKeyPressed(KEY_LEFT_BRACKET))
-            sim_world.global_damping = std::max(0.0f, sim_world.global_damping - 0.005f);
+            runner.post([](world &w) { w.global_damping = std::max(0.0f, w.global_damping - 0.005f); });
         if (IsKeyPressed(KEY_RIGHT_BRACKET))
-            sim_world.global_damping = std::min(0.5f, sim_world.global_damping + 0.005f);
+            runner.post([](world &w) { w.global_damping = std::min(0.5f, w.global_damping + 0.005f); });
         // Tweak gravity scale
-        if (IsKeyPressed(KEY_COMMA))
-            gravity_scale = std::max(0.0f, gravity_scale - 0.05f);
-        if (IsKeyPressed(KEY_PERIOD))
-            gravity_scale += 0.05f;
+        if (IsKeyPressed(KEY_COMMA) || IsKeyPressed(KEY_PERIOD))
+        {
+            if (IsKeyPressed(KEY_COMMA))
+                gravity_scale = std::max(0.0f, gravity_scale - 0.05f);
+            if (IsKeyPressed(KEY_PERIOD))
+                gravity_scale += 0.05f;
+            vec2 scaled_gravity = gravity * gravity_scale;
+            runner.post([scaled_gravity](world &w)
+            {
+                w.gravity_x = scaled_gravity.x;
+                w.gravity_y = scaled_gravity.y;
+            });
+        }
         // Spawn damping/friction keys: 7/8 damping -, + ; 9/0 friction -, +
         if (IsKeyPressed(KEY_SEVEN))
             spawn_damping = std::max(0.0f, spawn_damping - 0.05f);
@@ -445,97 +404,96 @@ int main()
         {
             int mx = GetMouseX();
             int my = GetMouseY();
-            int idx = select_body_at_screen(mx, my);
+            int idx = select_body_at_screen(frame, mx, my);
             selected_body_index = idx;
         }
 
-        if (selected_body_index >= 0 && selected_body_index < (int)sim_world.size())
+        if (selected_body_index >= 0 && selected_body_index < (int)frame.size())
         {
-            bool changed = false;
+            // Property edits run on the physics thread, followed by a resync of
+            // inv_mass and previous_position
+            int idx = selected_body_index;
+            auto edit_selected = [&runner, idx](std::function<void(world &)> change)
+            {
+                runner.post([idx, change](world &sim_world)
+                {
+                    if (idx >= (int)sim_world.size())
+                        return;
+                    change(sim_world);
+                    // Recompute inv_mass and synchronize previous_position in SoA arrays
+                    float massVal = sim_world.mass[idx];
+                    sim_world.inv_mass[idx] = (massVal > 0.0f) ? 1.0f / massVal : 0.0f;
+                    float dt = sim_world.delta_time;
+                    if (dt > 0.0f)
+                    {
+                        sim_world.previous_position_x[idx] = sim_world.position_x[idx] - sim_world.vel_x[idx] * dt;
+                        sim_world.previous_position_y[idx] = sim_world.position_y[idx] - sim_world.vel_y[idx] * dt;
+                    }
+                });
+            };
 
             // Adjustments: M/B mass +/-, R/T restitution +/-, S/A radius +/-
             if (IsKeyPressed(KEY_M))
-            {
-                sim_world.mass[selected_body_index] += 0.1f;
-                changed = true;
-            }
+                edit_selected([idx](world &w) { w.mass[idx] += 0.1f; });
             if (IsKeyPressed(KEY_B)) // alternative for lowercase b
-            {
-                sim_world.mass[selected_body_index] = std::max(0.0f, sim_world.mass[selected_body_index] - 0.1f);
-                changed = true;
-            }
+                edit_selected([idx](world &w) { w.mass[idx] = std::max(0.0f, w.mass[idx] - 0.1f); });
             if (IsKeyPressed(KEY_R))
-            {
-                if (selected_body_index < sim_world.restitution.size())
-                    sim_world.restitution[selected_body_index] = std::min(1.0f, sim_world.restitution[selected_body_index] + 0.05f);
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    if (idx < (int)w.restitution.size())
+                        w.restitution[idx] = std::min(1.0f, w.restitution[idx] + 0.05f);
+                });
             if (IsKeyPressed(KEY_T)) // alternative for decreasing restitution
-            {
-                if (selected_body_index < sim_world.restitution.size())
-                    sim_world.restitution[selected_body_index] = std::max(0.0f, sim_world.restitution[selected_body_index] - 0.05f);
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    if (idx < (int)w.restitution.size())
+                        w.restitution[idx] = std::max(0.0f, w.restitution[idx] - 0.05f);
+                });
             if (IsKeyPressed(KEY_S))
-            {
-                sim_world.radius[selected_body_index] = sim_world.radius[selected_body_index] + 0.1f;
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    w.radius[idx] += 0.1f;
+                    w.neighbor_list.invalidate();
+                });
             if (IsKeyPressed(KEY_A)) // alternative for decreasing radius
-            {
-                sim_world.radius[selected_body_index] = std::max(0.1f, sim_world.radius[selected_body_index] - 0.1f);
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    w.radius[idx] = std::max(0.1f, w.radius[idx] - 0.1f);
+                    w.neighbor_list.invalidate();
+                });
 
             // Damping adjustments: Y increase, U decrease
             if (IsKeyPressed(KEY_Y))
-            {
-                if (selected_body_index < sim_world.damping.size())
-                    sim_world.damping[selected_body_index] = std::max(0.0f, sim_world.damping[selected_body_index] - 0.01f);
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    if (idx < (int)w.damping.size())
+                        w.damping[idx] = std::max(0.0f, w.damping[idx] - 0.01f);
+                });
             if (IsKeyPressed(KEY_U))
-            {
-                if (selected_body_index < sim_world.damping.size())
-                    sim_world.damping[selected_body_index] += 0.01f;
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    if (idx < (int)w.damping.size())
+                        w.damping[idx] += 0.01f;
+                });
             // Friction adjustments: G increase, H decrease
             if (IsKeyPressed(KEY_G))
-            {
-                if (selected_body_index < sim_world.friction.size())
-                    sim_world.friction[selected_body_index] = std::max(0.0f, sim_world.friction[selected_body_index] - 0.01f);
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    if (idx < (int)w.friction.size())
+                        w.friction[idx] = std::max(0.0f, w.friction[idx] - 0.01f);
+                });
             if (IsKeyPressed(KEY_H))
-            {
-                if (selected_body_index < sim_world.friction.size())
-                    sim_world.friction[selected_body_index] += 0.01f;
-                changed = true;
-            }
+                edit_selected([idx](world &w)
+                {
+                    if (idx < (int)w.friction.size())
+                        w.friction[idx] += 0.01f;
+                });
 
             // Delete selected body (DEL or X)
             if (IsKeyPressed(KEY_X) || IsKeyPressed(KEY_DELETE))
             {
-                sim_world.remove_body(selected_body_index);
+                manager.commands().push(WorldCommand::remove(uint32_t(idx)));
                 selected_body_index = -1;
-                continue; // skip further handling for this frame
-            }
-
-            if (changed)
-            {
-                // Recompute inv_mass and synchronize previous_position in SoA arrays
-                float massVal = sim_world.mass[selected_body_index];
-                sim_world.inv_mass[selected_body_index] = (massVal > 0.0f) ? 1.0f / massVal : 0.0f;
-                float dt = sim_world.delta_time;
-                if (dt > 0.0f)
-                {
-                    float vx = sim_world.vel_x[selected_body_index];
-                    float vy = sim_world.vel_y[selected_body_index];
-                    sim_world.previous_position_x[selected_body_index] = sim_world.position_x[selected_body_index] - vx * dt;
-                    sim_world.previous_position_y[selected_body_index] = sim_world.position_y[selected_body_index] - vy * dt;
-                }
-                // SoA arrays are canonical. If UI changed SoA arrays above, they are ready.
             }
         }
 
@@ -549,15 +507,32 @@ int main()
         DrawLine(0, (int)ground_screen_pos.y, screen_width, (int)ground_screen_pos.y, WHITE);
         DrawText("Ground (Y = 0.0m)", 10, (int)ground_screen_pos.y - 20, 20, WHITE);
 
-        // 2. Draw bodies (and labels)
-        for (size_t i = 0; i < sim_world.size(); ++i)
+        // Static level geometry (segments and polygon outlines)
+        const StaticGeometry &geometry = level_geometry;
+        for (size_t s = 0; s < geometry.size(); ++s)
         {
-            vec2 pos(sim_world.position_x[i], sim_world.position_y[i]);
-            int screen_radius = (int)(sim_world.radius[i] * world_scale);
+            int first = geometry.shape_first[s];
+            int count = geometry.shape_vertex_count[s];
+            int edges = geometry.shape_type[s] == StaticShapeType::Segment ? 1 : count;
+            for (int e = 0; e < edges; ++e)
+            {
+                int a = first + e;
+                int b = first + (e + 1) % count;
+                vec2 pa = WorldToScreen(vec2(geometry.vertex_x[a], geometry.vertex_y[a]));
+                vec2 pb = WorldToScreen(vec2(geometry.vertex_x[b], geometry.vertex_y[b]));
+                DrawLine((int)pa.x, (int)pa.y, (int)pb.x, (int)pb.y, LIGHTGRAY);
+            }
+        }
+
+        // 2. Draw bodies (and labels), interpolated between the last two steps
+        for (size_t i = 0; i < frame.size(); ++i)
+        {
+            vec2 pos = frame.interpolated_position(i, alpha);
+            int screen_radius = (int)(frame.radius[i] * world_scale);
             vec2 screen_pos = WorldToScreen(pos);
 
             // Use fixed color per-body type: static=RED, dynamic=BLUE
-            Color draw_color = (sim_world.inv_mass[i] == 0.0f) ? RED : BLUE;
+            Color draw_color = (frame.inv_mass[i] == 0.0f) ? RED : BLUE;
 
             // Draw main circle
             DrawCircle((int)screen_pos.x, (int)screen_pos.y, screen_radius, draw_color);
@@ -565,7 +540,7 @@ int main()
             DrawCircleLines((int)screen_pos.x, (int)screen_pos.y, screen_radius, BLACK);
 
             // Label with id and mass above the body
-            float mass = (i < sim_world.mass.size()) ? sim_world.mass[i] : 0.0f;
+            float mass = (i < frame.mass.size()) ? frame.mass[i] : 0.0f;
             DrawText(TextFormat("#%d m:%.2f", (int)i, mass), (int)screen_pos.x - screen_radius, (int)screen_pos.y - screen_radius - 18, 12, WHITE);
 
             // Highlight if selected
@@ -590,28 +565,37 @@ int main()
         // Primary HUD lines
         DrawFPS(hud_x, hud_y);
         hud_y += hud_line_h;
-        DrawText("Fixed DT: 1/60s", hud_x, hud_y, 16, WHITE);
+        DrawText(TextFormat("Fixed DT: 1/60s, physics thread (step %llu)", (unsigned long long)frame.step), hud_x, hud_y, 16, WHITE);
+        hud_y += hud_line_h;
+        DrawText(TextFormat("Gravity: %.2fm/s^2 (use , . to +/-)", frame.gravity_y), hud_x, hud_y, 16, WHITE);
         hud_y += hud_line_h;
-        DrawText(TextFormat("Gravity: %.2fm/s^2 (use , . to +/-)", sim_world.gravity_y * gravity_scale), hud_x, hud_y, 16, WHITE);
+        DrawText(TextFormat("Global damping: %.4f (use [ ] to +/-)", frame.global_damping), hud_x, hud_y, 16, WHITE);
         hud_y += hud_line_h;
-        DrawText(TextFormat("Global damping: %.4f (use [ ] to +/-)", sim_world.global_damping), hud_x, hud_y, 16, WHITE);
+        if (frame.integrator == IntegratorMode::XPBD)
+            DrawText(TextFormat("Integrator: XPBD, %d substeps (use I to switch)", frame.xpbd_substeps), hud_x, hud_y, 16, WHITE);
+        else
+            DrawText("Integrator: Verlet (use I to switch)", hud_x, hud_y, 16, WHITE);
         hud_y += hud_line_h;
         DrawText("P: Pause/Resume  N: Step (when paused)", hud_x, hud_y, 14, LIGHTGRAY);
         hud_y += hud_line_h;
         DrawText("O: Save snapshot  L: Load snapshot  SPACE: Spawn", hud_x, hud_y, 14, LIGHTGRAY);
         hud_y += hud_line_h;
+        DrawText("E: Explosion at mouse  F: Attractor at mouse", hud_x, hud_y, 14, LIGHTGRAY);
+        hud_y += hud_line_h;
+        DrawText(TextFormat("J: Mutual gravity (%s)  K: SPH fluid (%s)", frame.mutual_gravity ? "on" : "off", frame.sph_fluid ? "on" : "off"), hud_x, hud_y, 14, LIGHTGRAY);
+        hud_y += hud_line_h;
 
         // 4. Properties panel (if selected)
-        if (selected_body_index >= 0 && selected_body_index < (int)sim_world.size())
+        if (selected_body_index >= 0 && selected_body_index < (int)frame.size())
         {
-            // Read properties from SoA arrays
-            float sel_mass = (selected_body_index < sim_world.mass.size()) ? sim_world.mass[selected_body_index] : 0.0f;
-            float sel_inv_mass = (selected_body_index < sim_world.inv_mass.size()) ? sim_world.inv_mass[selected_body_index] : 0.0f;
-            float sel_radius = (selected_body_index < sim_world.radius.size()) ? sim_world.radius[selected_body_index] : 0.0f;
-            // Prefer SoA values.
-            float sel_restitution = sim_world.get_restitution(selected_body_index);
-            float sel_damping = sim_world.get_damping(selected_body_index);
-            float sel_friction = sim_world.get_friction(selected_body_index);
+            // Read properties from the snapshot
+            size_t sel = (size_t)selected_body_index;
+            float sel_mass = (sel < frame.mass.size()) ? frame.mass[sel] : 0.0f;
+            float sel_inv_mass = (sel < frame.inv_mass.size()) ? frame.inv_mass[sel] : 0.0f;
+            float sel_radius = (sel < frame.radius.size()) ? frame.radius[sel] : 0.0f;
+            float sel_restitution = (sel < frame.restitution.size()) ? frame.restitution[sel] : 1.0f;
+            float sel_damping = (sel < frame.damping.size()) ? frame.damping[sel] : 0.0f;
+            float sel_friction = (sel < frame.friction.size()) ? frame.friction[sel] : 0.0f;
             int panel_x = screen_width - 260;
             int panel_y = 10;
             DrawRectangle(panel_x - 10, panel_y - 10, 250, 140, Fade(BLACK, 0.6f));
@@ -634,6 +618,7 @@ int main()
     }
 
     // --- 4. Resource cleanup ---
+    runner.stop();
     CloseWindow();
     return 0;
 }
\ No newline at end of file
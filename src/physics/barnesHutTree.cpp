@@ -0,0 +1,454 @@
+#include "physics/barnesHutTree.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+const int BARNES_HUT_LEAF_SIZE = 8;     // Bodies per leaf before it is split
+const int BARNES_HUT_GROUP_SIZE = 32;   // Most bodies sharing one interaction list
+const int BARNES_HUT_MAX_LEVEL = 16;    // Morton bits per axis
+const uint8_t BARNES_HUT_TASK_DEPTH = 3; // Subtrees at this depth are aggregated as parallel tasks
+
+// Spread the low 16 bits of v over the even bits
+static inline uint32_t spread_bits(uint32_t v)
+{
+    v &= 0x0000ffffu;
+    v = (v | (v << 8)) & 0x00ff00ffu;
+    v = (v | (v << 4)) & 0x0f0f0f0fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+template <typename F>
+static void run_range(ThreadPool *pool, size_t count, F &&fn)
+{
+    if (pool && pool->size() > 1)
+        pool->parallel_for(count, fn);
+    else
+        fn(size_t(0), count, 0u);
+}
+
+void BarnesHutTree::build(const world &simulation_world, ThreadPool *pool)
+{
+    const size_t n = simulation_world.position_x.size();
+    const float *px = simulation_world.position_x.data();
+    const float *py = simulation_world.position_y.data();
+    const float *body_mass = simulation_world.mass.data();
+
+    next.clear();
+    body_begin.clear();
+    body_end.clear();
+    leaf.clear();
+    depth.clear();
+    center_x.clear();
+    center_y.clear();
+    half_size.clear();
+    mass.clear();
+    com_x.clear();
+    com_y.clear();
+    groups.clear();
+    order.resize(n);
+    sorted_x.resize(n);
+    sorted_y.resize(n);
+    sorted_mass.resize(n);
+    if (n == 0)
+        return;
+    // Single-quadrant cells are shrunk instead of getting a node, so every
+    // inner node has at least two children: at most 2n - 1 nodes. Reserving
+    // that keeps later builds from reallocating as the bodies move.
+    const size_t max_nodes = 2 * n;
+    for (auto *column : {&next, &body_begin, &body_end, &groups})
+        column->reserve(max_nodes);
+    for (auto *column : {&leaf, &depth})
+        column->reserve(max_nodes);
+    for (auto *column : {&center_x, &center_y, &half_size, &mass, &com_x, &com_y})
+        column->reserve(max_nodes);
+
+    // 1. Square bounding box (per-worker partial bounds)
+    unsigned workers = pool ? pool->size() : 1u;
+    std::vector<float> &bounds = worker_bounds;
+    bounds.resize(size_t(workers) * 4);
+    for (unsigned w = 0; w < workers; ++w)
+    {
+        bounds[w * 4 + 0] = bounds[w * 4 + 1] = std::numeric_limits<float>::max();
+        bounds[w * 4 + 2] = bounds[w * 4 + 3] = std::numeric_limits<float>::lowest();
+    }
+    run_range(pool, n, [&](size_t begin, size_t end, unsigned w)
+    {
+        float *b = bounds.data() + w * 4;
+        for (size_t i = begin; i < end; ++i)
+        {
+            b[0] = std::min(b[0], px[i]);
+            b[1] = std::min(b[1], py[i]);
+            b[2] = std::max(b[2], px[i]);
+            b[3] = std::max(b[3], py[i]);
+        }
+    });
+    float min_x = bounds[0], min_y = bounds[1], max_x = bounds[2], max_y = bounds[3];
+    for (unsigned w = 1; w < workers; ++w)
+    {
+        min_x = std::min(min_x, bounds[w * 4 + 0]);
+        min_y = std::min(min_y, bounds[w * 4 + 1]);
+        max_x = std::max(max_x, bounds[w * 4 + 2]);
+        max_y = std::max(max_y, bounds[w * 4 + 3]);
+    }
+    float half = 0.5f * std::max(std::max(max_x - min_x, max_y - min_y), 1e-3f) * 1.0001f;
+    float root_x = 0.5f * (min_x + max_x);
+    float root_y = 0.5f * (min_y + max_y);
+
+    // 2. Morton codes (x on the even bits, y on the odd bits), then sort
+    codes.resize(n);
+    float origin_x = root_x - half;
+    float origin_y = root_y - half;
+    float scale = float(1 << BARNES_HUT_MAX_LEVEL) / (2.0f * half);
+    const float max_cell = float((1 << BARNES_HUT_MAX_LEVEL) - 1);
+    run_range(pool, n, [&](size_t begin, size_t end, unsigned)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            uint32_t qx = uint32_t(std::min(std::max((px[i] - origin_x) * scale, 0.0f), max_cell));
+            uint32_t qy = uint32_t(std::min(std::max((py[i] - origin_y) * scale, 0.0f), max_cell));
+            codes[i] = spread_bits(qx) | (spread_bits(qy) << 1);
+        }
+    });
+    std::iota(order.begin(), order.end(), 0);
+    sort_by_code();
+    for (size_t s = 0; s < n; ++s)
+    {
+        int i = order[s];
+        sorted_x[s] = px[i];
+        sorted_y[s] = py[i];
+        sorted_mass[s] = std::max(body_mass[i], 0.0f);
+    }
+
+    // 3. Nodes, depth-first
+    build_node(0, int(n), 0, root_x, root_y, half, 0, false);
+
+    // 4. Mass and center of mass bottom-up: reverse preorder visits children
+    //    before parents. Subtrees rooted at BARNES_HUT_TASK_DEPTH are
+    //    independent tasks; the few nodes above them are done afterwards.
+    std::vector<int> &tasks = task_roots;
+    tasks.clear();
+    for (size_t node = 0; node < num_nodes(); ++node)
+        if (depth[node] == BARNES_HUT_TASK_DEPTH)
+            tasks.push_back(int(node));
+    run_range(pool, tasks.size(), [&](size_t begin, size_t end, unsigned)
+    {
+        for (size_t t = begin; t < end; ++t)
+            for (int node = next[tasks[t]] - 1; node >= tasks[t]; --node)
+                aggregate(node);
+    });
+    for (int node = int(num_nodes()) - 1; node >= 0; --node)
+        if (depth[node] < BARNES_HUT_TASK_DEPTH)
+            aggregate(node);
+}
+
+void BarnesHutTree::sort_by_code()
+{
+    // LSD radix sort of (code, body), 8 bits per pass
+    size_t n = codes.size();
+    code_scratch.resize(n);
+    order_scratch.resize(n);
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        size_t count[257] = {};
+        for (size_t i = 0; i < n; ++i)
+            ++count[((codes[i] >> shift) & 0xffu) + 1];
+        for (int b = 0; b < 256; ++b)
+            count[b + 1] += count[b];
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t slot = count[(codes[i] >> shift) & 0xffu]++;
+            code_scratch[slot] = codes[i];
+            order_scratch[slot] = order[i];
+        }
+        codes.swap(code_scratch);
+        order.swap(order_scratch);
+    }
+}
+
+int BarnesHutTree::build_node(int begin, int end, int level, float cx, float cy, float half, uint8_t node_depth, bool grouped)
+{
+    // Quadrant q of the range holds the bodies whose 2 code bits at this level
+    // equal q; higher bits are shared, so the quadrants are consecutive.
+    int quadrant_start[5];
+    bool is_leaf = false;
+    for (;;)
+    {
+        if (end - begin <= BARNES_HUT_LEAF_SIZE || level >= BARNES_HUT_MAX_LEVEL)
+        {
+            is_leaf = true;
+            break;
+        }
+        int shift = 2 * (BARNES_HUT_MAX_LEVEL - 1 - level);
+        quadrant_start[0] = begin;
+        quadrant_start[4] = end;
+        for (uint32_t q = 1; q < 4; ++q)
+            quadrant_start[q] = int(std::partition_point(codes.begin() + quadrant_start[q - 1], codes.begin() + end,
+                                                         [&](uint32_t code) { return ((code >> shift) & 3u) < q; }) -
+                                    codes.begin());
+        int occupied = 0, last = 0;
+        for (int q = 0; q < 4; ++q)
+            if (quadrant_start[q + 1] > quadrant_start[q])
+            {
+                ++occupied;
+                last = q;
+            }
+        if (occupied > 1)
+            break;
+        // A single occupied quadrant: shrink the cell instead of adding a node
+        half *= 0.5f;
+        cx += (last & 1) ? half : -half;
+        cy += (last & 2) ? half : -half;
+        ++level;
+    }
+
+    int node = int(num_nodes());
+    next.push_back(node + 1);
+    body_begin.push_back(begin);
+    body_end.push_back(end);
+    leaf.push_back(is_leaf ? 1 : 0);
+    depth.push_back(node_depth);
+    center_x.push_back(cx);
+    center_y.push_back(cy);
+    half_size.push_back(half);
+    mass.push_back(0.0f);
+    com_x.push_back(cx);
+    com_y.push_back(cy);
+    // Groups: the largest nodes with at most BARNES_HUT_GROUP_SIZE bodies
+    // (or a leaf of coincident bodies at the last level)
+    if (!grouped && (end - begin <= BARNES_HUT_GROUP_SIZE || is_leaf))
+    {
+        groups.push_back(node);
+        grouped = true;
+    }
+    if (is_leaf)
+        return node;
+
+    float child_half = half * 0.5f;
+    for (int q = 0; q < 4; ++q)
+        if (quadrant_start[q + 1] > quadrant_start[q])
+            build_node(quadrant_start[q], quadrant_start[q + 1], level + 1,
+                       cx + ((q & 1) ? child_half : -child_half), cy + ((q & 2) ? child_half : -child_half),
+                       child_half, uint8_t(std::min(node_depth + 1, 255)), grouped);
+    next[node] = int(num_nodes());
+    return node;
+}
+
+void BarnesHutTree::aggregate(int node)
+{
+    float total = 0.0f, moment_x = 0.0f, moment_y = 0.0f;
+    if (leaf[node])
+    {
+        for (int s = body_begin[node]; s < body_end[node]; ++s)
+        {
+            total += sorted_mass[s];
+            moment_x += sorted_mass[s] * sorted_x[s];
+            moment_y += sorted_mass[s] * sorted_y[s];
+        }
+    }
+    else
+    {
+        for (int child = node + 1; child < next[node]; child = next[child])
+        {
+            total += mass[child];
+            moment_x += mass[child] * com_x[child];
+            moment_y += mass[child] * com_y[child];
+        }
+    }
+    mass[node] = total;
+    if (total > 0.0f)
+    {
+        com_x[node] = moment_x / total;
+        com_y[node] = moment_y / total;
+    }
+}
+
+vec2 BarnesHutTree::acceleration_at_slot(int slot, float theta, float softening) const
+{
+    const float x = sorted_x[slot];
+    const float y = sorted_y[slot];
+    const float theta_squared = theta * theta;
+    const float softening_squared = softening * softening;
+    float ax = 0.0f, ay = 0.0f;
+    auto pull = [&](float source_mass, float dx, float dy)
+    {
+        float inverse_distance = 1.0f / std::sqrt(dx * dx + dy * dy + softening_squared);
+        float strength = source_mass * inverse_distance * inverse_distance * inverse_distance;
+        ax += dx * strength;
+        ay += dy * strength;
+    };
+
+    const int count = int(num_nodes());
+    for (int node = 0; node < count;)
+    {
+        if (mass[node] <= 0.0f)
+        {
+            node = next[node];
+            continue;
+        }
+        if (leaf[node])
+        {
+            for (int s = body_begin[node]; s < body_end[node]; ++s)
+                if (s != slot)
+                    pull(sorted_mass[s], sorted_x[s] - x, sorted_y[s] - y);
+            node = next[node];
+            continue;
+        }
+        float dx = com_x[node] - x;
+        float dy = com_y[node] - y;
+        float size = 2.0f * half_size[node];
+        bool inside = std::fabs(x - center_x[node]) <= half_size[node] && std::fabs(y - center_y[node]) <= half_size[node];
+        if (!inside && size * size < theta_squared * (dx * dx + dy * dy))
+        {
+            pull(mass[node], dx, dy);
+            node = next[node];
+        }
+        else
+        {
+            node = node + 1; // open: first child
+        }
+    }
+    return vec2(ax, ay);
+}
+
+void BarnesHutTree::group_accelerations(int group_index, float theta, float softening, InteractionList &list, float *ax, float *ay) const
+{
+    const int target = groups[group_index];
+    const int begin = body_begin[target];
+    const int end = body_end[target];
+    const float theta_squared = theta * theta;
+    const float softening_squared = softening * softening;
+
+    // Tight bounding box of the group's bodies
+    float box_min_x = sorted_x[begin], box_max_x = sorted_x[begin];
+    float box_min_y = sorted_y[begin], box_max_y = sorted_y[begin];
+    for (int s = begin + 1; s < end; ++s)
+    {
+        box_min_x = std::min(box_min_x, sorted_x[s]);
+        box_max_x = std::max(box_max_x, sorted_x[s]);
+        box_min_y = std::min(box_min_y, sorted_y[s]);
+        box_max_y = std::max(box_max_y, sorted_y[s]);
+    }
+
+    // 1. Interaction list: the group's own bodies, accepted cells and the
+    //    bodies of opened leaves
+    list.mass.assign(sorted_mass.begin() + begin, sorted_mass.begin() + end);
+    list.x.assign(sorted_x.begin() + begin, sorted_x.begin() + end);
+    list.y.assign(sorted_y.begin() + begin, sorted_y.begin() + end);
+    auto push = [&](float m, float x, float y)
+    {
+        list.mass.push_back(m);
+        list.x.push_back(x);
+        list.y.push_back(y);
+    };
+    const int count = int(num_nodes());
+    for (int node = 0; node < count;)
+    {
+        if (mass[node] <= 0.0f || node == target)
+        {
+            node = next[node];
+            continue;
+        }
+        if (leaf[node])
+        {
+            for (int s = body_begin[node]; s < body_end[node]; ++s)
+                push(sorted_mass[s], sorted_x[s], sorted_y[s]);
+            node = next[node];
+            continue;
+        }
+        // Distance from the center of mass to the nearest point of the box
+        float dx = std::max(std::max(box_min_x - com_x[node], com_x[node] - box_max_x), 0.0f);
+        float dy = std::max(std::max(box_min_y - com_y[node], com_y[node] - box_max_y), 0.0f);
+        float size = 2.0f * half_size[node];
+        if (size * size < theta_squared * (dx * dx + dy * dy))
+        {
+            push(mass[node], com_x[node], com_y[node]);
+            node = next[node];
+        }
+        else
+        {
+            node = node + 1; // open: first child
+        }
+    }
+    // Pad to whole SIMD groups with massless entries far away
+    while (list.mass.size() % 4 != 0)
+        push(0.0f, 1e6f, 1e6f);
+
+    // 2. Sum the list for every body of the group. A body meets itself at
+    //    distance 0 (as do coincident bodies without softening): those terms
+    //    are dropped.
+    const size_t entries = list.mass.size();
+    const float *list_mass = list.mass.data();
+    const float *list_x = list.x.data();
+    const float *list_y = list.y.data();
+    for (int s = begin; s < end; ++s)
+    {
+        const float x = sorted_x[s];
+        const float y = sorted_y[s];
+#if defined(__SSE2__)
+        const __m128 px = _mm_set1_ps(x);
+        const __m128 py = _mm_set1_ps(y);
+        const __m128 eps = _mm_set1_ps(softening_squared);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128 acc_x = zero;
+        __m128 acc_y = zero;
+        for (size_t k = 0; k < entries; k += 4)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(list_x + k), px);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(list_y + k), py);
+            __m128 distance_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), eps);
+            __m128 inverse_distance = _mm_and_ps(_mm_cmpgt_ps(distance_squared, zero), _mm_div_ps(one, _mm_sqrt_ps(distance_squared)));
+            __m128 strength = _mm_mul_ps(_mm_loadu_ps(list_mass + k), _mm_mul_ps(inverse_distance, _mm_mul_ps(inverse_distance, inverse_distance)));
+            acc_x = _mm_add_ps(acc_x, _mm_mul_ps(dx, strength));
+            acc_y = _mm_add_ps(acc_y, _mm_mul_ps(dy, strength));
+        }
+        alignas(16) float lanes_x[4], lanes_y[4];
+        _mm_store_ps(lanes_x, acc_x);
+        _mm_store_ps(lanes_y, acc_y);
+        ax[s] = (lanes_x[0] + lanes_x[1]) + (lanes_x[2] + lanes_x[3]);
+        ay[s] = (lanes_y[0] + lanes_y[1]) + (lanes_y[2] + lanes_y[3]);
+#else
+        float sum_x = 0.0f, sum_y = 0.0f;
+        for (size_t k = 0; k < entries; ++k)
+        {
+            float dx = list_x[k] - x;
+            float dy = list_y[k] - y;
+            float distance_squared = dx * dx + dy * dy + softening_squared;
+            if (distance_squared <= 0.0f)
+                continue;
+            float inverse_distance = 1.0f / std::sqrt(distance_squared);
+            float strength = list_mass[k] * inverse_distance * inverse_distance * inverse_distance;
+            sum_x += dx * strength;
+            sum_y += dy * strength;
+        }
+        ax[s] = sum_x;
+        ay[s] = sum_y;
+#endif
+    }
+}
+
+vec2 BarnesHutTree::direct_acceleration_at_slot(int slot, float softening) const
+{
+    const float softening_squared = softening * softening;
+    float ax = 0.0f, ay = 0.0f;
+    for (size_t s = 0; s < sorted_x.size(); ++s)
+    {
+        if (int(s) == slot)
+            continue;
+        float dx = sorted_x[s] - sorted_x[slot];
+        float dy = sorted_y[s] - sorted_y[slot];
+        float inverse_distance = 1.0f / std::sqrt(dx * dx + dy * dy + softening_squared);
+        float strength = sorted_mass[s] * inverse_distance * inverse_distance * inverse_distance;
+        ax += dx * strength;
+        ay += dy * strength;
+    }
+    return vec2(ax, ay);
+}
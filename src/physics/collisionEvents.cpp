@@ -0,0 +1,28 @@
+#include "physics/collisionEvents.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+
+void CollisionEventStream::sort()
+{
+    std::sort(step_events.begin(), step_events.end(), [](const CollisionEvent &a, const CollisionEvent &b)
+    {
+        if (a.body_A != b.body_A)
+            return a.body_A < b.body_A;
+        if (a.body_B != b.body_B)
+            return a.body_B < b.body_B;
+        return a.type < b.type;
+    });
+}
+
+void CollisionEventStream::filter(const world &simulation_world, const CollisionEventFilter &filter, std::vector<CollisionEvent> &out) const
+{
+    for (const auto &event : step_events)
+    {
+        if (event.impulse < filter.min_impulse)
+            continue;
+        uint32_t layers = simulation_world.get_collision_category(event.body_A) | simulation_world.get_collision_category(event.body_B);
+        if ((layers & filter.layer_mask) == 0)
+            continue;
+        out.push_back(event);
+    }
+}
@@ -0,0 +1,117 @@
+#include "physics/constraints.hpp"
+#include <algorithm>
+
+int ConstraintSet::add_distance(int a, int b, float length)
+{
+    return add_spring(a, b, length, 1.0f);
+}
+
+int ConstraintSet::add_spring(int a, int b, float length, float k, float alpha)
+{
+    body_a.push_back(a);
+    body_b.push_back(b);
+    rest_length.push_back(length);
+    stiffness.push_back(std::min(std::max(k, 0.0f), 1.0f));
+    compliance.push_back(std::max(alpha, 0.0f));
+    dirty = true;
+    return int(body_a.size()) - 1;
+}
+
+int ConstraintSet::add_pin(int body, const vec2 &anchor)
+{
+    pin_body.push_back(body);
+    pin_x.push_back(anchor.x);
+    pin_y.push_back(anchor.y);
+    return int(pin_body.size()) - 1;
+}
+
+void ConstraintSet::clear()
+{
+    body_a.clear();
+    body_b.clear();
+    rest_length.clear();
+    stiffness.clear();
+    compliance.clear();
+    pin_body.clear();
+    pin_x.clear();
+    pin_y.clear();
+    color_start.clear();
+    colored_rows.clear();
+    dirty = false;
+}
+
+void ConstraintSet::update_colors(size_t num_bodies)
+{
+    if (!dirty && colored_bodies == num_bodies)
+        return;
+
+    // Greedy colouring in rounds: each round sweeps the remaining rows and takes
+    // every row whose bodies are still free in this round.
+    std::vector<int> body_round(num_bodies, -1);
+    // Rows naming a body that does not exist are left uncoloured (never solved)
+    std::vector<int> remaining;
+    remaining.reserve(body_a.size());
+    for (size_t r = 0; r < body_a.size(); ++r)
+        if (body_a[r] >= 0 && size_t(body_a[r]) < num_bodies && body_b[r] >= 0 && size_t(body_b[r]) < num_bodies)
+            remaining.push_back(int(r));
+
+    color_start.assign(1, 0);
+    colored_rows.clear();
+    colored_rows.reserve(body_a.size());
+    for (int round = 0; !remaining.empty(); ++round)
+    {
+        size_t kept = 0;
+        for (int r : remaining)
+        {
+            int a = body_a[r], b = body_b[r];
+            if (body_round[a] == round || body_round[b] == round)
+            {
+                remaining[kept++] = r;
+                continue;
+            }
+            body_round[a] = round;
+            body_round[b] = round;
+            colored_rows.push_back(r);
+        }
+        remaining.resize(kept);
+        color_start.push_back(int(colored_rows.size()));
+    }
+    colored_bodies = num_bodies;
+    dirty = false;
+}
+
+void ConstraintSet::on_body_removed(int removed, int moved)
+{
+    size_t kept = 0;
+    for (size_t r = 0; r < body_a.size(); ++r)
+    {
+        if (body_a[r] == removed || body_b[r] == removed)
+            continue;
+        body_a[kept] = body_a[r] == moved ? removed : body_a[r];
+        body_b[kept] = body_b[r] == moved ? removed : body_b[r];
+        rest_length[kept] = rest_length[r];
+        stiffness[kept] = stiffness[r];
+        compliance[kept] = compliance[r];
+        ++kept;
+    }
+    body_a.resize(kept);
+    body_b.resize(kept);
+    rest_length.resize(kept);
+    stiffness.resize(kept);
+    compliance.resize(kept);
+
+    kept = 0;
+    for (size_t p = 0; p < pin_body.size(); ++p)
+    {
+        if (pin_body[p] == removed)
+            continue;
+        pin_body[kept] = pin_body[p] == moved ? removed : pin_body[p];
+        pin_x[kept] = pin_x[p];
+        pin_y[kept] = pin_y[p];
+        ++kept;
+    }
+    pin_body.resize(kept);
+    pin_x.resize(kept);
+    pin_y.resize(kept);
+    dirty = true;
+}
@@ -0,0 +1,193 @@
+#include "physics/contactCache.hpp"
+#include <algorithm>
+#include <utility>
+
+const size_t CONTACT_CACHE_MIN_CAPACITY = 64; // Power of two
+
+const ContactCacheEntry ContactCache::EMPTY_ENTRY = []
+{
+    ContactCacheEntry entry;
+    entry.key = EMPTY_KEY;
+    return entry;
+}();
+
+size_t ContactCache::probe_start(uint64_t key) const
+{
+    // 64-bit mix (splitmix64 finalizer) so neighbouring indices spread out
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return size_t(key) & (slots.size() - 1);
+}
+
+ContactCacheEntry &ContactCache::record(const ContactManifold &manifold)
+{
+    apply_removals();
+    // Keep the load factor at or below 1/2
+    if (slots.empty() || (count + 1) * 2 > slots.size())
+        rehash(slots.empty() ? CONTACT_CACHE_MIN_CAPACITY : slots.size() * 2);
+
+    uint64_t key = make_key(manifold.body_A, manifold.body_B);
+    size_t mask = slots.size() - 1;
+    size_t i = probe_start(key);
+    while (slots[i].key != EMPTY_KEY && slots[i].key != key)
+        i = (i + 1) & mask;
+
+    ContactCacheEntry &entry = slots[i];
+    if (entry.key == EMPTY_KEY)
+    {
+        entry.key = key;
+        entry.first_frame = frame;
+        entry.previous_impulse = 0.0f;
+        ++count;
+    }
+    else
+    {
+        // A contact that lapsed for a few frames begins again
+        if (entry.last_frame + 1 < frame)
+            entry.first_frame = frame;
+        entry.previous_impulse = entry.last_frame + 1 == frame ? entry.manifold.normal_impulse : 0.0f;
+    }
+    // Stored with body_A < body_B (the key's order), the normal still from A to B
+    entry.manifold = manifold;
+    if (manifold.body_A > manifold.body_B)
+    {
+        entry.manifold.body_A = manifold.body_B;
+        entry.manifold.body_B = manifold.body_A;
+        entry.manifold.normal_direction = manifold.normal_direction * -1.0f;
+    }
+    entry.last_frame = frame;
+    return entry;
+}
+
+const ContactCacheEntry *ContactCache::find(int idxA, int idxB) const
+{
+    apply_removals();
+    if (slots.empty())
+        return nullptr;
+    uint64_t key = make_key(idxA, idxB);
+    size_t mask = slots.size() - 1;
+    for (size_t i = probe_start(key); slots[i].key != EMPTY_KEY; i = (i + 1) & mask)
+    {
+        if (slots[i].key == key)
+            return &slots[i];
+    }
+    return nullptr;
+}
+
+void ContactCache::evict_stale()
+{
+    apply_removals();
+    // Re-inserting the survivors compacts the probe chains (no tombstones).
+    size_t survivors = 0;
+    for (const auto &slot : slots)
+        if (slot.key != EMPTY_KEY && frame - slot.last_frame <= max_age_frames)
+            ++survivors;
+    if (survivors == count)
+        return;
+
+    scratch.swap(slots);
+    slots.assign(scratch.size(), EMPTY_ENTRY);
+    count = 0;
+    size_t mask = slots.size() - 1;
+    for (const auto &old : scratch)
+    {
+        if (old.key == EMPTY_KEY || frame - old.last_frame > max_age_frames)
+            continue;
+        size_t i = probe_start(old.key);
+        while (slots[i].key != EMPTY_KEY)
+            i = (i + 1) & mask;
+        slots[i] = old;
+        ++count;
+    }
+}
+
+void ContactCache::clear()
+{
+    slots.assign(slots.size(), EMPTY_ENTRY);
+    count = 0;
+    current_of.clear();
+    original_at.clear();
+}
+
+void ContactCache::on_body_removed(int idx, int last)
+{
+    if (count == 0 || idx < 0 || last < idx)
+        return;
+    if (original_at.empty())
+    {
+        // First removal of a run: start from the identity over [0, last]
+        original_at.resize(size_t(last) + 1);
+        current_of.resize(size_t(last) + 1);
+        for (int i = 0; i <= last; ++i)
+            original_at[i] = current_of[i] = i;
+    }
+    // Bodies added since the run began have no entries; give them fresh ids
+    while (original_at.size() < size_t(last) + 1)
+    {
+        original_at.push_back(int(current_of.size()));
+        current_of.push_back(int(original_at.size()) - 1);
+    }
+    if (original_at.size() != size_t(last) + 1)
+    {
+        clear(); // Bodies went away unreported: the keys can't be trusted
+        return;
+    }
+    int removed = original_at[idx];
+    int moved = original_at[last];
+    current_of[removed] = -1;
+    current_of[moved] = idx;
+    original_at[idx] = moved;
+    original_at.pop_back();
+}
+
+void ContactCache::apply_removals() const
+{
+    if (original_at.empty())
+        return;
+    scratch.swap(slots);
+    slots.assign(scratch.size(), EMPTY_ENTRY);
+    count = 0;
+    size_t mask = slots.size() - 1;
+    for (auto entry : scratch)
+    {
+        if (entry.key == EMPTY_KEY)
+            continue;
+        uint32_t a = uint32_t(entry.key >> 32), b = uint32_t(entry.key);
+        int new_a = a < current_of.size() ? current_of[a] : -1;
+        int new_b = b < current_of.size() ? current_of[b] : -1;
+        if (new_a < 0 || new_b < 0)
+            continue; // A body of the pair was removed
+        entry.key = make_key(new_a, new_b);
+        // Keep idxA < idxB, with the normal still pointing from A to B
+        if (new_a > new_b)
+            entry.manifold.normal_direction = entry.manifold.normal_direction * -1.0f;
+        entry.manifold.body_A = std::min(new_a, new_b);
+        entry.manifold.body_B = std::max(new_a, new_b);
+        size_t i = probe_start(entry.key);
+        while (slots[i].key != EMPTY_KEY)
+            i = (i + 1) & mask;
+        slots[i] = entry;
+        ++count;
+    }
+    current_of.clear();
+    original_at.clear();
+}
+
+void ContactCache::rehash(size_t new_capacity)
+{
+    scratch.swap(slots);
+    slots.assign(new_capacity, EMPTY_ENTRY);
+    count = 0;
+    size_t mask = new_capacity - 1;
+    for (const auto &old : scratch)
+    {
+        if (old.key == EMPTY_KEY)
+            continue;
+        size_t i = probe_start(old.key);
+        while (slots[i].key != EMPTY_KEY)
+            i = (i + 1) & mask;
+        slots[i] = old;
+        ++count;
+    }
+}
@@ -0,0 +1,168 @@
+#include "physics/forceFields.hpp"
+#include "physics/world.hpp"
+#include <cmath>
+
+int ForceFieldSet::add_field(ForceFieldType field_type, const vec2 &center, float half_x, float half_y, float field_strength, const vec2 &direction)
+{
+    type.push_back(field_type);
+    center_x.push_back(center.x);
+    center_y.push_back(center.y);
+    extent_x.push_back(std::fabs(half_x));
+    extent_y.push_back(std::fabs(half_y));
+    strength.push_back(field_strength);
+    direction_x.push_back(direction.x);
+    direction_y.push_back(direction.y);
+    dirty = true;
+    return int(type.size()) - 1;
+}
+
+int ForceFieldSet::add_gravity_well(const vec2 &center, float radius, float well_strength)
+{
+    return add_field(ForceFieldType::GravityWell, center, radius, radius, well_strength, vec2(0.0f, 0.0f));
+}
+
+int ForceFieldSet::add_wind(const vec2 &min, const vec2 &max, const vec2 &acceleration)
+{
+    vec2 center((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f);
+    return add_field(ForceFieldType::Wind, center, (max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, 1.0f, acceleration);
+}
+
+int ForceFieldSet::add_radial_impulse(const vec2 &center, float radius, float speed)
+{
+    return add_field(ForceFieldType::RadialImpulse, center, radius, radius, speed, vec2(0.0f, 0.0f));
+}
+
+void ForceFieldSet::set_center(int field, const vec2 &center)
+{
+    if (field < 0 || size_t(field) >= size())
+        return;
+    center_x[field] = center.x;
+    center_y[field] = center.y;
+    dirty = true;
+}
+
+void ForceFieldSet::clear()
+{
+    type.clear();
+    center_x.clear();
+    center_y.clear();
+    extent_x.clear();
+    extent_y.clear();
+    strength.clear();
+    direction_x.clear();
+    direction_y.clear();
+    cell_fields.clear();
+    std::fill(cell_start.begin(), cell_start.end(), 0);
+    dirty = false;
+}
+
+void ForceFieldSet::remove_impulses()
+{
+    size_t kept = 0;
+    for (size_t f = 0; f < size(); ++f)
+    {
+        if (type[f] == ForceFieldType::RadialImpulse)
+            continue;
+        type[kept] = type[f];
+        center_x[kept] = center_x[f];
+        center_y[kept] = center_y[f];
+        extent_x[kept] = extent_x[f];
+        extent_y[kept] = extent_y[f];
+        strength[kept] = strength[f];
+        direction_x[kept] = direction_x[f];
+        direction_y[kept] = direction_y[f];
+        ++kept;
+    }
+    if (kept == size())
+        return;
+    type.resize(kept);
+    center_x.resize(kept);
+    center_y.resize(kept);
+    extent_x.resize(kept);
+    extent_y.resize(kept);
+    strength.resize(kept);
+    direction_x.resize(kept);
+    direction_y.resize(kept);
+    dirty = true;
+}
+
+void ForceFieldSet::bake(const GridInfo &grid)
+{
+    grid_min_x = grid.min_x;
+    grid_min_y = grid.min_y;
+    cell_size = grid.cell_size;
+    num_cells_x = std::max(1, grid.num_cells_x);
+    num_cells_y = std::max(1, grid.num_cells_y);
+    int num_cells = num_cells_x * num_cells_y;
+
+    size_t n = size();
+    std::vector<int> x0(n), x1(n), y0(n), y1(n);
+    for (size_t f = 0; f < n; ++f)
+    {
+        x0[f] = cell_x(center_x[f] - extent_x[f]);
+        x1[f] = cell_x(center_x[f] + extent_x[f]);
+        y0[f] = cell_y(center_y[f] - extent_y[f]);
+        y1[f] = cell_y(center_y[f] + extent_y[f]);
+    }
+
+    // Counting sort of (cell, field) entries into CSR
+    cell_start.assign(num_cells + 1, 0);
+    for (size_t f = 0; f < n; ++f)
+        for (int y = y0[f]; y <= y1[f]; ++y)
+            for (int x = x0[f]; x <= x1[f]; ++x)
+                ++cell_start[y * num_cells_x + x + 1];
+    for (int c = 0; c < num_cells; ++c)
+        cell_start[c + 1] += cell_start[c];
+    cell_fields.resize(cell_start[num_cells]);
+    std::vector<int> cursor(cell_start.begin(), cell_start.end() - 1);
+    for (size_t f = 0; f < n; ++f)
+        for (int y = y0[f]; y <= y1[f]; ++y)
+            for (int x = x0[f]; x <= x1[f]; ++x)
+                cell_fields[cursor[y * num_cells_x + x]++] = int(f);
+
+    dirty = false;
+}
+
+vec2 ForceFieldSet::field_acceleration(int field, float x, float y, float delta_time) const
+{
+    float dx = x - center_x[field];
+    float dy = y - center_y[field];
+    switch (type[field])
+    {
+    case ForceFieldType::Wind:
+        if (std::fabs(dx) > extent_x[field] || std::fabs(dy) > extent_y[field])
+            return vec2(0.0f, 0.0f);
+        return vec2(direction_x[field], direction_y[field]);
+
+    case ForceFieldType::GravityWell:
+    case ForceFieldType::RadialImpulse:
+    {
+        float radius = extent_x[field];
+        float distance = std::sqrt(dx * dx + dy * dy);
+        if (distance >= radius || distance <= 1e-6f)
+            return vec2(0.0f, 0.0f);
+        float magnitude = strength[field] * (1.0f - distance / radius) / distance;
+        if (type[field] == ForceFieldType::GravityWell)
+            return vec2(-dx * magnitude, -dy * magnitude);
+        if (delta_time <= 0.0f)
+            return vec2(0.0f, 0.0f);
+        return vec2(dx * magnitude / delta_time, dy * magnitude / delta_time);
+    }
+    }
+    return vec2(0.0f, 0.0f);
+}
+
+vec2 ForceFieldSet::acceleration_at(float x, float y, float delta_time) const
+{
+    vec2 total(0.0f, 0.0f);
+    if (num_cells_x == 0 || num_cells_y == 0)
+        return total;
+    int c = cell_y(y) * num_cells_x + cell_x(x);
+    for (int k = cell_start[c]; k < cell_start[c + 1]; ++k)
+    {
+        vec2 a = field_acceleration(cell_fields[k], x, y, delta_time);
+        total.x += a.x;
+        total.y += a.y;
+    }
+    return total;
+}
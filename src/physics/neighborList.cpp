@@ -0,0 +1,72 @@
+#include "physics/neighborList.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+
+bool NeighborList::needs_rebuild(const world &simulation_world, float skin) const
+{
+    size_t n = simulation_world.position_x.size();
+    if (!valid || reference_x.size() != n || skin != built_skin)
+        return true;
+
+    const GridInfo &grid = simulation_world.grid_info;
+    float limit_squared = 0.25f * skin * skin;
+    for (size_t i = 0; i < n; ++i)
+    {
+        float dx = grid.minimum_image_x(simulation_world.position_x[i] - reference_x[i]);
+        float dy = grid.minimum_image_y(simulation_world.position_y[i] - reference_y[i]);
+        if (dx * dx + dy * dy > limit_squared)
+            return true;
+    }
+    return false;
+}
+
+void NeighborList::build(const world &simulation_world, const std::pair<int, int> *pairs, size_t count, float skin)
+{
+    size_t n = simulation_world.position_x.size();
+    const GridInfo &grid = simulation_world.grid_info;
+    const float *px = simulation_world.position_x.data();
+    const float *py = simulation_world.position_y.data();
+    const float *radius = simulation_world.radius.data();
+
+    auto within_skin = [&](int a, int b)
+    {
+        float dx = grid.minimum_image_x(px[b] - px[a]);
+        float dy = grid.minimum_image_y(py[b] - py[a]);
+        float reach = radius[a] + radius[b] + skin;
+        return dx * dx + dy * dy <= reach * reach;
+    };
+
+    // Counting sort of the kept pairs by their first body into CSR
+    start.assign(n + 1, 0);
+    for (size_t p = 0; p < count; ++p)
+        if (within_skin(pairs[p].first, pairs[p].second))
+            ++start[pairs[p].first + 1];
+    for (size_t i = 0; i < n; ++i)
+        start[i + 1] += start[i];
+    neighbors.resize(start[n]);
+    std::vector<int> cursor(start.begin(), start.end() - 1);
+    for (size_t p = 0; p < count; ++p)
+        if (within_skin(pairs[p].first, pairs[p].second))
+            neighbors[cursor[pairs[p].first]++] = pairs[p].second;
+
+    reference_x.assign(px, px + n);
+    reference_y.assign(py, py + n);
+    built_skin = skin;
+    valid = true;
+    ++rebuild_count;
+}
+
+bool NeighborList::contains(int a, int b) const
+{
+    if (!valid)
+        return false;
+    for (int i : {a, b})
+    {
+        int other = i == a ? b : a;
+        if (i < 0 || size_t(i) + 1 >= start.size())
+            continue;
+        if (std::find(neighbors.begin() + start[i], neighbors.begin() + start[i + 1], other) != neighbors.begin() + start[i + 1])
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,132 @@
+#include "physics/rollbackBuffer.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+#include <cstring>
+
+RollbackBuffer::RollbackBuffer(size_t capacity, bool track_dirty_blocks)
+    : slots(std::max<size_t>(capacity, 1)), track_dirty(track_dirty_blocks)
+{
+}
+
+// Mutable columns in slot order
+static const float *column_data(const world &w, int c)
+{
+    switch (c)
+    {
+    case 0:
+        return w.position_x.data();
+    case 1:
+        return w.position_y.data();
+    case 2:
+        return w.previous_position_x.data();
+    case 3:
+        return w.previous_position_y.data();
+    case 4:
+        return w.vel_x.data();
+    default:
+        return w.vel_y.data();
+    }
+}
+
+static float *column_data(world &w, int c)
+{
+    return const_cast<float *>(column_data(static_cast<const world &>(w), c));
+}
+
+void RollbackBuffer::save(const world &world, uint64_t frame)
+{
+    if (count > 0 && frame <= newest)
+    {
+        // Rolled back: forget this frame and the ones after it
+        uint64_t dropped = newest - frame + 1;
+        count = dropped >= count ? 0 : count - size_t(dropped);
+        newest = frame - 1;
+    }
+    else if (count > 0 && frame > newest + 1)
+        count = 0; // A gap: the held frames are no longer consecutive
+    const Slot *previous = (count > 0 && newest + 1 == frame) ? &slot_of(newest) : nullptr;
+    Slot &slot = slots[frame % slots.size()];
+    const size_t n = world.size();
+    slot.frame = frame;
+    slot.bodies = n;
+    slot.data.resize(n * COLUMNS);
+
+    const size_t blocks = (n + DIRTY_BLOCK_BODIES - 1) / DIRTY_BLOCK_BODIES;
+    if (track_dirty)
+        slot.dirty_block.assign(blocks, previous && previous->bodies == n ? 0 : 1);
+    for (int c = 0; c < COLUMNS; ++c)
+    {
+        const float *source = column_data(world, c);
+        float *target = slot.data.data() + size_t(c) * n;
+        if (track_dirty && previous && previous->bodies == n)
+        {
+            const float *before = previous->data.data() + size_t(c) * n;
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                size_t first = b * DIRTY_BLOCK_BODIES;
+                size_t bytes = (std::min(first + DIRTY_BLOCK_BODIES, n) - first) * sizeof(float);
+                if (!slot.dirty_block[b] && std::memcmp(source + first, before + first, bytes) != 0)
+                    slot.dirty_block[b] = 1;
+            }
+        }
+        if (n > 0)
+            std::memcpy(target, source, n * sizeof(float));
+    }
+
+    newest = frame;
+    count = std::min(count + 1, slots.size());
+}
+
+void RollbackBuffer::copy_to_world(const Slot &slot, world &world, size_t first_body, size_t last_body) const
+{
+    const size_t n = slot.bodies;
+    for (int c = 0; c < COLUMNS; ++c)
+        std::memcpy(column_data(world, c) + first_body, slot.data.data() + size_t(c) * n + first_body, (last_body - first_body) * sizeof(float));
+}
+
+bool RollbackBuffer::restore(world &world, uint64_t frame) const
+{
+    if (!holds(frame) || slot_of(frame).bodies != world.size())
+        return false;
+    const Slot &slot = slot_of(frame);
+    if (slot.bodies > 0)
+        copy_to_world(slot, world, 0, slot.bodies);
+    last_restored_blocks = (slot.bodies + DIRTY_BLOCK_BODIES - 1) / DIRTY_BLOCK_BODIES;
+
+    // Derived from positions: rebuilt on the next step
+    world.neighbor_list.invalidate();
+    if (world.incremental_grid)
+        world.grid_rebuild_required = true;
+    return true;
+}
+
+bool RollbackBuffer::restore_dirty(world &world, uint64_t frame) const
+{
+    if (!track_dirty)
+        return restore(world, frame);
+    if (!holds(frame) || slot_of(frame).bodies != world.size())
+        return false;
+    const Slot &slot = slot_of(frame);
+    const size_t blocks = slot.dirty_block.size();
+    last_restored_blocks = 0;
+    for (size_t b = 0; b < blocks; ++b)
+    {
+        // Changed in any save after the target frame?
+        bool changed = false;
+        for (uint64_t later = frame + 1; later <= newest && !changed; ++later)
+        {
+            const Slot &next = slot_of(later);
+            changed = next.bodies != slot.bodies || next.dirty_block[b];
+        }
+        if (!changed)
+            continue;
+        size_t first = b * DIRTY_BLOCK_BODIES;
+        copy_to_world(slot, world, first, std::min(first + DIRTY_BLOCK_BODIES, slot.bodies));
+        ++last_restored_blocks;
+    }
+
+    world.neighbor_list.invalidate();
+    if (world.incremental_grid)
+        world.grid_rebuild_required = true;
+    return true;
+}
@@ -0,0 +1,380 @@
+#include "physics/spatialQuery.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+spatialQuery::spatialQuery(const world &simulation_world_in, ThreadPool *pool_in)
+    : simulation_world(simulation_world_in), pool(pool_in)
+{
+    // Bodies are binned by center, so every search is padded by the largest radius.
+    for (float r : simulation_world.radius)
+        max_radius = std::max(max_radius, r);
+}
+
+// ====================================================================
+// --- GRID HELPERS ---
+// ====================================================================
+
+bool spatialQuery::grid_is_current() const
+{
+    // Same test as fluidSystem: bodies added or removed since the last
+    // collisionSystem update leave sorted_indices naming stale (or missing) bodies
+    const world &w = simulation_world;
+    return !w.grid_rebuild_required && w.particle_cell_id.size() == w.size() && !w.sorted_indices.empty() &&
+           w.particle_start_indices.size() == size_t(w.num_grid_cells()) + 1;
+}
+
+int spatialQuery::cell_x(float x) const
+{
+    const GridInfo &g = simulation_world.grid_info;
+    int cx = (int)std::floor((x - g.min_x) / g.cell_size);
+    return std::min(std::max(cx, 0), g.num_cells_x - 1);
+}
+
+int spatialQuery::cell_y(float y) const
+{
+    const GridInfo &g = simulation_world.grid_info;
+    int cy = (int)std::floor((y - g.min_y) / g.cell_size);
+    return std::min(std::max(cy, 0), g.num_cells_y - 1);
+}
+
+// Calls visit(body) for every indexed body whose center cell intersects the box.
+template <typename Visit>
+void spatialQuery::visit_cells(float min_x, float min_y, float max_x, float max_y, Visit &&visit) const
+{
+    const GridInfo &g = simulation_world.grid_info;
+    if (!grid_is_current() || max_x < g.min_x || max_y < g.min_y || min_x > g.max_x || min_y > g.max_y)
+        return;
+
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    const int *cell_bodies = simulation_world.sorted_indices.data();
+    int x0 = cell_x(min_x), x1 = cell_x(max_x);
+    int y0 = cell_y(min_y), y1 = cell_y(max_y);
+    for (int cy = y0; cy <= y1; ++cy)
+    {
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            int cell = cy * g.num_cells_x + cx;
+            for (int s = cell_start[cell]; s < cell_start[cell + 1]; ++s)
+                visit(cell_bodies[s]);
+        }
+    }
+}
+
+// ====================================================================
+// --- SINGLE QUERIES ---
+// ====================================================================
+
+void spatialQuery::query_aabb(const AABB &box, std::vector<int> &out) const
+{
+    const world &w = simulation_world;
+    float pad = max_radius;
+    visit_cells(box.min.x - pad, box.min.y - pad, box.max.x + pad, box.max.y + pad, [&](int i)
+    {
+        // Circle vs box: distance from the center to the closest point of the box
+        float px = w.position_x[i];
+        float py = w.position_y[i];
+        float dx = px - std::min(std::max(px, box.min.x), box.max.x);
+        float dy = py - std::min(std::max(py, box.min.y), box.max.y);
+        float r = w.radius[i];
+        if (dx * dx + dy * dy <= r * r)
+            out.push_back(i);
+    });
+}
+
+void spatialQuery::query_radius(const vec2 &center, float query_radius, std::vector<int> &out) const
+{
+    const world &w = simulation_world;
+    float pad = query_radius + max_radius;
+    visit_cells(center.x - pad, center.y - pad, center.x + pad, center.y + pad, [&](int i)
+    {
+        float dx = w.position_x[i] - center.x;
+        float dy = w.position_y[i] - center.y;
+        float reach = query_radius + w.radius[i];
+        if (dx * dx + dy * dy <= reach * reach)
+            out.push_back(i);
+    });
+}
+
+void spatialQuery::query_k_nearest(const vec2 &point, int k, std::vector<int> &out) const
+{
+    const world &w = simulation_world;
+    const GridInfo &g = simulation_world.grid_info;
+    if (k <= 0 || !grid_is_current())
+        return;
+
+    // Max-heap of the best k seen so far, ordered by (squared distance, body),
+    // kept in the tail of `out` so that no scratch memory is needed
+    const size_t base = out.size();
+    auto distance_squared = [&](int i)
+    {
+        float dx = w.position_x[i] - point.x;
+        float dy = w.position_y[i] - point.y;
+        return dx * dx + dy * dy;
+    };
+    auto closer = [&](int a, int b)
+    {
+        float da = distance_squared(a), db = distance_squared(b);
+        return da < db || (da == db && a < b);
+    };
+
+    const int *cell_start = w.particle_start_indices.data();
+    const int *cell_bodies = w.sorted_indices.data();
+    int cx = cell_x(point.x);
+    int cy = cell_y(point.y);
+    int max_ring = std::max(g.num_cells_x, g.num_cells_y);
+
+    // Visit square rings of cells around the point's cell. Every body in ring r + 1
+    // is at least r * cell_size away, which bounds when the search can stop.
+    for (int ring = 0; ring <= max_ring; ++ring)
+    {
+        if (int(out.size() - base) == k)
+        {
+            float bound = (ring - 1) * g.cell_size;
+            if (bound > 0.0f && bound * bound > distance_squared(out[base]))
+                break;
+        }
+        for (int y = cy - ring; y <= cy + ring; ++y)
+        {
+            if (y < 0 || y >= g.num_cells_y)
+                continue;
+            // Interior rows only contribute their two edge cells
+            int step = (y == cy - ring || y == cy + ring) ? 1 : std::max(1, 2 * ring);
+            for (int x = cx - ring; x <= cx + ring; x += step)
+            {
+                if (x < 0 || x >= g.num_cells_x)
+                    continue;
+                int cell = y * g.num_cells_x + x;
+                for (int s = cell_start[cell]; s < cell_start[cell + 1]; ++s)
+                {
+                    int i = cell_bodies[s];
+                    if (int(out.size() - base) < k)
+                    {
+                        out.push_back(i);
+                        std::push_heap(out.begin() + base, out.end(), closer);
+                    }
+                    else if (distance_squared(i) < distance_squared(out[base]))
+                    {
+                        std::pop_heap(out.begin() + base, out.end(), closer);
+                        out.back() = i;
+                        std::push_heap(out.begin() + base, out.end(), closer);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort_heap(out.begin() + base, out.end(), closer);
+}
+
+bool spatialQuery::raycast(const Ray &ray, RayHit &hit) const
+{
+    const world &w = simulation_world;
+    const GridInfo &g = simulation_world.grid_info;
+    hit.body = -1;
+
+    float len = std::sqrt(dot(ray.direction, ray.direction));
+    if (len <= 1e-12f || !grid_is_current())
+        return false;
+    vec2 d = ray.direction * (1.0f / len);
+
+    // Clip the segment against the grid bounds (slab test)
+    float t_enter = 0.0f;
+    float t_exit = ray.max_distance;
+    const float o[2] = {ray.origin.x, ray.origin.y};
+    const float dir[2] = {d.x, d.y};
+    const float lo[2] = {g.min_x, g.min_y};
+    const float hi[2] = {g.max_x, g.max_y};
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (std::fabs(dir[axis]) < 1e-12f)
+        {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis])
+                return false;
+            continue;
+        }
+        float t0 = (lo[axis] - o[axis]) / dir[axis];
+        float t1 = (hi[axis] - o[axis]) / dir[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        t_enter = std::max(t_enter, t0);
+        t_exit = std::min(t_exit, t1);
+    }
+    if (t_enter > t_exit)
+        return false;
+
+    // DDA setup (Amanatides & Woo) from the clipped entry point
+    vec2 start = ray.origin + d * t_enter;
+    int cx = cell_x(start.x);
+    int cy = cell_y(start.y);
+    int step_x = d.x > 0.0f ? 1 : -1;
+    int step_y = d.y > 0.0f ? 1 : -1;
+    float inf = std::numeric_limits<float>::infinity();
+    float t_delta_x = d.x != 0.0f ? g.cell_size / std::fabs(d.x) : inf;
+    float t_delta_y = d.y != 0.0f ? g.cell_size / std::fabs(d.y) : inf;
+    float next_bx = g.min_x + (cx + (step_x > 0 ? 1 : 0)) * g.cell_size;
+    float next_by = g.min_y + (cy + (step_y > 0 ? 1 : 0)) * g.cell_size;
+    float t_max_x = d.x != 0.0f ? t_enter + (next_bx - start.x) / d.x : inf;
+    float t_max_y = d.y != 0.0f ? t_enter + (next_by - start.y) / d.y : inf;
+
+    // A circle can overlap the ray while its center sits `reach` cells away,
+    // so each visited cell stands for the block of cells within `reach` of it.
+    int reach = (int)std::ceil(max_radius / g.cell_size);
+    const int *cell_start = w.particle_start_indices.data();
+    const int *cell_bodies = w.sorted_indices.data();
+    float best_t = inf;
+
+    auto test_cells = [&](int x0, int x1, int y0, int y1)
+    {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, g.num_cells_x - 1);
+        y1 = std::min(y1, g.num_cells_y - 1);
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                int cell = y * g.num_cells_x + x;
+                for (int s = cell_start[cell]; s < cell_start[cell + 1]; ++s)
+                {
+                    int i = cell_bodies[s];
+                    // Ray vs circle: |o + t d - c|^2 = r^2 with |d| = 1
+                    float mx = ray.origin.x - w.position_x[i];
+                    float my = ray.origin.y - w.position_y[i];
+                    float r = w.radius[i];
+                    float b = mx * d.x + my * d.y;
+                    float c = mx * mx + my * my - r * r;
+                    if (c > 0.0f && b > 0.0f)
+                        continue;
+                    float disc = b * b - c;
+                    if (disc < 0.0f)
+                        continue;
+                    float t = std::max(-b - std::sqrt(disc), 0.0f);
+                    if (t <= ray.max_distance && t < best_t)
+                    {
+                        best_t = t;
+                        hit.body = i;
+                    }
+                }
+            }
+        }
+    };
+
+    // First cell: its whole block. After each step only the leading
+    // column/row of the new block has not been tested yet.
+    test_cells(cx - reach, cx + reach, cy - reach, cy + reach);
+    for (;;)
+    {
+        float t_cell;
+        if (t_max_x < t_max_y)
+        {
+            t_cell = t_max_x;
+            t_max_x += t_delta_x;
+            cx += step_x;
+            if (t_cell > t_exit || t_cell > best_t)
+                break;
+            int col = cx + step_x * reach;
+            test_cells(col, col, cy - reach, cy + reach);
+        }
+        else
+        {
+            t_cell = t_max_y;
+            t_max_y += t_delta_y;
+            cy += step_y;
+            if (t_cell > t_exit || t_cell > best_t)
+                break;
+            int row = cy + step_y * reach;
+            test_cells(cx - reach, cx + reach, row, row);
+        }
+    }
+
+    if (hit.body < 0)
+        return false;
+
+    hit.distance = best_t;
+    hit.point = ray.origin + d * best_t;
+    vec2 n = hit.point - vec2(w.position_x[hit.body], w.position_y[hit.body]);
+    float n_len = std::sqrt(dot(n, n));
+    hit.normal = n_len > 1e-6f ? n * (1.0f / n_len) : d * -1.0f;
+    return true;
+}
+
+// ====================================================================
+// --- BATCHED QUERIES ---
+// ====================================================================
+
+// Each worker answers a contiguous range of queries into its own buffer;
+// the buffers are then stitched into CSR order.
+template <typename Query>
+void spatialQuery::run_batch(size_t count, QueryResults &results, Query &&query) const
+{
+    unsigned workers = pool ? pool->size() : 1;
+    if (results.worker_indices.size() < workers)
+        results.worker_indices.resize(workers);
+    results.counts.resize(count);
+    results.offsets.resize(count + 1);
+
+    auto answer_range = [&](size_t begin, size_t end, unsigned worker)
+    {
+        std::vector<int> &buffer = results.worker_indices[worker];
+        buffer.clear();
+        for (size_t q = begin; q < end; ++q)
+        {
+            size_t before = buffer.size();
+            query(q, buffer);
+            results.counts[q] = int(buffer.size() - before);
+        }
+    };
+    if (pool)
+        pool->parallel_for(count, answer_range);
+    else
+        answer_range(0, count, 0);
+
+    results.offsets[0] = 0;
+    for (size_t q = 0; q < count; ++q)
+        results.offsets[q + 1] = results.offsets[q] + results.counts[q];
+    results.indices.resize(results.offsets[count]);
+
+    // Worker ranges are contiguous and in order, so buffers concatenate directly
+    int *dst = results.indices.data();
+    for (unsigned wk = 0; wk < workers && wk < results.worker_indices.size(); ++wk)
+    {
+        std::vector<int> &buffer = results.worker_indices[wk];
+        dst = std::copy(buffer.begin(), buffer.end(), dst);
+        buffer.clear();
+    }
+}
+
+void spatialQuery::query_aabb_batch(const AABB *boxes, size_t count, QueryResults &results) const
+{
+    run_batch(count, results, [&](size_t q, std::vector<int> &out)
+    { query_aabb(boxes[q], out); });
+}
+
+void spatialQuery::query_radius_batch(const vec2 *centers, const float *radii, size_t count, QueryResults &results) const
+{
+    run_batch(count, results, [&](size_t q, std::vector<int> &out)
+    { query_radius(centers[q], radii[q], out); });
+}
+
+void spatialQuery::query_k_nearest_batch(const vec2 *points, size_t count, int k, QueryResults &results) const
+{
+    run_batch(count, results, [&](size_t q, std::vector<int> &out)
+    { query_k_nearest(points[q], k, out); });
+}
+
+void spatialQuery::raycast_batch(const Ray *rays, size_t count, RayHit *hits) const
+{
+    auto cast_range = [&](size_t begin, size_t end, unsigned)
+    {
+        for (size_t q = begin; q < end; ++q)
+            raycast(rays[q], hits[q]);
+    };
+    if (pool)
+        pool->parallel_for(count, cast_range);
+    else
+        cast_range(0, count, 0);
+}
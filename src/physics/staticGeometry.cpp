@@ -0,0 +1,209 @@
+#include "physics/staticGeometry.hpp"
+#include "physics/world.hpp"
+#include <cmath>
+#include <cfloat>
+
+int StaticGeometry::add_shape(StaticShapeType type, int vertex_count, float restitution, uint32_t category, uint32_t mask)
+{
+    shape_type.push_back(type);
+    shape_first.push_back(int(vertex_x.size()));
+    shape_vertex_count.push_back(vertex_count);
+    shape_restitution.push_back(restitution);
+    shape_category.push_back(category);
+    shape_mask.push_back(mask);
+    dirty = true;
+    return int(shape_type.size()) - 1;
+}
+
+int StaticGeometry::add_segment(const vec2 &a, const vec2 &b, float restitution, uint32_t category, uint32_t mask)
+{
+    int shape = add_shape(StaticShapeType::Segment, 2, restitution, category, mask);
+    for (const vec2 &v : {a, b})
+    {
+        vertex_x.push_back(v.x);
+        vertex_y.push_back(v.y);
+        edge_normal_x.push_back(0.0f);
+        edge_normal_y.push_back(0.0f);
+    }
+    return shape;
+}
+
+int StaticGeometry::add_polygon(const vec2 *vertices, int count, float restitution, uint32_t category, uint32_t mask)
+{
+    if (count < 3)
+        return -1;
+    float twice_area = 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const vec2 &p = vertices[i];
+        const vec2 &q = vertices[(i + 1) % count];
+        twice_area += p.x * q.y - q.x * p.y;
+    }
+    if (std::fabs(twice_area) <= FLT_EPSILON)
+        return -1;
+
+    int shape = add_shape(StaticShapeType::Polygon, count, restitution, category, mask);
+    bool clockwise = twice_area < 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const vec2 &v = vertices[clockwise ? count - 1 - i : i];
+        vertex_x.push_back(v.x);
+        vertex_y.push_back(v.y);
+    }
+    // Outward normals of a counter-clockwise polygon: edge (dx, dy) -> (dy, -dx)
+    int first = shape_first[shape];
+    for (int i = 0; i < count; ++i)
+    {
+        int a = first + i;
+        int b = first + (i + 1) % count;
+        float dx = vertex_x[b] - vertex_x[a];
+        float dy = vertex_y[b] - vertex_y[a];
+        float length = std::sqrt(dx * dx + dy * dy);
+        float inv_length = length > 0.0f ? 1.0f / length : 0.0f;
+        edge_normal_x.push_back(dy * inv_length);
+        edge_normal_y.push_back(-dx * inv_length);
+    }
+    return shape;
+}
+
+void StaticGeometry::clear()
+{
+    shape_type.clear();
+    shape_first.clear();
+    shape_vertex_count.clear();
+    shape_restitution.clear();
+    shape_category.clear();
+    shape_mask.clear();
+    vertex_x.clear();
+    vertex_y.clear();
+    edge_normal_x.clear();
+    edge_normal_y.clear();
+    cell_shapes.clear();
+    std::fill(cell_start.begin(), cell_start.end(), 0);
+    dirty = false;
+}
+
+void StaticGeometry::bake(const GridInfo &grid)
+{
+    grid_min_x = grid.min_x;
+    grid_min_y = grid.min_y;
+    cell_size = grid.cell_size;
+    num_cells_x = std::max(1, grid.num_cells_x);
+    num_cells_y = std::max(1, grid.num_cells_y);
+    int num_cells = num_cells_x * num_cells_y;
+
+    size_t n = size();
+    std::vector<int> shape_cell_max_x(n), shape_cell_max_y(n);
+    shape_cell_min_x.resize(n);
+    shape_cell_min_y.resize(n);
+    for (size_t s = 0; s < n; ++s)
+    {
+        int first = shape_first[s];
+        int last = first + shape_vertex_count[s];
+        float min_x = *std::min_element(vertex_x.begin() + first, vertex_x.begin() + last);
+        float max_x = *std::max_element(vertex_x.begin() + first, vertex_x.begin() + last);
+        float min_y = *std::min_element(vertex_y.begin() + first, vertex_y.begin() + last);
+        float max_y = *std::max_element(vertex_y.begin() + first, vertex_y.begin() + last);
+        shape_cell_min_x[s] = cell_x(min_x);
+        shape_cell_min_y[s] = cell_y(min_y);
+        shape_cell_max_x[s] = cell_x(max_x);
+        shape_cell_max_y[s] = cell_y(max_y);
+    }
+
+    // Counting sort of (cell, shape) entries into CSR
+    cell_start.assign(num_cells + 1, 0);
+    for (size_t s = 0; s < n; ++s)
+        for (int y = shape_cell_min_y[s]; y <= shape_cell_max_y[s]; ++y)
+            for (int x = shape_cell_min_x[s]; x <= shape_cell_max_x[s]; ++x)
+                ++cell_start[y * num_cells_x + x + 1];
+    for (int c = 0; c < num_cells; ++c)
+        cell_start[c + 1] += cell_start[c];
+    cell_shapes.resize(cell_start[num_cells]);
+    std::vector<int> cursor(cell_start.begin(), cell_start.end() - 1);
+    for (size_t s = 0; s < n; ++s)
+        for (int y = shape_cell_min_y[s]; y <= shape_cell_max_y[s]; ++y)
+            for (int x = shape_cell_min_x[s]; x <= shape_cell_max_x[s]; ++x)
+                cell_shapes[cursor[y * num_cells_x + x]++] = int(s);
+
+    dirty = false;
+}
+
+bool StaticGeometry::collide_circle(int shape, float cx, float cy, float radius, StaticContact &contact) const
+{
+    int first = shape_first[shape];
+    int count = shape_vertex_count[shape];
+    contact.shape = shape;
+
+    if (shape_type[shape] == StaticShapeType::Segment)
+    {
+        // Closest point on the segment to the center
+        float ax = vertex_x[first], ay = vertex_y[first];
+        float abx = vertex_x[first + 1] - ax, aby = vertex_y[first + 1] - ay;
+        float length_squared = abx * abx + aby * aby;
+        float t = length_squared > 0.0f ? ((cx - ax) * abx + (cy - ay) * aby) / length_squared : 0.0f;
+        t = std::min(std::max(t, 0.0f), 1.0f);
+        float dx = cx - (ax + abx * t);
+        float dy = cy - (ay + aby * t);
+        float distance_squared = dx * dx + dy * dy;
+        if (distance_squared > radius * radius)
+            return false;
+        float distance = std::sqrt(distance_squared);
+        if (distance > 1e-6f)
+            contact.normal = vec2(dx / distance, dy / distance);
+        else
+        {
+            // Center exactly on the segment: push out along its left normal
+            float length = std::sqrt(length_squared);
+            contact.normal = length > 0.0f ? vec2(-aby / length, abx / length) : vec2(0.0f, 1.0f);
+        }
+        contact.penetration_depth = radius - distance;
+        return true;
+    }
+
+    // Polygon: find the edge of maximum separation
+    float separation = -FLT_MAX;
+    int edge = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        int v = first + i;
+        float s = edge_normal_x[v] * (cx - vertex_x[v]) + edge_normal_y[v] * (cy - vertex_y[v]);
+        if (s > radius)
+            return false;
+        if (s > separation)
+        {
+            separation = s;
+            edge = i;
+        }
+    }
+
+    int v1 = first + edge;
+    int v2 = first + (edge + 1) % count;
+    vec2 face_normal(edge_normal_x[v1], edge_normal_y[v1]);
+    if (separation < FLT_EPSILON)
+    {
+        // Center inside the polygon: exit through the closest face
+        contact.normal = face_normal;
+        contact.penetration_depth = radius - separation;
+        return true;
+    }
+
+    // Center outside: the closest feature is a vertex or the interior of the face
+    float u1 = (cx - vertex_x[v1]) * (vertex_x[v2] - vertex_x[v1]) + (cy - vertex_y[v1]) * (vertex_y[v2] - vertex_y[v1]);
+    float u2 = (cx - vertex_x[v2]) * (vertex_x[v1] - vertex_x[v2]) + (cy - vertex_y[v2]) * (vertex_y[v1] - vertex_y[v2]);
+    int corner = u1 <= 0.0f ? v1 : (u2 <= 0.0f ? v2 : -1);
+    if (corner < 0)
+    {
+        contact.normal = face_normal;
+        contact.penetration_depth = radius - separation;
+        return true;
+    }
+    float dx = cx - vertex_x[corner];
+    float dy = cy - vertex_y[corner];
+    float distance_squared = dx * dx + dy * dy;
+    if (distance_squared > radius * radius)
+        return false;
+    float distance = std::sqrt(distance_squared);
+    contact.normal = distance > 1e-6f ? vec2(dx / distance, dy / distance) : face_normal;
+    contact.penetration_depth = radius - distance;
+    return true;
+}
@@ -2,12 +2,14 @@
 #include "physics/body.hpp"
 #include <utility>
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
 world::world() : gravity_x(0.0f),
                  gravity_y(-41.63f),
                  delta_time(1.0f / 60.0f)
 {
+    resize_grid();
 }
 
 world::world(
@@ -47,20 +49,10 @@ world::world(
       inv_mass(std::move(inv_mass_in)),
       radius(std::move(radius_in))
 {
+    base_acc_x = acc_x;
+    base_acc_y = acc_y;
 
-    float width = grid_info.max_x - grid_info.min_x;
-    float height = grid_info.max_y - grid_info.min_y;
-
-    int numCellsX = static_cast<int>(std::ceil(width / grid_info.cell_size));
-    int numCellsY = static_cast<int>(std::ceil(height / grid_info.cell_size));
-
-    grid_info.num_cells_x = numCellsX;
-    grid_info.num_cells_y = numCellsY;
-
-    int totalCells = numCellsX * numCellsY;
-    particle_start_indices.resize(totalCells);
-    grid.clear();
-    grid.resize(totalCells);
+    resize_grid();
 }
 
 // SoA constructor: accept position arrays (by copy). Other arrays can be populated later.
@@ -74,12 +66,16 @@ world::world(const std::vector<float> &position_x_in, const std::vector<float> &
     vel_y.resize(n);
     acc_x.resize(n);
     acc_y.resize(n);
+    base_acc_x.resize(n);
+    base_acc_y.resize(n);
     mass.resize(n);
     inv_mass.resize(n);
     radius.resize(n);
     damping.resize(n);
     friction.resize(n);
     restitution.resize(n);
+    collision_category.resize(n, 1u);
+    collision_mask.resize(n, ~0u);
 
     // initialize previous positions to current positions
     for (size_t i = 0; i < n; ++i)
@@ -88,19 +84,7 @@ world::world(const std::vector<float> &position_x_in, const std::vector<float> &
         previous_position_y[i] = position_y[i];
     }
 
-    float width = grid_info.max_x - grid_info.min_x;
-    float height = grid_info.max_y - grid_info.min_y;
-
-    int numCellsX = static_cast<int>(std::ceil(width / grid_info.cell_size));
-    int numCellsY = static_cast<int>(std::ceil(height / grid_info.cell_size));
-
-    grid_info.num_cells_x = numCellsX;
-    grid_info.num_cells_y = numCellsY;
-
-    int totalCells = numCellsX * numCellsY;
-    particle_start_indices.resize(totalCells);
-    grid.clear();
-    grid.resize(totalCells);
+    resize_grid();
 }
 
 void world::add_body(const body &b)
@@ -113,12 +97,33 @@ void world::add_body(const body &b)
     vel_y.push_back(b.velocity.y);
     acc_x.push_back(b.acceleration.x);
     acc_y.push_back(b.acceleration.y);
+    base_acc_x.push_back(b.acceleration.x);
+    base_acc_y.push_back(b.acceleration.y);
     mass.push_back(b.mass);
     inv_mass.push_back(b.inv_mass);
     radius.push_back(b.radius);
     damping.push_back(b.damping);
     friction.push_back(b.friction);
     restitution.push_back(b.restitution);
+    collision_category.push_back(b.collision_category);
+    collision_mask.push_back(b.collision_mask);
+    fluid.resize(position_x.size() - 1, 0);
+    fluid.push_back(0);
+    grid_rebuild_required = true;
+    neighbor_list.invalidate();
+}
+
+void world::begin_step()
+{
+    const bool accumulating = force_fields.size() > 0 || mutual_gravity || sph_fluid;
+    if (!accumulating && !accelerations_accumulated)
+        return;
+    const size_t n = position_x.size();
+    base_acc_x.resize(n, 0.0f);
+    base_acc_y.resize(n, 0.0f);
+    acc_x.assign(base_acc_x.begin(), base_acc_x.end());
+    acc_y.assign(base_acc_y.begin(), base_acc_y.end());
+    accelerations_accumulated = accumulating;
 }
 
 void world::remove_body(size_t idx)
@@ -126,34 +131,56 @@ void world::remove_body(size_t idx)
     if (idx >= position_x.size())
         return;
     // swap-remove to keep O(1)
+    ++bodies_removed;
     size_t last = position_x.size() - 1;
     if (idx != last)
     {
         position_x[idx] = position_x[last];
         position_y[idx] = position_y[last];
+        previous_position_x[idx] = previous_position_x[last];
+        previous_position_y[idx] = previous_position_y[last];
         vel_x[idx] = vel_x[last];
         vel_y[idx] = vel_y[last];
         acc_x[idx] = acc_x[last];
         acc_y[idx] = acc_y[last];
+        base_acc_x[idx] = base_acc_x[last];
+        base_acc_y[idx] = base_acc_y[last];
         mass[idx] = mass[last];
         inv_mass[idx] = inv_mass[last];
         radius[idx] = radius[last];
         damping[idx] = damping[last];
         friction[idx] = friction[last];
         restitution[idx] = restitution[last];
+        collision_category[idx] = collision_category[last];
+        collision_mask[idx] = collision_mask[last];
+        if (last < fluid.size())
+            fluid[idx] = fluid[last];
     }
     position_x.pop_back();
     position_y.pop_back();
+    previous_position_x.pop_back();
+    previous_position_y.pop_back();
     vel_x.pop_back();
     vel_y.pop_back();
     acc_x.pop_back();
     acc_y.pop_back();
+    base_acc_x.pop_back();
+    base_acc_y.pop_back();
     mass.pop_back();
     inv_mass.pop_back();
     radius.pop_back();
     damping.pop_back();
     friction.pop_back();
     restitution.pop_back();
+    collision_category.pop_back();
+    collision_mask.pop_back();
+    if (last < fluid.size())
+        fluid.pop_back();
+    grid_rebuild_required = true;
+    neighbor_list.invalidate();
+    // Cached contacts are keyed by index, and swap-removal renumbered a body.
+    contacts.on_body_removed(int(idx), int(last));
+    constraints.on_body_removed(int(idx), int(last));
 }
 
 vec2 world::get_position(size_t idx) const
@@ -191,6 +218,36 @@ float world::get_restitution(size_t idx) const
     return 1.0f;
 }
 
+uint32_t world::get_collision_category(size_t idx) const
+{
+    if (idx < collision_category.size())
+        return collision_category[idx];
+    return 1u;
+}
+
+uint32_t world::get_collision_mask(size_t idx) const
+{
+    if (idx < collision_mask.size())
+        return collision_mask[idx];
+    return ~0u;
+}
+
+bool world::layers_collide(size_t idxA, size_t idxB) const
+{
+    return (get_collision_category(idxA) & get_collision_mask(idxB)) != 0 &&
+           (get_collision_category(idxB) & get_collision_mask(idxA)) != 0;
+}
+
+void world::set_fluid(size_t idx, bool is_fluid)
+{
+    if (idx >= position_x.size())
+        return;
+    // Worlds built from SoA vectors start without the column
+    if (fluid.size() < position_x.size())
+        fluid.resize(position_x.size(), 0);
+    fluid[idx] = is_fluid ? 1 : 0;
+}
+
 float world::get_damping(size_t idx) const
 {
     if (idx < damping.size())
@@ -219,3 +276,50 @@ int world::get_grid_index(const vec2 &posicion) const
 
     return index;
 }
+
+void world::resize_grid()
+{
+    float width = grid_info.max_x - grid_info.min_x;
+    float height = grid_info.max_y - grid_info.min_y;
+
+    int numCellsX = std::max(1, static_cast<int>(std::ceil(width / grid_info.cell_size)));
+    int numCellsY = std::max(1, static_cast<int>(std::ceil(height / grid_info.cell_size)));
+
+    grid_info.num_cells_x = numCellsX;
+    grid_info.num_cells_y = numCellsY;
+
+    // A periodic extent must be whole cells so the wrapped neighbours are adjacent
+    if (grid_info.periodic_x)
+        grid_info.max_x = grid_info.min_x + numCellsX * grid_info.cell_size;
+    if (grid_info.periodic_y)
+        grid_info.max_y = grid_info.min_y + numCellsY * grid_info.cell_size;
+
+    // One extra entry so cell c always spans [start[c], start[c + 1]).
+    int totalCells = numCellsX * numCellsY;
+    particle_start_indices.assign(totalCells + 1, 0);
+    sorted_indices.clear();
+    grid_info.build_neighbor_table();
+    grid_rebuild_required = true;
+}
+
+void GridInfo::build_neighbor_table()
+{
+    int total = num_cells_x * num_cells_y;
+    cell_neighbors.assign(size_t(total) * NUM_NEIGHBORS, -1);
+    for (int c = 0; c < total; ++c)
+    {
+        int cx = c % num_cells_x;
+        int cy = c / num_cells_x;
+        for (int k = 0; k < NUM_NEIGHBORS; ++k)
+        {
+            int nx = cx + NEIGHBOR_OFFSETS[k][0];
+            int ny = cy + NEIGHBOR_OFFSETS[k][1];
+            if (wraps_x())
+                nx = (nx + num_cells_x) % num_cells_x;
+            if (wraps_y())
+                ny = (ny + num_cells_y) % num_cells_y;
+            if (nx >= 0 && nx < num_cells_x && ny >= 0 && ny < num_cells_y)
+                cell_neighbors[size_t(c) * NUM_NEIGHBORS + k] = ny * num_cells_x + nx;
+        }
+    }
+}
@@ -0,0 +1,227 @@
+#include "physics/worldBatch.hpp"
+#include "physics/world.hpp"
+#include "sim/contactResponse.hpp"
+#include "sim/integrators.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+int WorldBatch::add_world(const world &prototype)
+{
+    const size_t n = prototype.size();
+    if (body_start.empty())
+        body_start.push_back(0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        position_x.push_back(prototype.position_x[i]);
+        position_y.push_back(prototype.position_y[i]);
+        previous_position_x.push_back(prototype.previous_position_x[i]);
+        previous_position_y.push_back(prototype.previous_position_y[i]);
+        vel_x.push_back(prototype.vel_x[i]);
+        vel_y.push_back(prototype.vel_y[i]);
+        inv_mass.push_back(prototype.inv_mass[i]);
+        radius.push_back(prototype.radius[i]);
+        restitution.push_back(prototype.get_restitution(i));
+        sweep_order.push_back(int(i));
+    }
+    initial_position_x.insert(initial_position_x.end(), position_x.end() - n, position_x.end());
+    initial_position_y.insert(initial_position_y.end(), position_y.end() - n, position_y.end());
+    initial_previous_x.insert(initial_previous_x.end(), previous_position_x.end() - n, previous_position_x.end());
+    initial_previous_y.insert(initial_previous_y.end(), previous_position_y.end() - n, previous_position_y.end());
+    initial_vel_x.insert(initial_vel_x.end(), vel_x.end() - n, vel_x.end());
+    initial_vel_y.insert(initial_vel_y.end(), vel_y.end() - n, vel_y.end());
+
+    body_start.push_back(int(position_x.size()));
+    gravity_x.push_back(prototype.gravity_x);
+    gravity_y.push_back(prototype.gravity_y);
+    delta_time.push_back(prototype.delta_time);
+    global_damping.push_back(prototype.global_damping);
+    min_x.push_back(prototype.grid_info.min_x);
+    max_x.push_back(prototype.grid_info.max_x);
+    min_y.push_back(prototype.grid_info.min_y);
+    max_y.push_back(prototype.grid_info.max_y);
+    contact_count.push_back(0);
+    return int(num_worlds()) - 1;
+}
+
+void WorldBatch::reset_world(int world_index)
+{
+    if (world_index < 0 || size_t(world_index) >= num_worlds())
+        return;
+    const int begin = body_start[world_index];
+    const int end = body_start[world_index + 1];
+    std::copy(initial_position_x.begin() + begin, initial_position_x.begin() + end, position_x.begin() + begin);
+    std::copy(initial_position_y.begin() + begin, initial_position_y.begin() + end, position_y.begin() + begin);
+    std::copy(initial_previous_x.begin() + begin, initial_previous_x.begin() + end, previous_position_x.begin() + begin);
+    std::copy(initial_previous_y.begin() + begin, initial_previous_y.begin() + end, previous_position_y.begin() + begin);
+    std::copy(initial_vel_x.begin() + begin, initial_vel_x.begin() + end, vel_x.begin() + begin);
+    std::copy(initial_vel_y.begin() + begin, initial_vel_y.begin() + end, vel_y.begin() + begin);
+    // Fresh sweep order too, so the world replays exactly as it first ran
+    for (int i = begin; i < end; ++i)
+        sweep_order[i] = i - begin;
+    contact_count[world_index] = 0;
+}
+
+void WorldBatch::step(ThreadPool *pool)
+{
+    const size_t worlds = num_worlds();
+    auto step_range = [&](size_t begin, size_t end, unsigned)
+    {
+        for (size_t w = begin; w < end; ++w)
+            step_world(int(w));
+    };
+    if (pool && pool->size() > 1)
+        pool->parallel_for(worlds, step_range);
+    else
+        step_range(0, worlds, 0);
+}
+
+void WorldBatch::step_world(int world_index)
+{
+    if (delta_time[world_index] <= 0.0f)
+        return;
+    integrate_world(world_index);
+    collide_world(world_index);
+    clamp_world(world_index);
+}
+
+// ====================================================================
+// --- PER-WORLD KERNELS ---
+// ====================================================================
+
+void WorldBatch::integrate_world(int world_index)
+{
+    const float dt = delta_time[world_index];
+    IntegrationStep integration_step;
+    integration_step.dt = dt;
+    integration_step.dt_squared = dt * dt;
+    integration_step.half_inverse_dt = 0.5f * (1.0f / dt);
+    const float ax = gravity_x[world_index];
+    const float ay = gravity_y[world_index];
+    const bool damped = global_damping[world_index] > 0.0f;
+    const float factor = damped ? std::exp(-global_damping[world_index] * dt) : 1.0f;
+
+    for (int i = body_start[world_index]; i < body_start[world_index + 1]; ++i)
+    {
+        if (inv_mass[i] <= 0.0f)
+            continue; // static
+        VerletPolicy::advance(position_x[i], previous_position_x[i], vel_x[i], ax, integration_step);
+        VerletPolicy::advance(position_y[i], previous_position_y[i], vel_y[i], ay, integration_step);
+        if (damped)
+        {
+            VerletPolicy::decay(position_x[i], previous_position_x[i], vel_x[i], factor, integration_step);
+            VerletPolicy::decay(position_y[i], previous_position_y[i], vel_y[i], factor, integration_step);
+        }
+    }
+}
+
+void WorldBatch::collide_world(int world_index)
+{
+    const int base = body_start[world_index];
+    const int count = body_start[world_index + 1] - base;
+    const float dt = delta_time[world_index];
+    int *order = sweep_order.data() + base;
+    float *px = position_x.data() + base;
+    float *py = position_y.data() + base;
+    float *prev_x = previous_position_x.data() + base;
+    float *prev_y = previous_position_y.data() + base;
+    float *vx = vel_x.data() + base;
+    float *vy = vel_y.data() + base;
+    const float *im = inv_mass.data() + base;
+    const float *r = radius.data() + base;
+    const float *e = restitution.data() + base;
+
+    // 1. Insertion sort by min x: bodies barely move between steps, so this
+    //    is close to one pass
+    for (int a = 1; a < count; ++a)
+    {
+        int body = order[a];
+        float key = px[body] - r[body];
+        int b = a - 1;
+        for (; b >= 0 && px[order[b]] - r[order[b]] > key; --b)
+            order[b + 1] = order[b];
+        order[b + 1] = body;
+    }
+
+    // 2. Sweep: a body only meets the ones starting before its max x. Nothing
+    //    moves during the sweep, so the order it relies on stays sorted.
+    thread_local std::vector<std::pair<int, int>> pairs;
+    pairs.clear();
+    for (int a = 0; a < count; ++a)
+    {
+        const int i = order[a];
+        for (int b = a + 1; b < count; ++b)
+        {
+            const int j = order[b];
+            if (px[j] - r[j] > px[i] + r[i])
+                break;
+            float dx = px[j] - px[i];
+            float dy = py[j] - py[i];
+            float sum_of_radii = r[i] + r[j];
+            if (dx * dx + dy * dy < sum_of_radii * sum_of_radii)
+                pairs.emplace_back(i, j);
+        }
+    }
+
+    // 3. Resolve in sweep order, with collisionSystem's contact response
+    const ContactBodyColumns bodies{px, py, prev_x, prev_y, vx, vy, im, r};
+    const ContactWalls walls{min_x[world_index], max_x[world_index], min_y[world_index], max_y[world_index]};
+    uint32_t contacts = 0;
+    for (auto [i, j] : pairs)
+    {
+        float restitution = (e[i] + e[j]) * 0.5f;
+        if (resolve_circle_contact(bodies, i, j, px[j] - px[i], py[j] - py[i], restitution, dt, walls).in_contact)
+            ++contacts;
+    }
+    contact_count[world_index] = contacts;
+}
+
+void WorldBatch::clamp_world(int world_index)
+{
+    const float dt = delta_time[world_index];
+    const float wall_min_x = min_x[world_index], wall_max_x = max_x[world_index];
+    const float wall_min_y = min_y[world_index], wall_max_y = max_y[world_index];
+    for (int i = body_start[world_index]; i < body_start[world_index + 1]; ++i)
+    {
+        if (inv_mass[i] <= 0.0f)
+            continue;
+        float px = position_x[i], py = position_y[i];
+        float vx = vel_x[i], vy = vel_y[i];
+        const float r = radius[i];
+        const float e = restitution[i];
+        bool touched = false;
+        if (px - r < wall_min_x)
+        {
+            px = wall_min_x + r;
+            vx = vx < 0.0f ? -vx * e : vx;
+            touched = true;
+        }
+        if (px + r > wall_max_x)
+        {
+            px = wall_max_x - r;
+            vx = vx > 0.0f ? -vx * e : vx;
+            touched = true;
+        }
+        if (py - r < wall_min_y)
+        {
+            py = wall_min_y + r;
+            vy = vy < 0.0f ? -vy * e : vy;
+            touched = true;
+        }
+        if (py + r > wall_max_y)
+        {
+            py = wall_max_y - r;
+            vy = vy > 0.0f ? -vy * e : vy;
+            touched = true;
+        }
+        if (!touched)
+            continue;
+        position_x[i] = px;
+        position_y[i] = py;
+        vel_x[i] = vx;
+        vel_y[i] = vy;
+        previous_position_x[i] = px - vx * dt;
+        previous_position_y[i] = py - vy * dt;
+    }
+}
@@ -1,25 +1,35 @@
 #include "sim/collisionSystem.hpp"
+#include "sim/contactResponse.hpp"
 #include "physics/world.hpp"
 #include "physics/body.hpp"
 #include "math/vec2.hpp"
+#include "utils/threadPool.hpp"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
 #include <vector>
+#include <chrono>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 // ====================================================================
 // --- TUNING CONFIGURATION (Move to a header or settings) ---
 // ====================================================================
-// It's recommended to move these values to private members or a configuration class.
-const float POSITION_CORRECTION_SLOP = 0.001f;  // Minimum penetration before correcting
-const float POSITION_CORRECTION_PERCENT = 0.2f; // Percentage of penetration to correct (smaller to avoid energy loss)
-const float VELOCITY_EPSILON = 1e-6f;           // Threshold to snap velocity to zero (smaller to avoid early sleeping)
+// Contact response tuning lives in sim/contactResponse.hpp, shared with WorldBatch.
+const int NARROW_PHASE_TILE = 8;                // Pairs per SoA tile (one AVX / two SSE registers of floats)
+const int BROAD_PHASE_BLOCK = 8;                // Cells per side of a tiled broad-phase block
+const float INCREMENTAL_GRID_MAX_DIRTY = 0.25f; // Above this fraction of moved bodies a full re-sort is cheaper
+const int CONTACT_BATCH_WIDTH = 4;              // Contact rows per SIMD batch (one SSE register of floats)
+const int CONTACT_BATCH_COLORS = 64;            // Colours available to the contact batch packer (one 64-bit mask per body)
 
 // ====================================================================
 // --- CONSTRUCTOR/DESTRUCTOR ---
 // ====================================================================
 
-collisionSystem::collisionSystem() {}
+collisionSystem::collisionSystem(ThreadPool *pool) : pool(pool) {}
 collisionSystem::~collisionSystem() {}
 
 // ====================================================================
@@ -28,90 +38,572 @@ collisionSystem::~collisionSystem() {}
 
 void collisionSystem::clear_spatial_grid(world &simulation_world)
 {
-    for (auto &cell_body_list : simulation_world.grid)
-    {
-        cell_body_list.clear();
-    }
+    std::fill(simulation_world.particle_start_indices.begin(), simulation_world.particle_start_indices.end(), 0);
 }
 
 void collisionSystem::populate_spatial_grid(world &simulation_world)
 {
+    // Counting sort of body indices by cell into the persistent CSR arrays:
+    // the vectors only grow, so a steady-state step never touches the heap.
     size_t n = simulation_world.position_x.size();
+    int num_cells = simulation_world.num_grid_cells();
+    std::vector<int> &cell_start = simulation_world.particle_start_indices;
+    std::vector<int> &cell_id = simulation_world.particle_cell_id;
+    cell_id.resize(n);
+
+    // 1. Cell of each body, counted into cell_start[c + 1]
+    int in_grid = 0;
     for (size_t i = 0; i < n; ++i)
     {
         vec2 pos(simulation_world.position_x[i], simulation_world.position_y[i]);
         int grid_index = simulation_world.get_grid_index(pos);
+        cell_id[i] = grid_index;
         if (grid_index >= 0)
         {
-            simulation_world.grid[grid_index].push_back((int)i);
+            ++cell_start[grid_index + 1];
+            ++in_grid;
+        }
+    }
+
+    // 2. Exclusive prefix sum -> start offset of each cell
+    for (int c = 0; c < num_cells; ++c)
+        cell_start[c + 1] += cell_start[c];
+
+    // 3. Scatter indices; per-cell write cursors come from the frame arena
+    int *cursor = simulation_world.frame_arena.allocate<int>(num_cells);
+    std::copy(cell_start.begin(), cell_start.begin() + num_cells, cursor);
+    simulation_world.sorted_indices.resize(in_grid);
+    simulation_world.particle_sorted_slot.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        int c = cell_id[i];
+        int slot = -1;
+        if (c >= 0)
+        {
+            slot = cursor[c]++;
+            simulation_world.sorted_indices[slot] = (int)i;
+        }
+        simulation_world.particle_sorted_slot[i] = slot;
+    }
+
+    simulation_world.grid_rebuild_required = false;
+    simulation_world.grid_moved_bodies = n;
+}
+
+bool collisionSystem::update_spatial_grid_incremental(world &simulation_world)
+{
+    size_t n = simulation_world.position_x.size();
+    if (simulation_world.grid_rebuild_required || simulation_world.particle_cell_id.size() != n ||
+        simulation_world.particle_sorted_slot.size() != n)
+        return false;
+
+    std::vector<int> &cell_id = simulation_world.particle_cell_id;
+
+    // 1. Dirty list: bodies whose cell differs from the one they are stored in.
+    //    Entering or leaving the grid changes the CSR size, so that forces a rebuild.
+    size_t max_dirty = size_t(INCREMENTAL_GRID_MAX_DIRTY * float(n)) + 1;
+    int *dirty_body = simulation_world.frame_arena.allocate<int>(max_dirty);
+    int *dirty_cell = simulation_world.frame_arena.allocate<int>(max_dirty);
+    size_t dirty_count = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        vec2 pos(simulation_world.position_x[i], simulation_world.position_y[i]);
+        int grid_index = simulation_world.get_grid_index(pos);
+        if (grid_index == cell_id[i])
+            continue;
+        if (grid_index < 0 || cell_id[i] < 0 || dirty_count == max_dirty)
+            return false;
+        dirty_body[dirty_count] = (int)i;
+        dirty_cell[dirty_count] = grid_index;
+        ++dirty_count;
+    }
+
+    // 2. Move each dirty body across the cell boundaries between its old and new
+    //    cell: swapping it to the edge of its current cell and shifting that
+    //    boundary by one keeps every cell contiguous. Cost is O(cells crossed).
+    std::vector<int> &cell_start = simulation_world.particle_start_indices;
+    std::vector<int> &sorted = simulation_world.sorted_indices;
+    std::vector<int> &slot_of = simulation_world.particle_sorted_slot;
+    auto swap_slots = [&](int a, int b)
+    {
+        std::swap(sorted[a], sorted[b]);
+        slot_of[sorted[a]] = a;
+        slot_of[sorted[b]] = b;
+    };
+    for (size_t d = 0; d < dirty_count; ++d)
+    {
+        int body_index = dirty_body[d];
+        int from = cell_id[body_index];
+        int to = dirty_cell[d];
+        int slot = slot_of[body_index];
+        for (int c = from; c < to; ++c)
+        {
+            int last = cell_start[c + 1] - 1;
+            swap_slots(slot, last);
+            --cell_start[c + 1];
+            slot = last;
+        }
+        for (int c = from; c > to; --c)
+        {
+            int first = cell_start[c];
+            swap_slots(slot, first);
+            ++cell_start[c];
+            slot = first;
+        }
+        cell_id[body_index] = to;
+    }
+
+    simulation_world.grid_moved_bodies = dirty_count;
+    return true;
+}
+
+// ====================================================================
+// --- BROAD PHASE HELPERS (shared by the pair and tiled traversals) ---
+// ====================================================================
+
+// Per-cell summaries: union of the occupants' categories and masks, and whether
+// any occupant is dynamic. Two cells whose unions cannot interact (or that hold
+// only static bodies) are skipped without looking at a single pair.
+struct CellSummaries
+{
+    const uint32_t *category;
+    const uint32_t *mask;
+    const bool *dynamic;
+
+    bool can_interact(int a, int b) const
+    {
+        return (dynamic[a] || dynamic[b]) &&
+               (category[a] & mask[b]) != 0 && (category[b] & mask[a]) != 0;
+    }
+};
+
+// Same test per body pair, applied before a pair is emitted: "both static"
+// and layer filtering never reach the overlap test.
+static inline bool bodies_can_interact(uint32_t category_a, uint32_t mask_a, float inv_mass_a,
+                                       uint32_t category_b, uint32_t mask_b, float inv_mass_b)
+{
+    return (inv_mass_a != 0.0f || inv_mass_b != 0.0f) &&
+           (category_a & mask_b) != 0 && (category_b & mask_a) != 0;
+}
+
+static CellSummaries summarize_cells(world &simulation_world)
+{
+    // Layer columns may be missing for worlds built from raw SoA arrays
+    size_t n = simulation_world.position_x.size();
+    if (simulation_world.collision_category.size() != n)
+        simulation_world.collision_category.resize(n, 1u);
+    if (simulation_world.collision_mask.size() != n)
+        simulation_world.collision_mask.resize(n, ~0u);
+    const uint32_t *category = simulation_world.collision_category.data();
+    const uint32_t *mask = simulation_world.collision_mask.data();
+    const float *inv_mass = simulation_world.inv_mass.data();
+
+    int num_cells = simulation_world.num_grid_cells();
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    const int *cell_bodies = simulation_world.sorted_indices.data();
+
+    // num_cells_x/y set by hand without resize_grid leave the table stale
+    GridInfo &grid = simulation_world.grid_info;
+    if (grid.cell_neighbors.size() != size_t(num_cells) * GridInfo::NUM_NEIGHBORS)
+        grid.build_neighbor_table();
+
+    uint32_t *cell_category = simulation_world.frame_arena.allocate<uint32_t>(num_cells);
+    uint32_t *cell_mask = simulation_world.frame_arena.allocate<uint32_t>(num_cells);
+    bool *cell_dynamic = simulation_world.frame_arena.allocate<bool>(num_cells);
+    for (int c = 0; c < num_cells; ++c)
+    {
+        uint32_t cat_union = 0, mask_union = 0;
+        bool dynamic = false;
+        for (int s = cell_start[c]; s < cell_start[c + 1]; ++s)
+        {
+            int i = cell_bodies[s];
+            cat_union |= category[i];
+            mask_union |= mask[i];
+            dynamic |= inv_mass[i] != 0.0f;
         }
+        cell_category[c] = cat_union;
+        cell_mask[c] = mask_union;
+        cell_dynamic[c] = dynamic;
+    }
+    return CellSummaries{cell_category, cell_mask, cell_dynamic};
+}
+
+// Visits every interacting (current cell, neighbor cell) range; same-cell pairs use neighbor == -1.
+template <typename Visit>
+static void for_each_cell_pair(const world &simulation_world, const CellSummaries &cells, Visit &&visit)
+{
+    int num_cells = simulation_world.num_grid_cells();
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    const int *cell_neighbors = simulation_world.grid_info.cell_neighbors.data();
+
+    for (int cell_index = 0; cell_index < num_cells; ++cell_index)
+    {
+        if (cell_start[cell_index] == cell_start[cell_index + 1])
+            continue;
+
+        // 1. Check against the forward neighbor cells (-1 outside the grid)
+        const int *neighbors = cell_neighbors + size_t(cell_index) * GridInfo::NUM_NEIGHBORS;
+        for (int k = 0; k < GridInfo::NUM_NEIGHBORS; ++k)
+        {
+            int neighbor_index = neighbors[k];
+            if (neighbor_index >= 0 && cells.can_interact(cell_index, neighbor_index))
+                visit(cell_index, neighbor_index);
+        }
+
+        // 2. Check within the same cell
+        if (cells.can_interact(cell_index, cell_index))
+            visit(cell_index, -1);
+    }
+}
+
+// Upper bound on the pairs produced by for_each_cell_pair, so the arena allocation is a single bump.
+static size_t count_candidate_pairs(const world &simulation_world, const CellSummaries &cells)
+{
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    size_t capacity = 0;
+    for_each_cell_pair(simulation_world, cells, [&](int cell, int neighbor)
+    {
+        size_t count_a = size_t(cell_start[cell + 1] - cell_start[cell]);
+        if (neighbor < 0)
+            capacity += count_a * (count_a - 1) / 2;
+        else
+            capacity += count_a * size_t(cell_start[neighbor + 1] - cell_start[neighbor]);
+    });
+    return capacity;
+}
+
+// Distance test of one SoA tile (NARROW_PHASE_TILE lanes), folded into a hit
+// bitmask. Lanes with a negative reach never report a hit.
+static inline unsigned overlap_tile_mask(const float *dx, const float *dy, const float *reach)
+{
+    unsigned hit_mask = 0;
+#if defined(__AVX__)
+    __m256 vx = _mm256_load_ps(dx);
+    __m256 vy = _mm256_load_ps(dy);
+    __m256 vr = _mm256_load_ps(reach);
+    __m256 distance_squared = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(distance_squared, _mm256_mul_ps(vr, vr), _CMP_LE_OQ),
+                               _mm256_cmp_ps(vr, _mm256_setzero_ps(), _CMP_GE_OQ));
+    hit_mask = unsigned(_mm256_movemask_ps(hit));
+#elif defined(__SSE2__)
+    for (int k = 0; k < NARROW_PHASE_TILE; k += 4)
+    {
+        __m128 vx = _mm_load_ps(dx + k);
+        __m128 vy = _mm_load_ps(dy + k);
+        __m128 vr = _mm_load_ps(reach + k);
+        __m128 distance_squared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(distance_squared, _mm_mul_ps(vr, vr)),
+                                _mm_cmpge_ps(vr, _mm_setzero_ps()));
+        hit_mask |= unsigned(_mm_movemask_ps(hit)) << k;
+    }
+#else
+    for (int k = 0; k < NARROW_PHASE_TILE; ++k)
+    {
+        float distance_squared = dx[k] * dx[k] + dy[k] * dy[k];
+        bool hit = reach[k] >= 0.0f && distance_squared <= reach[k] * reach[k];
+        hit_mask |= unsigned(hit) << k;
     }
+#endif
+    return hit_mask;
 }
 
 // ====================================================================
 // --- BROAD PHASE: Generate Candidate Pairs ---
 // ====================================================================
 
-std::vector<std::pair<int, int>> collisionSystem::broad_phase_generate_pairs(world &simulation_world)
+CandidatePairs collisionSystem::broad_phase_generate_pairs(world &simulation_world)
 {
-    std::vector<std::pair<int, int>> potential_collision_pairs;
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    const int *cell_bodies = simulation_world.sorted_indices.data();
 
-    int num_cells_x = simulation_world.grid_info.num_cells_x;
-    int num_cells_y = simulation_world.grid_info.num_cells_y;
+    CellSummaries cells = summarize_cells(simulation_world);
+    const uint32_t *category = simulation_world.collision_category.data();
+    const uint32_t *mask = simulation_world.collision_mask.data();
+    const float *inv_mass = simulation_world.inv_mass.data();
+
+    // Pass 1: upper bound on the pair count
+    CandidatePairs potential_collision_pairs;
+    potential_collision_pairs.pairs = simulation_world.frame_arena.allocate<std::pair<int, int>>(count_candidate_pairs(simulation_world, cells));
 
-    // Neighbor offsets: only check right, down, and down-right to avoid duplicates
-    const int neighbor_offsets[3][2] = {
-        {1, 0}, // Right
-        {0, 1}, // Down
-        {1, 1}  // Down-Right
+    auto emit = [&](std::pair<int, int> *&out, int a, int b)
+    {
+        if (bodies_can_interact(category[a], mask[a], inv_mass[a], category[b], mask[b], inv_mass[b]))
+            *out++ = std::make_pair(a, b);
     };
 
-    for (size_t cell_index = 0; cell_index < simulation_world.grid.size(); ++cell_index)
+    // Pass 2: fill with the pairs that pass the per-body filter
+    std::pair<int, int> *out = potential_collision_pairs.pairs;
+    for_each_cell_pair(simulation_world, cells, [&](int cell, int neighbor)
     {
-        auto &current_cell_bodies = simulation_world.grid[cell_index];
+        int begin_a = cell_start[cell];
+        int end_a = cell_start[cell + 1];
+        if (neighbor < 0)
+        {
+            for (int i = begin_a; i < end_a; ++i)
+                for (int j = i + 1; j < end_a; ++j)
+                    emit(out, cell_bodies[i], cell_bodies[j]);
+            return;
+        }
+        int begin_b = cell_start[neighbor];
+        int end_b = cell_start[neighbor + 1];
+        for (int i = begin_a; i < end_a; ++i)
+            for (int j = begin_b; j < end_b; ++j)
+                emit(out, cell_bodies[i], cell_bodies[j]);
+    });
 
-        int current_cell_y = cell_index / num_cells_x;
-        int current_cell_x = cell_index % num_cells_x;
+    potential_collision_pairs.count = size_t(out - potential_collision_pairs.pairs);
+    return potential_collision_pairs;
+}
 
-        // 1. Check against neighbor cells
-        for (const auto &offset : neighbor_offsets)
+// ====================================================================
+// --- NEIGHBOUR LIST BROAD PHASE: Pairs Reused Across Frames ---
+// ====================================================================
+
+CandidatePairs collisionSystem::broad_phase_neighbor_list(world &simulation_world)
+{
+    NeighborList &list = simulation_world.neighbor_list;
+
+    // The list is built from grid pairs, which only reach adjacent cells:
+    // radius_a + radius_b + skin must fit in one cell. Clamp the skin, and
+    // without room for any skin fall back to the grid pairs.
+    float max_radius = 0.0f;
+    for (float r : simulation_world.radius)
+        max_radius = std::max(max_radius, r);
+    float room = simulation_world.grid_info.cell_size - 2.0f * max_radius;
+    if (room <= 0.0f)
+    {
+        list.invalidate();
+        return broad_phase_generate_pairs(simulation_world);
+    }
+    float skin = std::min(std::max(simulation_world.neighbor_skin, 0.0f), room);
+    if (list.needs_rebuild(simulation_world, skin))
+    {
+        CandidatePairs grid_pairs = broad_phase_generate_pairs(simulation_world);
+        list.build(simulation_world, grid_pairs.pairs, grid_pairs.count, skin);
+    }
+
+    // Layers and static flags may have changed since the build: filter again
+    const uint32_t *category = simulation_world.collision_category.data();
+    const uint32_t *mask = simulation_world.collision_mask.data();
+    const float *inv_mass = simulation_world.inv_mass.data();
+    CandidatePairs pairs;
+    pairs.pairs = simulation_world.frame_arena.allocate<std::pair<int, int>>(list.num_pairs());
+    size_t n = simulation_world.position_x.size();
+    for (size_t a = 0; a < n; ++a)
+    {
+        for (int k = list.start[a]; k < list.start[a + 1]; ++k)
         {
-            int offset_x = offset[0];
-            int offset_y = offset[1];
+            int b = list.neighbors[k];
+            if (bodies_can_interact(category[a], mask[a], inv_mass[a], category[b], mask[b], inv_mass[b]))
+                pairs.pairs[pairs.count++] = std::make_pair(int(a), b);
+        }
+    }
+    return pairs;
+}
 
-            int neighbor_cell_x = current_cell_x + offset_x;
-            int neighbor_cell_y = current_cell_y + offset_y;
+// ====================================================================
+// --- TILED BROAD PHASE: Cell Blocks with Contiguous Scratch ---
+// ====================================================================
 
-            if (neighbor_cell_x >= num_cells_x || neighbor_cell_y >= num_cells_y)
+CandidatePairs collisionSystem::broad_phase_tiled_contacts(world &simulation_world)
+{
+    const int B = BROAD_PHASE_BLOCK;
+    // Local window of a block: its B x B cells plus the halo reached by the
+    // half-shell stencil (one column on each side, one row below). Neighbour
+    // slots come from GridInfo::NEIGHBOR_OFFSETS; which cell a halo slot holds
+    // (wrapped or not) is decided by the window runs below.
+    const int LOCAL_W = B + 2;
+    const int LOCAL_H = B + 1;
+
+    int num_cells_x = simulation_world.grid_info.num_cells_x;
+    int num_cells_y = simulation_world.grid_info.num_cells_y;
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    const int *cell_bodies = simulation_world.sorted_indices.data();
+
+    CellSummaries cells = summarize_cells(simulation_world);
+    const int *cell_neighbors = simulation_world.grid_info.cell_neighbors.data();
+    const uint32_t *category = simulation_world.collision_category.data();
+    const uint32_t *mask = simulation_world.collision_mask.data();
+    const float *inv_mass = simulation_world.inv_mass.data();
+    const float *px = simulation_world.position_x.data();
+    const float *py = simulation_world.position_y.data();
+    const float *radius = simulation_world.radius.data();
+
+    CandidatePairs contacts;
+    contacts.pairs = simulation_world.frame_arena.allocate<std::pair<int, int>>(count_candidate_pairs(simulation_world, cells));
+    size_t num_contacts = 0;
+
+    // Visits a block's window as runs of consecutive cells of one grid row:
+    // visit(row, gx_begin, gx_end, local_row, local_col, shift_x, shift_y).
+    // The cells of a run are contiguous in sorted_indices, so each run is a single
+    // linear copy. Halo cells past a periodic edge wrap to the far side and carry
+    // the shift that places their bodies next to the block.
+    const GridInfo &grid = simulation_world.grid_info;
+    auto for_each_window_run = [&](int block_x, int block_y, auto &&visit)
+    {
+        int block_x_end = std::min(block_x + B, num_cells_x);
+        int block_y_end = std::min(block_y + B, num_cells_y);
+        for (int raw_y = block_y; raw_y <= block_y_end; ++raw_y)
+        {
+            int gy = raw_y;
+            float shift_y = 0.0f;
+            if (raw_y == num_cells_y)
             {
-                continue;
+                if (!grid.wraps_y())
+                    break;
+                gy = 0;
+                shift_y = grid.period_y();
             }
+            int local_row = raw_y - block_y;
+            if (block_x == 0 && grid.wraps_x())
+                visit(gy, num_cells_x - 1, num_cells_x, local_row, 0, -grid.period_x(), shift_y);
+            int x0 = std::max(block_x - 1, 0);
+            int x1 = std::min(block_x_end + 1, num_cells_x);
+            visit(gy, x0, x1, local_row, x0 - block_x + 1, 0.0f, shift_y);
+            if (block_x_end == num_cells_x && grid.wraps_x())
+                visit(gy, 0, 1, local_row, block_x_end - block_x + 1, grid.period_x(), shift_y);
+        }
+    };
 
-            int neighbor_index = neighbor_cell_y * num_cells_x + neighbor_cell_x;
-            auto &neighbor_cell_bodies = simulation_world.grid[neighbor_index];
+    // Scratch sized for the fullest window
+    size_t scratch_capacity = 0;
+    for (int block_y = 0; block_y < num_cells_y; block_y += B)
+    {
+        for (int block_x = 0; block_x < num_cells_x; block_x += B)
+        {
+            size_t occupancy = 0;
+            for_each_window_run(block_x, block_y, [&](int gy, int gx_begin, int gx_end, int, int, float, float)
+            {
+                occupancy += size_t(cell_start[gy * num_cells_x + gx_end] - cell_start[gy * num_cells_x + gx_begin]);
+            });
+            scratch_capacity = std::max(scratch_capacity, occupancy);
+        }
+    }
+    float *local_x = simulation_world.frame_arena.allocate<float>(scratch_capacity);
+    float *local_y = simulation_world.frame_arena.allocate<float>(scratch_capacity);
+    float *local_radius = simulation_world.frame_arena.allocate<float>(scratch_capacity);
+    float *local_inv_mass = simulation_world.frame_arena.allocate<float>(scratch_capacity);
+    uint32_t *local_category = simulation_world.frame_arena.allocate<uint32_t>(scratch_capacity);
+    uint32_t *local_mask = simulation_world.frame_arena.allocate<uint32_t>(scratch_capacity);
+    int *local_body = simulation_world.frame_arena.allocate<int>(scratch_capacity);
+    int *local_begin = simulation_world.frame_arena.allocate<int>(LOCAL_W * LOCAL_H);
+    int *local_end = simulation_world.frame_arena.allocate<int>(LOCAL_W * LOCAL_H);
 
-            for (int idxA : current_cell_bodies)
+    // Pending tile: lane deltas are computed as pairs are pushed, straight from
+    // the local arrays, and flushed through the SIMD overlap test when full.
+    alignas(32) float tile_dx[NARROW_PHASE_TILE];
+    alignas(32) float tile_dy[NARROW_PHASE_TILE];
+    alignas(32) float tile_reach[NARROW_PHASE_TILE];
+    int tile_a[NARROW_PHASE_TILE];
+    int tile_b[NARROW_PHASE_TILE];
+    int tile_count = 0;
+    auto flush_tile = [&]()
+    {
+        for (int k = tile_count; k < NARROW_PHASE_TILE; ++k)
+        {
+            tile_dx[k] = 0.0f;
+            tile_dy[k] = 0.0f;
+            tile_reach[k] = -1.0f;
+        }
+        unsigned hit_mask = overlap_tile_mask(tile_dx, tile_dy, tile_reach);
+        while (hit_mask)
+        {
+            int k = __builtin_ctz(hit_mask);
+            contacts.pairs[num_contacts++] = std::make_pair(local_body[tile_a[k]], local_body[tile_b[k]]);
+            hit_mask &= hit_mask - 1;
+        }
+        tile_count = 0;
+    };
+    // Tests body a against the local range [b_begin, b_end)
+    auto test_against_range = [&](int a, int b_begin, int b_end)
+    {
+        float ax = local_x[a], ay = local_y[a], ar = local_radius[a];
+        uint32_t a_category = local_category[a], a_mask = local_mask[a];
+        float a_inv_mass = local_inv_mass[a];
+        for (int b = b_begin; b < b_end; ++b)
+        {
+            if (!bodies_can_interact(a_category, a_mask, a_inv_mass, local_category[b], local_mask[b], local_inv_mass[b]))
+                continue;
+            tile_dx[tile_count] = ax - local_x[b];
+            tile_dy[tile_count] = ay - local_y[b];
+            tile_reach[tile_count] = ar + local_radius[b];
+            tile_a[tile_count] = a;
+            tile_b[tile_count] = b;
+            if (++tile_count == NARROW_PHASE_TILE)
+                flush_tile();
+        }
+    };
+
+    for (int block_y = 0; block_y < num_cells_y; block_y += B)
+    {
+        for (int block_x = 0; block_x < num_cells_x; block_x += B)
+        {
+            // 1. Gather the window (block + halo) into contiguous local arrays
+            int local_count = 0;
+            std::fill(local_begin, local_begin + LOCAL_W * LOCAL_H, 0);
+            std::fill(local_end, local_end + LOCAL_W * LOCAL_H, 0);
+            for_each_window_run(block_x, block_y, [&](int gy, int gx_begin, int gx_end, int local_row, int local_col, float shift_x, float shift_y)
             {
-                for (int idxB : neighbor_cell_bodies)
+                int run_first = cell_start[gy * num_cells_x + gx_begin];
+                int run_base = local_count;
+                for (int gx = gx_begin; gx < gx_end; ++gx)
                 {
-                    potential_collision_pairs.emplace_back(idxA, idxB);
+                    int c = gy * num_cells_x + gx;
+                    int l = local_row * LOCAL_W + local_col + (gx - gx_begin);
+                    local_begin[l] = run_base + (cell_start[c] - run_first);
+                    local_end[l] = run_base + (cell_start[c + 1] - run_first);
                 }
-            }
-        }
+                for (int s = run_first; s < cell_start[gy * num_cells_x + gx_end]; ++s)
+                {
+                    int i = cell_bodies[s];
+                    local_x[local_count] = px[i] + shift_x;
+                    local_y[local_count] = py[i] + shift_y;
+                    local_radius[local_count] = radius[i];
+                    local_inv_mass[local_count] = inv_mass[i];
+                    local_category[local_count] = category[i];
+                    local_mask[local_count] = mask[i];
+                    local_body[local_count] = i;
+                    ++local_count;
+                }
+            });
 
-        // 2. Check within the same cell
-        for (size_t i = 0; i < current_cell_bodies.size(); ++i)
-        {
-            int idxA = current_cell_bodies[i];
-            for (size_t j = i + 1; j < current_cell_bodies.size(); ++j)
+            // 2. All pair tests of the block's cells run out of the local arrays
+            int block_x_end = std::min(block_x + B, num_cells_x);
+            int block_y_end = std::min(block_y + B, num_cells_y);
+            for (int gy = block_y; gy < block_y_end; ++gy)
             {
-                int idxB = current_cell_bodies[j];
-                potential_collision_pairs.emplace_back(idxA, idxB);
+                for (int gx = block_x; gx < block_x_end; ++gx)
+                {
+                    int cell_index = gy * num_cells_x + gx;
+                    int l = (gy - block_y) * LOCAL_W + (gx - block_x + 1);
+                    if (local_begin[l] == local_end[l])
+                        continue;
+
+                    const int *neighbors = cell_neighbors + size_t(cell_index) * GridInfo::NUM_NEIGHBORS;
+                    for (int k = 0; k < GridInfo::NUM_NEIGHBORS; ++k)
+                    {
+                        if (neighbors[k] < 0 || !cells.can_interact(cell_index, neighbors[k]))
+                            continue;
+                        int ln = l + GridInfo::NEIGHBOR_OFFSETS[k][1] * LOCAL_W + GridInfo::NEIGHBOR_OFFSETS[k][0];
+                        for (int a = local_begin[l]; a < local_end[l]; ++a)
+                            test_against_range(a, local_begin[ln], local_end[ln]);
+                    }
+
+                    if (cells.can_interact(cell_index, cell_index))
+                    {
+                        for (int a = local_begin[l]; a < local_end[l]; ++a)
+                            test_against_range(a, a + 1, local_end[l]);
+                    }
+                }
             }
+            // Local indices are only valid for this window
+            if (tile_count > 0)
+                flush_tile();
         }
     }
 
-    return potential_collision_pairs;
+    contacts.count = num_contacts;
+    return contacts;
 }
 
 // ====================================================================
@@ -131,140 +623,787 @@ bool collisionSystem::check_for_overlap(int idxA, int idxB, world &simulation_wo
     return distance_squared <= sum_of_radii_squared;
 }
 
+// ====================================================================
+// --- BATCHED NARROW PHASE (Tiled Overlap Test) ---
+// ====================================================================
+
+CandidatePairs collisionSystem::narrow_phase_collect_contacts(world &simulation_world, const CandidatePairs &candidates)
+{
+    const float *px = simulation_world.position_x.data();
+    const float *py = simulation_world.position_y.data();
+    const float *radius = simulation_world.radius.data();
+    const GridInfo &grid = simulation_world.grid_info;
+    const bool periodic = grid.wraps_x() || grid.wraps_y();
+
+    CandidatePairs contacts;
+    contacts.pairs = simulation_world.frame_arena.allocate<std::pair<int, int>>(candidates.count);
+    size_t num_contacts = 0;
+
+    for (size_t base = 0; base < candidates.count; base += NARROW_PHASE_TILE)
+    {
+        size_t lanes = std::min<size_t>(NARROW_PHASE_TILE, candidates.count - base);
+        const std::pair<int, int> *tile_pairs = candidates.pairs + base;
+
+        // 1. Gather the tile into SoA lanes. Unused lanes of the last tile get a
+        //    negative reach so they can never report a hit.
+        alignas(32) float dx[NARROW_PHASE_TILE];
+        alignas(32) float dy[NARROW_PHASE_TILE];
+        alignas(32) float reach[NARROW_PHASE_TILE];
+        for (int k = 0; k < NARROW_PHASE_TILE; ++k)
+        {
+            if ((size_t)k < lanes)
+            {
+                int a = tile_pairs[k].first;
+                int b = tile_pairs[k].second;
+                dx[k] = px[a] - px[b];
+                dy[k] = py[a] - py[b];
+                reach[k] = radius[a] + radius[b];
+                if (periodic)
+                {
+                    dx[k] = grid.minimum_image_x(dx[k]);
+                    dy[k] = grid.minimum_image_y(dy[k]);
+                }
+            }
+            else
+            {
+                dx[k] = 0.0f;
+                dy[k] = 0.0f;
+                reach[k] = -1.0f;
+            }
+        }
+
+        // 2. Distance test across all lanes at once
+        unsigned hit_mask = overlap_tile_mask(dx, dy, reach);
+
+        // 3. Compact: append only the set lanes
+        while (hit_mask)
+        {
+            int k = __builtin_ctz(hit_mask);
+            contacts.pairs[num_contacts++] = tile_pairs[k];
+            hit_mask &= hit_mask - 1;
+        }
+    }
+
+    contacts.count = num_contacts;
+    return contacts;
+}
+
+// ====================================================================
+// --- COLLISION EVENTS ---
+// ====================================================================
+
+static CollisionEvent make_collision_event(CollisionEventType type, const ContactManifold &manifold, const world &simulation_world)
+{
+    CollisionEvent event;
+    event.type = type;
+    event.body_A = std::min(manifold.body_A, manifold.body_B);
+    event.body_B = std::max(manifold.body_A, manifold.body_B);
+    event.impulse = manifold.normal_impulse;
+    // Normal always points from the lower index to the higher one
+    event.normal = manifold.body_A == event.body_A ? manifold.normal_direction : manifold.normal_direction * -1.0f;
+    float rA = simulation_world.radius[event.body_A];
+    event.point = vec2(simulation_world.position_x[event.body_A], simulation_world.position_y[event.body_A]) + event.normal * rA;
+    return event;
+}
+
 // ====================================================================
 // --- NARROW PHASE: Check and Resolve ---
 // ====================================================================
 
+void collisionSystem::begin_contact_recording(world &simulation_world)
+{
+    if (simulation_world.persistent_contacts || simulation_world.report_collision_events)
+        simulation_world.contacts.begin_frame();
+    if (simulation_world.report_collision_events)
+        simulation_world.collision_events.begin_step();
+}
+
+void collisionSystem::record_contact(world &simulation_world, const ContactManifold &manifold)
+{
+    if (!simulation_world.persistent_contacts && !simulation_world.report_collision_events)
+        return;
+    ContactCache &contacts = simulation_world.contacts;
+    CollisionEventStream &events = simulation_world.collision_events;
+    const ContactCacheEntry &entry = contacts.record(manifold);
+    if (simulation_world.report_collision_events && (contacts.began(entry) || events.report_persist))
+        events.push(make_collision_event(contacts.began(entry) ? CollisionEventType::Begin : CollisionEventType::Persist, entry.manifold, simulation_world));
+}
+
+void collisionSystem::end_contact_recording(world &simulation_world)
+{
+    ContactCache &contacts = simulation_world.contacts;
+    if (simulation_world.report_collision_events)
+    {
+        // Pairs touched last frame but not this one have just separated
+        CollisionEventStream &events = simulation_world.collision_events;
+        contacts.for_each([&](const ContactCacheEntry &entry)
+        {
+            if (contacts.ended(entry))
+                events.push(make_collision_event(CollisionEventType::End, entry.manifold, simulation_world));
+        });
+    }
+    if (simulation_world.persistent_contacts || simulation_world.report_collision_events)
+        contacts.evict_stale();
+}
+
 void collisionSystem::narrow_phase_check_and_resolve(world &simulation_world)
 {
-    // Broad phase timing
-    auto t_b0 = std::chrono::high_resolution_clock::now();
-    auto potential_pairs = broad_phase_generate_pairs(simulation_world);
-    auto t_b1 = std::chrono::high_resolution_clock::now();
-    auto broad_us = std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
-    simulation_world.broad_phase_us = (unsigned long long)broad_us;
+    const bool record_contacts = simulation_world.persistent_contacts || simulation_world.report_collision_events;
+    begin_contact_recording(simulation_world);
+
+    CandidatePairs contact_pairs;
+    if (simulation_world.tiled_broad_phase && !simulation_world.neighbor_lists)
+    {
+        // Detection is fused into the block traversal: it is all timed as broad phase
+        auto t_b0 = std::chrono::high_resolution_clock::now();
+        contact_pairs = broad_phase_tiled_contacts(simulation_world);
+        auto t_b1 = std::chrono::high_resolution_clock::now();
+        auto broad_us = std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
+        simulation_world.broad_phase_us = (unsigned long long)broad_us;
+        simulation_world.narrow_phase_us = 0;
+    }
+    else
+    {
+        // Broad phase timing
+        auto t_b0 = std::chrono::high_resolution_clock::now();
+        auto potential_pairs = simulation_world.neighbor_lists ? broad_phase_neighbor_list(simulation_world) : broad_phase_generate_pairs(simulation_world);
+        auto t_b1 = std::chrono::high_resolution_clock::now();
+        auto broad_us = std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
+        simulation_world.broad_phase_us = (unsigned long long)broad_us;
+
+        // Narrow phase timing
+        auto t_n0 = std::chrono::high_resolution_clock::now();
+        contact_pairs = narrow_phase_collect_contacts(simulation_world, potential_pairs);
+        auto t_n1 = std::chrono::high_resolution_clock::now();
+        auto narrow_us = std::chrono::duration_cast<std::chrono::microseconds>(t_n1 - t_n0).count();
+        simulation_world.narrow_phase_us = (unsigned long long)narrow_us;
+    }
+
+    // Resolution timing
+    auto t_r0 = std::chrono::high_resolution_clock::now();
+    if (simulation_world.island_solving || simulation_world.simd_contact_solver)
+    {
+        // Islands and batches resolve out of order: the cache and events are fed afterwards, in contact order
+        ContactManifold *manifolds = simulation_world.frame_arena.allocate<ContactManifold>(contact_pairs.count);
+        uint8_t *resolved = simulation_world.frame_arena.allocate<uint8_t>(contact_pairs.count);
+        if (simulation_world.island_solving)
+            solve_contact_islands(simulation_world, contact_pairs, manifolds, resolved);
+        else
+            solve_contact_batches(simulation_world, contact_pairs, manifolds, resolved);
+        if (record_contacts)
+            for (size_t p = 0; p < contact_pairs.count; ++p)
+                if (resolved[p])
+                    record_contact(simulation_world, manifolds[p]);
+    }
+    else
+    {
+        simulation_world.contact_island_count = 0;
+        simulation_world.contact_batch_count = 0;
+        for (size_t p = 0; p < contact_pairs.count; ++p)
+        {
+            auto [idxA, idxB] = contact_pairs.pairs[p];
+            ContactManifold manifold;
+            if (resolve_contact_with_impulse(idxA, idxB, simulation_world, manifold) && record_contacts)
+                record_contact(simulation_world, manifold);
+        }
+    }
+    auto t_r1 = std::chrono::high_resolution_clock::now();
+    auto resolve_us = std::chrono::duration_cast<std::chrono::microseconds>(t_r1 - t_r0).count();
+    simulation_world.resolve_phase_us += (unsigned long long)resolve_us;
+
+    end_contact_recording(simulation_world);
+}
+
+// ====================================================================
+// --- CONTACT ISLANDS ---
+// ====================================================================
+
+static int find_island_root(int *parent, int body)
+{
+    while (parent[body] != body)
+    {
+        parent[body] = parent[parent[body]]; // path halving
+        body = parent[body];
+    }
+    return body;
+}
+
+void collisionSystem::solve_contact_islands(world &simulation_world, const CandidatePairs &contacts, ContactManifold *manifolds, uint8_t *resolved)
+{
+    FrameArena &arena = simulation_world.frame_arena;
+    const float *inv_mass = simulation_world.inv_mass.data();
+    const size_t n = simulation_world.size();
+    const size_t count = contacts.count;
 
-    // Narrow phase timing
-    auto t_n0 = std::chrono::high_resolution_clock::now();
-    for (auto &[idxA, idxB] : potential_pairs)
+    // 1. Union-find over the dynamic bodies of each contact. Static bodies are
+    //    not written by the resolver, so they do not link islands together.
+    int *parent = arena.allocate<int>(n);
+    std::iota(parent, parent + n, 0);
+    for (size_t p = 0; p < count; ++p)
     {
-        float invA = simulation_world.inv_mass[idxA];
-        float invB = simulation_world.inv_mass[idxB];
-        if (invA == 0.0f && invB == 0.0f)
+        auto [idxA, idxB] = contacts.pairs[p];
+        if (inv_mass[idxA] <= 0.0f || inv_mass[idxB] <= 0.0f)
             continue;
+        int root_A = find_island_root(parent, idxA);
+        int root_B = find_island_root(parent, idxB);
+        if (root_A != root_B)
+            parent[std::max(root_A, root_B)] = std::min(root_A, root_B);
+    }
 
-        if (check_for_overlap(idxA, idxB, simulation_world))
+    // 2. Counting sort of the contacts by island (CSR), keeping contact order
+    //    inside each island
+    int *root_island = arena.allocate<int>(n);
+    std::fill(root_island, root_island + n, -1);
+    int *contact_island = arena.allocate<int>(count);
+    int num_islands = 0;
+    for (size_t p = 0; p < count; ++p)
+    {
+        auto [idxA, idxB] = contacts.pairs[p];
+        int root = find_island_root(parent, inv_mass[idxA] > 0.0f ? idxA : idxB);
+        if (root_island[root] < 0)
+            root_island[root] = num_islands++;
+        contact_island[p] = root_island[root];
+    }
+    int *island_start = arena.allocate<int>(num_islands + 1);
+    std::fill(island_start, island_start + num_islands + 1, 0);
+    for (size_t p = 0; p < count; ++p)
+        ++island_start[contact_island[p] + 1];
+    for (int k = 0; k < num_islands; ++k)
+        island_start[k + 1] += island_start[k];
+    int *island_contacts = arena.allocate<int>(count);
+    int *cursor = arena.allocate<int>(num_islands);
+    std::copy(island_start, island_start + num_islands, cursor);
+    for (size_t p = 0; p < count; ++p)
+        island_contacts[cursor[contact_island[p]]++] = int(p);
+
+    // 3. Largest islands first: workers pull the next island from a shared
+    //    cursor, so the tail of the step is made of the small ones.
+    int *order = arena.allocate<int>(num_islands);
+    std::iota(order, order + num_islands, 0);
+    std::sort(order, order + num_islands, [&](int a, int b)
+    {
+        int size_a = island_start[a + 1] - island_start[a];
+        int size_b = island_start[b + 1] - island_start[b];
+        return size_a != size_b ? size_a > size_b : a < b;
+    });
+
+    auto solve_island = [&](int island)
+    {
+        for (int k = island_start[island]; k < island_start[island + 1]; ++k)
         {
-            auto t_r0 = std::chrono::high_resolution_clock::now();
-            resolve_contact_with_impulse(idxA, idxB, simulation_world);
-            auto t_r1 = std::chrono::high_resolution_clock::now();
-            auto resolve_us = std::chrono::duration_cast<std::chrono::microseconds>(t_r1 - t_r0).count();
-            simulation_world.resolve_phase_us += (unsigned long long)resolve_us;
+            int p = island_contacts[k];
+            auto [idxA, idxB] = contacts.pairs[p];
+            resolved[p] = resolve_contact_with_impulse(idxA, idxB, simulation_world, manifolds[p]) ? 1 : 0;
         }
+    };
+
+    if (pool && pool->size() > 1 && num_islands > 1)
+    {
+        std::atomic<int> next_island{0};
+        pool->run([&](unsigned)
+        {
+            for (int k = next_island.fetch_add(1, std::memory_order_relaxed); k < num_islands; k = next_island.fetch_add(1, std::memory_order_relaxed))
+                solve_island(order[k]);
+        });
     }
-    auto t_n1 = std::chrono::high_resolution_clock::now();
-    auto narrow_us = std::chrono::duration_cast<std::chrono::microseconds>(t_n1 - t_n0).count();
-    simulation_world.narrow_phase_us = (unsigned long long)narrow_us;
+    else
+    {
+        for (int k = 0; k < num_islands; ++k)
+            solve_island(order[k]);
+    }
+    simulation_world.contact_island_count = size_t(num_islands);
+    simulation_world.contact_batch_count = 0;
 }
 
 // ====================================================================
-// --- CONTACT RESOLUTION (Impulse and Position Correction) ---
+// --- SIMD CONTACT BATCHES ---
 // ====================================================================
 
-void collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &simulation_world)
+// Contact rows of one step, SoA, grouped by colour. The rows of a colour
+// share no dynamic body and start on a multiple of CONTACT_BATCH_WIDTH, so
+// each batch of CONTACT_BATCH_WIDTH rows is one aligned SSE load per column.
+// Unused rows at the end of a colour are masked out (in_contact 0) and point
+// at body 0. Normal, penetration, correction and the masses are computed once
+// from the positions at the start of the resolve.
+struct ContactRows
 {
-    vec2 posA(simulation_world.position_x[idxA], simulation_world.position_y[idxA]);
-    vec2 posB(simulation_world.position_x[idxB], simulation_world.position_y[idxB]);
-    vec2 displacement_vector = posB - posA;
-    float distance_squared = dot(displacement_vector, displacement_vector);
+    size_t num_rows = 0;
+    size_t num_batches = 0;
+    int *contact;      // Index into the candidate pairs (-1 for padding)
+    int *body_a, *body_b;
+    float *normal_x, *normal_y;
+    float *penetration;
+    float *correction; // Positional correction along the normal (0 when not in contact)
+    float *inverse_mass_a, *inverse_mass_b, *inverse_mass_sum;
+    float *radius_a, *radius_b;
+    float *restitution;
+    int *in_contact;   // -1 where the pair touches
+    // Contacts whose bodies ran out of colours: resolved one by one afterwards
+    int *overflow;
+    size_t num_overflow = 0;
+};
 
-    if (distance_squared <= 1e-6f)
-        return;
+// Row columns are loaded whole into SSE registers: 16-byte aligned
+template <typename T>
+static T *allocate_rows(FrameArena &arena, size_t count)
+{
+    return static_cast<T *>(arena.allocate_bytes(count * sizeof(T), 16));
+}
 
-    float distance = std::sqrt(distance_squared);
-    float sum_of_radii = simulation_world.radius[idxA] + simulation_world.radius[idxB];
-    float penetration_depth = sum_of_radii - distance;
-    if (penetration_depth <= 0.0f)
-        return;
+// Colours every contact once per step: each takes the lowest colour free on
+// both of its dynamic bodies (one 64-bit mask per body; static bodies are
+// never written, so they may repeat), then rows are counting-sorted by colour
+// keeping the contact (cell) order inside a colour.
+static ContactRows pack_contact_rows(world &simulation_world, const CandidatePairs &contacts)
+{
+    FrameArena &arena = simulation_world.frame_arena;
+    const float *inv_mass = simulation_world.inv_mass.data();
+    const size_t n = simulation_world.size();
+    const int overflow = CONTACT_BATCH_COLORS;
 
-    vec2 collision_normal = displacement_vector * (1.0f / distance);
+    uint64_t *body_colors = arena.allocate<uint64_t>(n);
+    std::fill(body_colors, body_colors + n, uint64_t(0));
+    uint8_t *contact_color = arena.allocate<uint8_t>(contacts.count);
+    size_t color_count[CONTACT_BATCH_COLORS + 1] = {};
+    for (size_t p = 0; p < contacts.count; ++p)
+    {
+        auto [idxA, idxB] = contacts.pairs[p];
+        const bool dynamic_a = inv_mass[idxA] > 0.0f;
+        const bool dynamic_b = inv_mass[idxB] > 0.0f;
+        uint64_t used = (dynamic_a ? body_colors[idxA] : 0) | (dynamic_b ? body_colors[idxB] : 0);
+        int color = ~used ? __builtin_ctzll(~used) : overflow;
+        if (color != overflow)
+        {
+            if (dynamic_a)
+                body_colors[idxA] |= uint64_t(1) << color;
+            if (dynamic_b)
+                body_colors[idxB] |= uint64_t(1) << color;
+        }
+        contact_color[p] = uint8_t(color);
+        ++color_count[color];
+    }
 
-    float inverse_mass_A = simulation_world.inv_mass[idxA];
-    float inverse_mass_B = simulation_world.inv_mass[idxB];
-    float inverse_mass_sum = inverse_mass_A + inverse_mass_B;
-    if (inverse_mass_sum <= 0.0f)
-        return;
+    // Colour starts, each rounded up to a whole batch
+    ContactRows rows;
+    size_t cursor[CONTACT_BATCH_COLORS];
+    for (int c = 0; c < overflow; ++c)
+    {
+        cursor[c] = rows.num_rows;
+        size_t batches = (color_count[c] + CONTACT_BATCH_WIDTH - 1) / CONTACT_BATCH_WIDTH;
+        rows.num_batches += batches;
+        rows.num_rows += batches * CONTACT_BATCH_WIDTH;
+    }
+    const size_t m = rows.num_rows;
+    rows.contact = allocate_rows<int>(arena, m);
+    std::fill(rows.contact, rows.contact + m, -1);
+    rows.overflow = arena.allocate<int>(color_count[overflow]);
+    for (size_t p = 0; p < contacts.count; ++p)
+    {
+        if (contact_color[p] == overflow)
+            rows.overflow[rows.num_overflow++] = int(p);
+        else
+            rows.contact[cursor[contact_color[p]]++] = int(p);
+    }
 
-    float correction_magnitude = std::max(penetration_depth - POSITION_CORRECTION_SLOP, 0.0f) / inverse_mass_sum * POSITION_CORRECTION_PERCENT;
-    vec2 position_correction_vector = collision_normal * correction_magnitude;
-
-    // Apply correction to SoA positions
-    simulation_world.position_x[idxA] -= position_correction_vector.x * inverse_mass_A;
-    simulation_world.position_y[idxA] -= position_correction_vector.y * inverse_mass_A;
-    simulation_world.position_x[idxB] += position_correction_vector.x * inverse_mass_B;
-    simulation_world.position_y[idxB] += position_correction_vector.y * inverse_mass_B;
-
-    // velocities
-    vec2 velA(simulation_world.vel_x[idxA], simulation_world.vel_y[idxA]);
-    vec2 velB(simulation_world.vel_x[idxB], simulation_world.vel_y[idxB]);
-    vec2 relative_velocity = velB - velA;
-    float velocity_along_normal = dot(relative_velocity, collision_normal);
-    if (velocity_along_normal > 0.0f)
-        return;
+    rows.body_a = allocate_rows<int>(arena, m);
+    rows.body_b = allocate_rows<int>(arena, m);
+    rows.normal_x = allocate_rows<float>(arena, m);
+    rows.normal_y = allocate_rows<float>(arena, m);
+    rows.penetration = allocate_rows<float>(arena, m);
+    rows.correction = allocate_rows<float>(arena, m);
+    rows.inverse_mass_a = allocate_rows<float>(arena, m);
+    rows.inverse_mass_b = allocate_rows<float>(arena, m);
+    rows.inverse_mass_sum = allocate_rows<float>(arena, m);
+    rows.radius_a = allocate_rows<float>(arena, m);
+    rows.radius_b = allocate_rows<float>(arena, m);
+    rows.restitution = allocate_rows<float>(arena, m);
+    rows.in_contact = allocate_rows<int>(arena, m);
+    return rows;
+}
+
+#if defined(__SSE2__)
+static inline __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Four lanes of one body column, gathered straight into a register
+static inline __m128 gather_ps(const float *column, const int *index)
+{
+    return _mm_setr_ps(column[index[0]], column[index[1]], column[index[2]], column[index[3]]);
+}
+
+// Minimum image on one periodic axis, as GridInfo::minimum_image_x/y
+static inline __m128 minimum_image_ps(__m128 d, float period)
+{
+    __m128 half = _mm_set1_ps(0.5f * period);
+    __m128 full = _mm_set1_ps(period);
+    __m128 wrapped_low = select_ps(_mm_cmplt_ps(d, _mm_sub_ps(_mm_setzero_ps(), half)), _mm_add_ps(d, full), d);
+    return select_ps(_mm_cmpgt_ps(d, half), _mm_sub_ps(d, full), wrapped_low);
+}
+
+// Per-row constants, a batch at a time, with the arithmetic of
+// resolve_circle_contact so that rows without shared bodies resolve exactly
+// as the scalar loop.
+static void prepare_contact_rows(ContactRows &rows, const world &simulation_world, const CandidatePairs &contacts)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    const float *px = simulation_world.position_x.data();
+    const float *py = simulation_world.position_y.data();
+    const float *inv_mass = simulation_world.inv_mass.data();
+    const float *radius = simulation_world.radius.data();
+    const float *restitution = simulation_world.restitution.data();
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 min_distance_squared = _mm_set1_ps(1e-6f);
+    const __m128 slop = _mm_set1_ps(POSITION_CORRECTION_SLOP);
+    const __m128 percent = _mm_set1_ps(POSITION_CORRECTION_PERCENT);
+    for (size_t r = 0; r < rows.num_rows; r += CONTACT_BATCH_WIDTH)
+    {
+        int *a = rows.body_a + r;
+        int *b = rows.body_b + r;
+        for (int k = 0; k < CONTACT_BATCH_WIDTH; ++k)
+        {
+            const int p = rows.contact[r + k];
+            a[k] = p < 0 ? 0 : contacts.pairs[p].first;
+            b[k] = p < 0 ? 0 : contacts.pairs[p].second;
+        }
+        __m128 dx = _mm_sub_ps(gather_ps(px, b), gather_ps(px, a));
+        __m128 dy = _mm_sub_ps(gather_ps(py, b), gather_ps(py, a));
+        if (grid.wraps_x())
+            dx = minimum_image_ps(dx, grid.period_x());
+        if (grid.wraps_y())
+            dy = minimum_image_ps(dy, grid.period_y());
+        __m128 inv_mass_a = gather_ps(inv_mass, a);
+        __m128 inv_mass_b = gather_ps(inv_mass, b);
+        __m128 radius_a = gather_ps(radius, a);
+        __m128 radius_b = gather_ps(radius, b);
+        __m128 distance_squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 distance = _mm_sqrt_ps(distance_squared);
+        __m128 penetration = _mm_sub_ps(_mm_add_ps(radius_a, radius_b), distance);
+        __m128 inverse_mass_sum = _mm_add_ps(inv_mass_a, inv_mass_b);
+        __m128 real_row = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(rows.contact + r)), _mm_set1_epi32(-1)));
+        __m128 touching = _mm_and_ps(_mm_and_ps(real_row, _mm_cmpgt_ps(distance_squared, min_distance_squared)),
+                                     _mm_and_ps(_mm_cmpgt_ps(penetration, zero), _mm_cmpgt_ps(inverse_mass_sum, zero)));
+        inverse_mass_sum = select_ps(touching, inverse_mass_sum, one);
+        __m128 inverse_distance = _mm_and_ps(touching, _mm_div_ps(one, select_ps(touching, distance, one)));
+        __m128 correction = _mm_mul_ps(_mm_div_ps(_mm_max_ps(_mm_sub_ps(penetration, slop), zero), inverse_mass_sum), percent);
+        _mm_store_ps(rows.normal_x + r, _mm_mul_ps(dx, inverse_distance));
+        _mm_store_ps(rows.normal_y + r, _mm_mul_ps(dy, inverse_distance));
+        _mm_store_ps(rows.penetration + r, penetration);
+        _mm_store_ps(rows.correction + r, _mm_and_ps(touching, correction));
+        _mm_store_ps(rows.inverse_mass_a + r, inv_mass_a);
+        _mm_store_ps(rows.inverse_mass_b + r, inv_mass_b);
+        _mm_store_ps(rows.inverse_mass_sum + r, inverse_mass_sum);
+        _mm_store_ps(rows.radius_a + r, radius_a);
+        _mm_store_ps(rows.radius_b + r, radius_b);
+        _mm_store_ps(rows.restitution + r, _mm_mul_ps(_mm_add_ps(gather_ps(restitution, a), gather_ps(restitution, b)), half));
+        _mm_store_si128(reinterpret_cast<__m128i *>(rows.in_contact + r), _mm_castps_si128(touching));
+    }
+}
+
+// Solves one batch of CONTACT_BATCH_WIDTH rows starting at row r: gathers the
+// bodies' positions and velocities, applies the correction and the impulse
+// in registers and scatters them to the dynamic bodies of touching lanes.
+static void solve_contact_batch(const ContactRows &rows, size_t r, world &simulation_world, ContactManifold *manifolds, uint8_t *resolved)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    const float dt = simulation_world.delta_time;
+    float *px = simulation_world.position_x.data();
+    float *py = simulation_world.position_y.data();
+    float *prev_x = simulation_world.previous_position_x.data();
+    float *prev_y = simulation_world.previous_position_y.data();
+    float *vx = simulation_world.vel_x.data();
+    float *vy = simulation_world.vel_y.data();
+    const int *a = rows.body_a + r;
+    const int *b = rows.body_b + r;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 in_contact = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(rows.in_contact + r)));
+    const __m128 nx = _mm_load_ps(rows.normal_x + r);
+    const __m128 ny = _mm_load_ps(rows.normal_y + r);
+    const __m128 inv_mass_a = _mm_load_ps(rows.inverse_mass_a + r);
+    const __m128 inv_mass_b = _mm_load_ps(rows.inverse_mass_b + r);
+
+    // 1. Positional correction
+    __m128 correction = _mm_load_ps(rows.correction + r);
+    __m128 cx = _mm_mul_ps(nx, correction);
+    __m128 cy = _mm_mul_ps(ny, correction);
+    __m128 pax = _mm_sub_ps(gather_ps(px, a), _mm_mul_ps(cx, inv_mass_a));
+    __m128 pay = _mm_sub_ps(gather_ps(py, a), _mm_mul_ps(cy, inv_mass_a));
+    __m128 pbx = _mm_add_ps(gather_ps(px, b), _mm_mul_ps(cx, inv_mass_b));
+    __m128 pby = _mm_add_ps(gather_ps(py, b), _mm_mul_ps(cy, inv_mass_b));
+
+    // 2. Restitution impulse for approaching pairs
+    __m128 vax = gather_ps(vx, a);
+    __m128 vay = gather_ps(vy, a);
+    __m128 vbx = gather_ps(vx, b);
+    __m128 vby = gather_ps(vy, b);
+    __m128 velocity_along_normal = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(vbx, vax), nx), _mm_mul_ps(_mm_sub_ps(vby, vay), ny));
+    __m128 approaching = _mm_and_ps(in_contact, _mm_cmple_ps(velocity_along_normal, zero));
+    __m128 impulse = _mm_mul_ps(_mm_xor_ps(_mm_add_ps(one, _mm_load_ps(rows.restitution + r)), sign), velocity_along_normal);
+    impulse = _mm_and_ps(approaching, _mm_div_ps(impulse, _mm_load_ps(rows.inverse_mass_sum + r)));
+    __m128 ix = _mm_mul_ps(nx, impulse);
+    __m128 iy = _mm_mul_ps(ny, impulse);
+    vax = _mm_sub_ps(vax, _mm_mul_ps(ix, inv_mass_a));
+    vay = _mm_sub_ps(vay, _mm_mul_ps(iy, inv_mass_a));
+    vbx = _mm_add_ps(vbx, _mm_mul_ps(ix, inv_mass_b));
+    vby = _mm_add_ps(vby, _mm_mul_ps(iy, inv_mass_b));
+
+    // 3. Previous positions follow the new velocities (before clamping), then
+    //    approaching pairs are kept inside the walls and snap tiny velocities
+    const __m128 step = _mm_set1_ps(dt);
+    alignas(16) float out_prev[4][CONTACT_BATCH_WIDTH];
+    _mm_store_ps(out_prev[0], _mm_sub_ps(pax, _mm_mul_ps(vax, step)));
+    _mm_store_ps(out_prev[1], _mm_sub_ps(pay, _mm_mul_ps(vay, step)));
+    _mm_store_ps(out_prev[2], _mm_sub_ps(pbx, _mm_mul_ps(vbx, step)));
+    _mm_store_ps(out_prev[3], _mm_sub_ps(pby, _mm_mul_ps(vby, step)));
+    const __m128 boundary_eps = _mm_set1_ps(BOUNDARY_EPS);
+    auto clamp = [&](__m128 p, __m128 radius, float low, float high)
+    {
+        __m128 inside = _mm_min_ps(_mm_max_ps(p, _mm_add_ps(_mm_add_ps(_mm_set1_ps(low), radius), boundary_eps)),
+                                   _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(high), radius), boundary_eps));
+        return select_ps(approaching, inside, p);
+    };
+    const __m128 radius_a = _mm_load_ps(rows.radius_a + r);
+    const __m128 radius_b = _mm_load_ps(rows.radius_b + r);
+    if (!grid.wraps_x())
+    {
+        pax = clamp(pax, radius_a, grid.min_x, grid.max_x);
+        pbx = clamp(pbx, radius_b, grid.min_x, grid.max_x);
+    }
+    if (!grid.wraps_y())
+    {
+        pay = clamp(pay, radius_a, grid.min_y, grid.max_y);
+        pby = clamp(pby, radius_b, grid.min_y, grid.max_y);
+    }
+    const __m128 velocity_epsilon = _mm_set1_ps(VELOCITY_EPSILON);
+    auto snap = [&](__m128 v) { return _mm_andnot_ps(_mm_and_ps(approaching, _mm_cmplt_ps(_mm_andnot_ps(sign, v), velocity_epsilon)), v); };
+    alignas(16) float out_pos[4][CONTACT_BATCH_WIDTH];
+    alignas(16) float out_vel[4][CONTACT_BATCH_WIDTH];
+    alignas(16) float out_impulse[CONTACT_BATCH_WIDTH];
+    _mm_store_ps(out_pos[0], pax);
+    _mm_store_ps(out_pos[1], pay);
+    _mm_store_ps(out_pos[2], pbx);
+    _mm_store_ps(out_pos[3], pby);
+    _mm_store_ps(out_vel[0], snap(vax));
+    _mm_store_ps(out_vel[1], snap(vay));
+    _mm_store_ps(out_vel[2], snap(vbx));
+    _mm_store_ps(out_vel[3], snap(vby));
+    _mm_store_ps(out_impulse, impulse);
+    const int approaching_lanes = _mm_movemask_ps(approaching);
 
+    // 4. Scatter touching lanes to their dynamic bodies
+    for (int k = 0; k < CONTACT_BATCH_WIDTH; ++k)
+    {
+        const int p = rows.contact[r + k];
+        if (p < 0)
+            continue;
+        resolved[p] = rows.in_contact[r + k] ? 1 : 0;
+        if (!resolved[p])
+            continue;
+        const bool lane_approaching = (approaching_lanes >> k) & 1;
+        const bool update_previous = lane_approaching && dt > 0.0f;
+        const int body_a = a[k], body_b = b[k];
+        if (rows.inverse_mass_a[r + k] > 0.0f)
+        {
+            px[body_a] = out_pos[0][k];
+            py[body_a] = out_pos[1][k];
+            if (lane_approaching)
+            {
+                vx[body_a] = out_vel[0][k];
+                vy[body_a] = out_vel[1][k];
+            }
+            if (update_previous)
+            {
+                prev_x[body_a] = out_prev[0][k];
+                prev_y[body_a] = out_prev[1][k];
+            }
+        }
+        if (rows.inverse_mass_b[r + k] > 0.0f)
+        {
+            px[body_b] = out_pos[2][k];
+            py[body_b] = out_pos[3][k];
+            if (lane_approaching)
+            {
+                vx[body_b] = out_vel[2][k];
+                vy[body_b] = out_vel[3][k];
+            }
+            if (update_previous)
+            {
+                prev_x[body_b] = out_prev[2][k];
+                prev_y[body_b] = out_prev[3][k];
+            }
+        }
+        ContactManifold &manifold = manifolds[p];
+        manifold.body_A = body_a;
+        manifold.body_B = body_b;
+        manifold.normal_direction = vec2(rows.normal_x[r + k], rows.normal_y[r + k]);
+        manifold.penetration_depth = rows.penetration[r + k];
+        manifold.effective_restitution = rows.restitution[r + k];
+        manifold.inverse_mass_sum = rows.inverse_mass_sum[r + k];
+        manifold.normal_impulse = out_impulse[k];
+    }
+}
+#endif
+
+void collisionSystem::solve_contact_batches(world &simulation_world, const CandidatePairs &contacts, ContactManifold *manifolds, uint8_t *resolved)
+{
+    simulation_world.contact_island_count = 0;
+    // Bodies without a restitution entry bounce with 1, as in world::get_restitution
+    if (simulation_world.restitution.size() != simulation_world.size())
+        simulation_world.restitution.resize(simulation_world.size(), 1.0f);
+
+    ContactRows rows = pack_contact_rows(simulation_world, contacts);
+    simulation_world.contact_batch_count = rows.num_batches;
+#if defined(__SSE2__)
+    prepare_contact_rows(rows, simulation_world, contacts);
+    for (size_t r = 0; r < rows.num_rows; r += CONTACT_BATCH_WIDTH)
+        solve_contact_batch(rows, r, simulation_world, manifolds, resolved);
+#else
+    for (size_t r = 0; r < rows.num_rows; ++r)
+    {
+        const int p = rows.contact[r];
+        if (p >= 0)
+            resolved[p] = resolve_contact_with_impulse(contacts.pairs[p].first, contacts.pairs[p].second, simulation_world, manifolds[p]) ? 1 : 0;
+    }
+#endif
+    for (size_t k = 0; k < rows.num_overflow; ++k)
+    {
+        const int p = rows.overflow[k];
+        resolved[p] = resolve_contact_with_impulse(contacts.pairs[p].first, contacts.pairs[p].second, simulation_world, manifolds[p]) ? 1 : 0;
+    }
+}
+
+// ====================================================================
+// --- CONTACT RESOLUTION (Impulse and Position Correction) ---
+// ====================================================================
+
+bool collisionSystem::resolve_contact_with_impulse(int idxA, int idxB, world &simulation_world, ContactManifold &manifold)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    float dx = grid.minimum_image_x(simulation_world.position_x[idxB] - simulation_world.position_x[idxA]);
+    float dy = grid.minimum_image_y(simulation_world.position_y[idxB] - simulation_world.position_y[idxA]);
     float effective_restitution = (simulation_world.get_restitution(idxA) + simulation_world.get_restitution(idxB)) * 0.5f;
 
-    float impulse_scalar = -(1.0f + effective_restitution) * velocity_along_normal;
-    impulse_scalar /= inverse_mass_sum;
-    vec2 collision_impulse_vector = collision_normal * impulse_scalar;
+    ContactBodyColumns bodies{simulation_world.position_x.data(), simulation_world.position_y.data(),
+                              simulation_world.previous_position_x.data(), simulation_world.previous_position_y.data(),
+                              simulation_world.vel_x.data(), simulation_world.vel_y.data(),
+                              simulation_world.inv_mass.data(), simulation_world.radius.data()};
+    // Periodic axes have no walls; solve_boundary_contacts wraps them instead
+    ContactWalls walls{grid.min_x, grid.max_x, grid.min_y, grid.max_y, !grid.wraps_x(), !grid.wraps_y()};
+    ContactResult result = resolve_circle_contact(bodies, idxA, idxB, dx, dy, effective_restitution, simulation_world.delta_time, walls);
+    if (!result.in_contact)
+        return false;
 
-    velA = velA - collision_impulse_vector * inverse_mass_A;
-    velB = velB + collision_impulse_vector * inverse_mass_B;
+    manifold.body_A = idxA;
+    manifold.body_B = idxB;
+    manifold.normal_direction = vec2(result.normal_x, result.normal_y);
+    manifold.penetration_depth = result.penetration_depth;
+    manifold.effective_restitution = effective_restitution;
+    manifold.inverse_mass_sum = result.inverse_mass_sum;
+    manifold.normal_impulse = result.normal_impulse;
+    return true;
+}
 
-    simulation_world.vel_x[idxA] = velA.x;
-    simulation_world.vel_y[idxA] = velA.y;
-    simulation_world.vel_x[idxB] = velB.x;
-    simulation_world.vel_y[idxB] = velB.y;
+// ====================================================================
+// --- STATIC GEOMETRY (Segments and Polygons) ---
+// ====================================================================
 
-    // Update previous positions for Verlet consistency
+void collisionSystem::solve_static_contacts(world &simulation_world)
+{
+    StaticGeometry &geometry = simulation_world.static_geometry;
+    if (geometry.size() == 0)
+        return;
+    if (geometry.needs_bake())
+        geometry.bake(simulation_world.grid_info);
+
+    size_t n = simulation_world.position_x.size();
     float dt = simulation_world.delta_time;
-    if (dt > 0.0f)
+    for (size_t i = 0; i < n; ++i)
     {
-        simulation_world.previous_position_x[idxA] = simulation_world.position_x[idxA] - velA.x * dt;
-        simulation_world.previous_position_y[idxA] = simulation_world.position_y[idxA] - velA.y * dt;
-        simulation_world.previous_position_x[idxB] = simulation_world.position_x[idxB] - velB.x * dt;
-        simulation_world.previous_position_y[idxB] = simulation_world.position_y[idxB] - velB.y * dt;
-    }
+        if (simulation_world.inv_mass[i] == 0.0f)
+            continue;
 
-    // Ensure positions are nudged slightly outward to avoid exact-contact re-penetration
-    const float BOUNDARY_EPS = 1e-4f;
-    // clamp A
-    float min_x = simulation_world.grid_info.min_x;
-    float max_x = simulation_world.grid_info.max_x;
-    float min_y = simulation_world.grid_info.min_y;
-    float max_y = simulation_world.grid_info.max_y;
-    float rA = simulation_world.radius[idxA];
-    float rB = simulation_world.radius[idxB];
-    simulation_world.position_x[idxA] = std::min(std::max(simulation_world.position_x[idxA], min_x + rA + BOUNDARY_EPS), max_x - rA - BOUNDARY_EPS);
-    simulation_world.position_y[idxA] = std::min(std::max(simulation_world.position_y[idxA], min_y + rA + BOUNDARY_EPS), max_y - rA - BOUNDARY_EPS);
-    simulation_world.position_x[idxB] = std::min(std::max(simulation_world.position_x[idxB], min_x + rB + BOUNDARY_EPS), max_x - rB - BOUNDARY_EPS);
-    simulation_world.position_y[idxB] = std::min(std::max(simulation_world.position_y[idxB], min_y + rB + BOUNDARY_EPS), max_y - rB - BOUNDARY_EPS);
+        float px = simulation_world.position_x[i];
+        float py = simulation_world.position_y[i];
+        float vx = simulation_world.vel_x[i];
+        float vy = simulation_world.vel_y[i];
+        float r = simulation_world.radius[i];
+        bool touched = false;
+
+        geometry.for_each_circle_contact(px, py, r, simulation_world.get_collision_category(i), simulation_world.get_collision_mask(i), [&](const StaticContact &found)
+        {
+            // Re-test at the corrected position: a circle on the joint of two
+            // chained segments must only be pushed out once.
+            StaticContact contact;
+            if (!geometry.collide_circle(found.shape, px, py, r, contact))
+                return;
+            touched = true;
+            px += contact.normal.x * contact.penetration_depth;
+            py += contact.normal.y * contact.penetration_depth;
+            float velocity_along_normal = vx * contact.normal.x + vy * contact.normal.y;
+            if (velocity_along_normal < 0.0f)
+            {
+                float restitution = (simulation_world.get_restitution(i) + geometry.shape_restitution[contact.shape]) * 0.5f;
+                float bounce = (1.0f + restitution) * velocity_along_normal;
+                vx -= contact.normal.x * bounce;
+                vy -= contact.normal.y * bounce;
+            }
+        });
+        if (!touched)
+            continue;
 
-    // 4. LOW-VELOCITY ELIMINATION (Sleeping) - operate on SoA velocities
-    if (std::fabs(simulation_world.vel_x[idxA]) < VELOCITY_EPSILON)
-        simulation_world.vel_x[idxA] = 0.0f;
-    if (std::fabs(simulation_world.vel_y[idxA]) < VELOCITY_EPSILON)
-        simulation_world.vel_y[idxA] = 0.0f;
-    if (std::fabs(simulation_world.vel_x[idxB]) < VELOCITY_EPSILON)
-        simulation_world.vel_x[idxB] = 0.0f;
-    if (std::fabs(simulation_world.vel_y[idxB]) < VELOCITY_EPSILON)
-        simulation_world.vel_y[idxB] = 0.0f;
+        if (std::fabs(vx) < VELOCITY_EPSILON)
+            vx = 0.0f;
+        if (std::fabs(vy) < VELOCITY_EPSILON)
+            vy = 0.0f;
+        simulation_world.position_x[i] = px;
+        simulation_world.position_y[i] = py;
+        simulation_world.vel_x[i] = vx;
+        simulation_world.vel_y[i] = vy;
+        if (dt > 0.0f)
+        {
+            simulation_world.previous_position_x[i] = px - vx * dt;
+            simulation_world.previous_position_y[i] = py - vy * dt;
+        }
+    }
 }
 
 // ====================================================================
 // --- WORLD BOUNDARY (Boundary) ---
 // ====================================================================
 
+void collisionSystem::wrap_periodic_positions(world &simulation_world)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    size_t n = simulation_world.position_x.size();
+    // Verlet velocity lives in (position - previous_position): shift both together
+    auto wrap_axis = [&](std::vector<float> &position, std::vector<float> &previous, float min, float period)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            float offset = position[i] - min;
+            if (offset >= 0.0f && offset < period)
+                continue;
+            float shift = std::floor(offset / period) * period;
+            position[i] -= shift;
+            if (i < previous.size())
+                previous[i] -= shift;
+            // Rounding can land exactly on the far edge
+            if (position[i] >= min + period)
+                position[i] = min;
+        }
+    };
+    if (grid.wraps_x())
+        wrap_axis(simulation_world.position_x, simulation_world.previous_position_x, grid.min_x, grid.period_x());
+    if (grid.wraps_y())
+        wrap_axis(simulation_world.position_y, simulation_world.previous_position_y, grid.min_y, grid.period_y());
+}
+
 void collisionSystem::solve_boundary_contacts(world &simulation_world)
 {
     size_t n = simulation_world.position_x.size();
@@ -273,6 +1412,10 @@ void collisionSystem::solve_boundary_contacts(world &simulation_world)
     float min_y = simulation_world.grid_info.min_y;
     float max_y = simulation_world.grid_info.max_y;
     const float ground_y_limit = 0.0f;
+    const bool walls_x = !simulation_world.grid_info.wraps_x();
+    const bool walls_y = !simulation_world.grid_info.wraps_y();
+    if (!walls_x || !walls_y)
+        wrap_periodic_positions(simulation_world);
 
     for (size_t i = 0; i < n; ++i)
     {
@@ -286,28 +1429,28 @@ void collisionSystem::solve_boundary_contacts(world &simulation_world)
         float r = simulation_world.radius[i];
         float restitution = simulation_world.get_restitution(i);
 
-        if (py - r < ground_y_limit)
+        if (walls_y && py - r < ground_y_limit)
         {
             py = ground_y_limit + r;
             if (vy < 0.0f)
                 vy = -vy * restitution;
         }
 
-        if (px - r < min_x)
+        if (walls_x && px - r < min_x)
         {
             px = min_x + r;
             if (vx < 0.0f)
                 vx = -vx * restitution;
         }
 
-        if (px + r > max_x)
+        if (walls_x && px + r > max_x)
         {
             px = max_x - r;
             if (vx > 0.0f)
                 vx = -vx * restitution;
         }
 
-        if (py + r > max_y)
+        if (walls_y && py + r > max_y)
         {
             py = max_y - r;
             if (vy > 0.0f)
@@ -333,8 +1476,10 @@ void collisionSystem::solve_boundary_contacts(world &simulation_world)
         // small inward nudge to avoid exact contact with boundaries which can cause
         // re-penetration or sticky behavior due to floating point rounding.
         const float NUDGE = 1e-4f;
-        simulation_world.position_x[i] = std::min(std::max(simulation_world.position_x[i], min_x + r + NUDGE), max_x - r - NUDGE);
-        simulation_world.position_y[i] = std::min(std::max(simulation_world.position_y[i], min_y + r + NUDGE), max_y - r - NUDGE);
+        if (walls_x)
+            simulation_world.position_x[i] = std::min(std::max(simulation_world.position_x[i], min_x + r + NUDGE), max_x - r - NUDGE);
+        if (walls_y)
+            simulation_world.position_y[i] = std::min(std::max(simulation_world.position_y[i], min_y + r + NUDGE), max_y - r - NUDGE);
         // SoA arrays are canonical.
     }
 }
@@ -343,15 +1488,47 @@ void collisionSystem::solve_boundary_contacts(world &simulation_world)
 // --- MAIN UPDATE LOOP ---
 // ====================================================================
 
+CandidatePairs collisionSystem::collect_candidate_pairs(world &simulation_world)
+{
+    if (simulation_world.grid_info.wraps_x() || simulation_world.grid_info.wraps_y())
+        wrap_periodic_positions(simulation_world);
+    if (!simulation_world.incremental_grid || !update_spatial_grid_incremental(simulation_world))
+    {
+        clear_spatial_grid(simulation_world);
+        populate_spatial_grid(simulation_world);
+    }
+    auto t_b0 = std::chrono::high_resolution_clock::now();
+    CandidatePairs candidates = broad_phase_generate_pairs(simulation_world);
+    auto t_b1 = std::chrono::high_resolution_clock::now();
+    simulation_world.broad_phase_us = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(t_b1 - t_b0).count();
+    simulation_world.narrow_phase_us = 0;
+    return candidates;
+}
+
 void collisionSystem::update(world &simulation_world, float delta_time)
 {
-    // 1. Preparation phase (Spatial Hashing)
-    clear_spatial_grid(simulation_world);
-    populate_spatial_grid(simulation_world);
+    // XPBD worlds are stepped (contacts included) by xpbdSystem
+    if (simulation_world.integrator == IntegratorMode::XPBD)
+        return;
+    // Temporaries of earlier systems (or steps) are dead; recycle their memory.
+    simulation_world.frame_arena.reset();
+
+    // 1. Preparation phase (Spatial Hashing). Bodies that crossed a periodic
+    //    edge during integration are wrapped back first so they get binned.
+    if (simulation_world.grid_info.wraps_x() || simulation_world.grid_info.wraps_y())
+        wrap_periodic_positions(simulation_world);
+    if (!simulation_world.incremental_grid || !update_spatial_grid_incremental(simulation_world))
+    {
+        clear_spatial_grid(simulation_world);
+        populate_spatial_grid(simulation_world);
+    }
 
     // 2. Body-Body collisions (Broad and Narrow Phase)
     narrow_phase_check_and_resolve(simulation_world);
 
-    // 3. World boundary collisions
+    // 3. Static level geometry
+    solve_static_contacts(simulation_world);
+
+    // 4. World boundary collisions
     solve_boundary_contacts(simulation_world);
 }
\ No newline at end of file
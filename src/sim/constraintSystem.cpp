@@ -0,0 +1,139 @@
+#include "sim/constraintSystem.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
+#include <cmath>
+#include <algorithm>
+
+const int CONSTRAINT_TILE = 8;              // Rows per SoA tile (one AVX register of floats)
+const size_t CONSTRAINT_PARALLEL_MIN = 512; // Smaller batches are not worth waking the pool
+
+constraintSystem::constraintSystem(ThreadPool *pool) : pool(pool) {}
+constraintSystem::~constraintSystem() {}
+
+// ====================================================================
+// --- BATCH RELAXATION (Tiled Distance Projection) ---
+// ====================================================================
+
+void constraintSystem::solve_batch(world &simulation_world, const float *inv_mass, size_t begin, size_t end)
+{
+    const ConstraintSet &constraints = simulation_world.constraints;
+    const int *rows = constraints.colored_rows.data();
+    float *px = simulation_world.position_x.data();
+    float *py = simulation_world.position_y.data();
+
+    for (size_t base = begin; base < end; base += CONSTRAINT_TILE)
+    {
+        int lanes = int(std::min<size_t>(CONSTRAINT_TILE, end - base));
+
+        // 1. Gather the tile. No two rows of a colour share a body, so the
+        //    scatter below never writes the same body twice.
+        alignas(32) float ax[CONSTRAINT_TILE], ay[CONSTRAINT_TILE], bx[CONSTRAINT_TILE], by[CONSTRAINT_TILE];
+        alignas(32) float wa[CONSTRAINT_TILE], wb[CONSTRAINT_TILE], rest[CONSTRAINT_TILE], k[CONSTRAINT_TILE];
+        int a[CONSTRAINT_TILE], b[CONSTRAINT_TILE];
+        for (int l = 0; l < CONSTRAINT_TILE; ++l)
+        {
+            int r = rows[base + std::min(l, lanes - 1)]; // Padding lanes repeat the last row with k = 0
+            a[l] = constraints.body_a[r];
+            b[l] = constraints.body_b[r];
+            ax[l] = px[a[l]];
+            ay[l] = py[a[l]];
+            bx[l] = px[b[l]];
+            by[l] = py[b[l]];
+            wa[l] = inv_mass[a[l]];
+            wb[l] = inv_mass[b[l]];
+            rest[l] = constraints.rest_length[r];
+            k[l] = l < lanes ? constraints.stiffness[r] : 0.0f;
+        }
+
+        // 2. Projection, branch-free across the lanes
+        for (int l = 0; l < CONSTRAINT_TILE; ++l)
+        {
+            float dx = bx[l] - ax[l];
+            float dy = by[l] - ay[l];
+            float distance = std::sqrt(dx * dx + dy * dy);
+            float denominator = distance * (wa[l] + wb[l]);
+            float s = denominator > 1e-9f ? k[l] * (distance - rest[l]) / denominator : 0.0f;
+            ax[l] += dx * s * wa[l];
+            ay[l] += dy * s * wa[l];
+            bx[l] -= dx * s * wb[l];
+            by[l] -= dy * s * wb[l];
+        }
+
+        // 3. Scatter the corrected positions
+        for (int l = 0; l < lanes; ++l)
+        {
+            px[a[l]] = ax[l];
+            py[a[l]] = ay[l];
+            px[b[l]] = bx[l];
+            py[b[l]] = by[l];
+        }
+    }
+}
+
+// ====================================================================
+// --- MAIN UPDATE LOOP ---
+// ====================================================================
+
+void constraintSystem::update(world &simulation_world, float delta_time)
+{
+    ConstraintSet &constraints = simulation_world.constraints;
+    // XPBD worlds solve their constraints inside xpbdSystem's substeps
+    if (constraints.empty() || simulation_world.integrator == IntegratorMode::XPBD)
+        return;
+
+    size_t n = simulation_world.position_x.size();
+    constraints.update_colors(n);
+    simulation_world.frame_arena.reset(); // Temporaries of earlier systems (or steps) are dead
+
+    // 1. Pins: hold the body at its anchor and treat it as immovable for the passes
+    float *inv_mass = simulation_world.frame_arena.allocate<float>(n);
+    std::copy(simulation_world.inv_mass.begin(), simulation_world.inv_mass.end(), inv_mass);
+    for (size_t p = 0; p < constraints.num_pins(); ++p)
+    {
+        int i = constraints.pin_body[p];
+        if (i < 0 || size_t(i) >= n)
+            continue;
+        simulation_world.position_x[i] = simulation_world.previous_position_x[i] = constraints.pin_x[p];
+        simulation_world.position_y[i] = simulation_world.previous_position_y[i] = constraints.pin_y[p];
+        simulation_world.vel_x[i] = 0.0f;
+        simulation_world.vel_y[i] = 0.0f;
+        inv_mass[i] = 0.0f;
+    }
+
+    // 2. Relaxation: colour batches in order, each batch split across the pool
+    for (int pass = 0; pass < constraints.iterations; ++pass)
+    {
+        for (size_t c = 0; c < constraints.num_colors(); ++c)
+        {
+            size_t begin = size_t(constraints.color_start[c]);
+            size_t end = size_t(constraints.color_start[c + 1]);
+            if (pool && pool->size() > 1 && end - begin >= CONSTRAINT_PARALLEL_MIN)
+            {
+                pool->parallel_for(end - begin, [&](size_t first, size_t last, unsigned)
+                {
+                    solve_batch(simulation_world, inv_mass, begin + first, begin + last);
+                });
+            }
+            else
+            {
+                solve_batch(simulation_world, inv_mass, begin, end);
+            }
+        }
+    }
+
+    // 3. Velocities of constrained bodies follow the corrected positions
+    float dt = simulation_world.delta_time;
+    if (dt <= 0.0f)
+        return;
+    float inverse_dt = 1.0f / dt;
+    for (int r : constraints.colored_rows)
+    {
+        for (int i : {constraints.body_a[r], constraints.body_b[r]})
+        {
+            if (inv_mass[i] == 0.0f)
+                continue;
+            simulation_world.vel_x[i] = (simulation_world.position_x[i] - simulation_world.previous_position_x[i]) * inverse_dt;
+            simulation_world.vel_y[i] = (simulation_world.position_y[i] - simulation_world.previous_position_y[i]) * inverse_dt;
+        }
+    }
+}
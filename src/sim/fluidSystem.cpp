@@ -0,0 +1,266 @@
+#include "sim/fluidSystem.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+const float FLUID_PI = 3.14159265f;
+const float FLUID_MIN_DENSITY = 1e-6f; // Keeps massless (static) neighbours out of divisions
+
+fluidSystem::fluidSystem(ThreadPool *pool) : pool(pool) {}
+fluidSystem::~fluidSystem() {}
+
+template <typename F>
+static void run_range(ThreadPool *pool, size_t count, F &&fn)
+{
+    if (pool && pool->size() > 1)
+        pool->parallel_for(count, fn);
+    else
+        fn(size_t(0), count, 0u);
+}
+
+// Pad the rows to whole SIMD groups with massless entries on the kernel's edge
+static void pad_rows(fluidSystem::NeighborRows &rows, float smoothing_radius, bool with_state)
+{
+    while (rows.mass.size() % 4 != 0)
+    {
+        rows.dx.push_back(smoothing_radius);
+        rows.dy.push_back(0.0f);
+        rows.mass.push_back(0.0f);
+        if (!with_state)
+            continue;
+        rows.density.push_back(1.0f);
+        rows.pressure.push_back(0.0f);
+        rows.dvx.push_back(0.0f);
+        rows.dvy.push_back(0.0f);
+    }
+}
+
+void fluidSystem::gather_neighbors(const world &simulation_world, int i, float smoothing_radius, bool with_state, NeighborRows &out) const
+{
+    out.dx.clear();
+    out.dy.clear();
+    out.mass.clear();
+    out.density.clear();
+    out.pressure.clear();
+    out.dvx.clear();
+    out.dvy.clear();
+
+    const GridInfo &g = simulation_world.grid_info;
+    const int *cell_start = simulation_world.particle_start_indices.data();
+    const int *cell_bodies = simulation_world.sorted_indices.data();
+    const float h2 = smoothing_radius * smoothing_radius;
+    const float xi = simulation_world.position_x[i];
+    const float yi = simulation_world.position_y[i];
+    const int cell = simulation_world.particle_cell_id[i];
+    const int cx = cell % g.num_cells_x;
+    const int cy = cell / g.num_cells_x;
+
+    // 3x3 cells around the particle's cell; the radius is at most one cell
+    for (int oy = -1; oy <= 1; ++oy)
+    {
+        int y = cy + oy;
+        if (g.wraps_y())
+            y = (y + g.num_cells_y) % g.num_cells_y;
+        else if (y < 0 || y >= g.num_cells_y)
+            continue;
+        for (int ox = -1; ox <= 1; ++ox)
+        {
+            int x = cx + ox;
+            if (g.wraps_x())
+                x = (x + g.num_cells_x) % g.num_cells_x;
+            else if (x < 0 || x >= g.num_cells_x)
+                continue;
+            int c = y * g.num_cells_x + x;
+            for (int s = cell_start[c]; s < cell_start[c + 1]; ++s)
+            {
+                int j = cell_bodies[s];
+                if (!simulation_world.fluid[j])
+                    continue;
+                float dx = g.minimum_image_x(simulation_world.position_x[j] - xi);
+                float dy = g.minimum_image_y(simulation_world.position_y[j] - yi);
+                if (dx * dx + dy * dy >= h2)
+                    continue;
+                out.dx.push_back(dx);
+                out.dy.push_back(dy);
+                out.mass.push_back(simulation_world.mass[j]);
+                if (with_state)
+                {
+                    out.density.push_back(density[j]);
+                    out.pressure.push_back(pressure[j]);
+                    out.dvx.push_back(simulation_world.vel_x[j] - simulation_world.vel_x[i]);
+                    out.dvy.push_back(simulation_world.vel_y[j] - simulation_world.vel_y[i]);
+                }
+            }
+        }
+    }
+}
+
+// ====================================================================
+// --- SPH KERNELS (2D) ---
+// poly6 for density, spiky gradient for pressure, viscosity Laplacian.
+// Both passes sum one particle's gathered rows, four neighbours at a time.
+// ====================================================================
+
+// sum_j m_j (h^2 - r^2)^3 over the rows (multiply by the poly6 constant)
+static float sum_density(const fluidSystem::NeighborRows &rows, float h2)
+{
+    const size_t count = rows.mass.size();
+#if defined(__SSE2__)
+    const __m128 h2v = _mm_set1_ps(h2);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 sum = zero;
+    for (size_t k = 0; k < count; k += 4)
+    {
+        __m128 dx = _mm_loadu_ps(rows.dx.data() + k);
+        __m128 dy = _mm_loadu_ps(rows.dy.data() + k);
+        __m128 q = _mm_max_ps(_mm_sub_ps(h2v, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))), zero);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows.mass.data() + k), _mm_mul_ps(q, _mm_mul_ps(q, q))));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float sum = 0.0f;
+    for (size_t k = 0; k < count; ++k)
+    {
+        float q = std::max(h2 - (rows.dx[k] * rows.dx[k] + rows.dy[k] * rows.dy[k]), 0.0f);
+        sum += rows.mass[k] * q * q * q;
+    }
+    return sum;
+#endif
+}
+
+// Pressure (symmetric, p_i / rho_i^2 + p_j / rho_j^2) and viscosity
+// accelerations of one particle from its rows. The particle itself sits at
+// r = 0 and contributes nothing.
+static vec2 sum_forces(const fluidSystem::NeighborRows &rows, float h, float own_density, float own_pressure,
+                       float spiky, float viscosity_laplacian, float viscosity)
+{
+    const size_t count = rows.mass.size();
+    const float own_term = own_pressure / (own_density * own_density);
+    const float viscosity_scale = viscosity * viscosity_laplacian / own_density;
+#if defined(__SSE2__)
+    const __m128 hv = _mm_set1_ps(h);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 own = _mm_set1_ps(own_term);
+    const __m128 spiky_v = _mm_set1_ps(spiky);
+    const __m128 viscosity_v = _mm_set1_ps(viscosity_scale);
+    __m128 acc_x = zero;
+    __m128 acc_y = zero;
+    for (size_t k = 0; k < count; k += 4)
+    {
+        __m128 dx = _mm_loadu_ps(rows.dx.data() + k);
+        __m128 dy = _mm_loadu_ps(rows.dy.data() + k);
+        __m128 m = _mm_loadu_ps(rows.mass.data() + k);
+        __m128 inverse_density = _mm_div_ps(one, _mm_loadu_ps(rows.density.data() + k));
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 inverse_r = _mm_and_ps(_mm_cmpgt_ps(r, zero), _mm_div_ps(one, r));
+        __m128 q = _mm_max_ps(_mm_sub_ps(hv, r), zero);
+
+        // Pressure pushes the particle away from the neighbour (along -d)
+        __m128 shared = _mm_add_ps(own, _mm_mul_ps(_mm_loadu_ps(rows.pressure.data() + k), _mm_mul_ps(inverse_density, inverse_density)));
+        __m128 push = _mm_mul_ps(_mm_mul_ps(m, shared), _mm_mul_ps(spiky_v, _mm_mul_ps(_mm_mul_ps(q, q), inverse_r)));
+        acc_x = _mm_sub_ps(acc_x, _mm_mul_ps(push, dx));
+        acc_y = _mm_sub_ps(acc_y, _mm_mul_ps(push, dy));
+
+        // Viscosity pulls the velocity towards the neighbour's
+        __m128 drag = _mm_mul_ps(viscosity_v, _mm_mul_ps(_mm_mul_ps(m, inverse_density), q));
+        acc_x = _mm_add_ps(acc_x, _mm_mul_ps(drag, _mm_loadu_ps(rows.dvx.data() + k)));
+        acc_y = _mm_add_ps(acc_y, _mm_mul_ps(drag, _mm_loadu_ps(rows.dvy.data() + k)));
+    }
+    alignas(16) float lanes_x[4], lanes_y[4];
+    _mm_store_ps(lanes_x, acc_x);
+    _mm_store_ps(lanes_y, acc_y);
+    return vec2((lanes_x[0] + lanes_x[1]) + (lanes_x[2] + lanes_x[3]), (lanes_y[0] + lanes_y[1]) + (lanes_y[2] + lanes_y[3]));
+#else
+    float acc_x = 0.0f, acc_y = 0.0f;
+    for (size_t k = 0; k < count; ++k)
+    {
+        float r = std::sqrt(rows.dx[k] * rows.dx[k] + rows.dy[k] * rows.dy[k]);
+        float inverse_r = r > 0.0f ? 1.0f / r : 0.0f;
+        float q = std::max(h - r, 0.0f);
+        float inverse_density = 1.0f / rows.density[k];
+        float push = rows.mass[k] * (own_term + rows.pressure[k] * inverse_density * inverse_density) * spiky * q * q * inverse_r;
+        float drag = viscosity_scale * rows.mass[k] * inverse_density * q;
+        acc_x += drag * rows.dvx[k] - push * rows.dx[k];
+        acc_y += drag * rows.dvy[k] - push * rows.dy[k];
+    }
+    return vec2(acc_x, acc_y);
+#endif
+}
+
+void fluidSystem::update(world &simulation_world, float delta_time)
+{
+    if (!simulation_world.sph_fluid)
+        return;
+
+    const size_t n = simulation_world.position_x.size();
+    simulation_world.acc_x.resize(n, 0.0f);
+    simulation_world.acc_y.resize(n, 0.0f);
+    simulation_world.fluid.resize(n, 0);
+    density.assign(n, 0.0f);
+    pressure.assign(n, 0.0f);
+    particles.clear();
+
+    // The grid must index the current bodies (it is rebuilt by collisionSystem)
+    if (simulation_world.grid_rebuild_required || simulation_world.particle_cell_id.size() != n)
+        return;
+
+    // Fluid particles in grid order, so neighbouring tasks read the same cells
+    for (int i : simulation_world.sorted_indices)
+        if (simulation_world.fluid[i])
+            particles.push_back(i);
+
+    const float h = std::min(simulation_world.fluid_smoothing_radius, simulation_world.grid_info.cell_size);
+    if (particles.empty() || h <= 0.0f)
+        return;
+    const float h2 = h * h;
+    const float h5 = h2 * h2 * h;
+    const float poly6 = 4.0f / (FLUID_PI * h5 * h2 * h);
+    const float spiky = 30.0f / (FLUID_PI * h5);
+    const float viscosity_laplacian = 40.0f / (FLUID_PI * h5);
+    const float rest_density = simulation_world.fluid_rest_density;
+    const float stiffness = simulation_world.fluid_stiffness;
+    const float viscosity = simulation_world.fluid_viscosity;
+
+    unsigned workers = pool ? pool->size() : 1u;
+    if (rows.size() < workers)
+        rows.resize(workers);
+
+    // 1. Density and pressure (no tension: pressure is clamped at 0)
+    run_range(pool, particles.size(), [&](size_t begin, size_t end, unsigned worker)
+    {
+        NeighborRows &scratch = rows[worker];
+        for (size_t p = begin; p < end; ++p)
+        {
+            int i = particles[p];
+            gather_neighbors(simulation_world, i, h, false, scratch);
+            pad_rows(scratch, h, false);
+            float rho = std::max(poly6 * sum_density(scratch, h2), FLUID_MIN_DENSITY);
+            density[i] = rho;
+            pressure[i] = stiffness * std::max(rho - rest_density, 0.0f);
+        }
+    });
+
+    // 2. Pressure and viscosity accelerations of the dynamic particles
+    run_range(pool, particles.size(), [&](size_t begin, size_t end, unsigned worker)
+    {
+        NeighborRows &scratch = rows[worker];
+        for (size_t p = begin; p < end; ++p)
+        {
+            int i = particles[p];
+            if (simulation_world.inv_mass[i] <= 0.0f)
+                continue;
+            gather_neighbors(simulation_world, i, h, true, scratch);
+            pad_rows(scratch, h, true);
+            vec2 a = sum_forces(scratch, h, density[i], pressure[i], spiky, viscosity_laplacian, viscosity);
+            simulation_world.acc_x[i] += a.x;
+            simulation_world.acc_y[i] += a.y;
+        }
+    });
+}
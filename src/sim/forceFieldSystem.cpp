@@ -0,0 +1,35 @@
+#include "sim/forceFieldSystem.hpp"
+#include "physics/world.hpp"
+
+forceFieldSystem::forceFieldSystem() {}
+forceFieldSystem::~forceFieldSystem() {}
+
+void forceFieldSystem::update(world &simulation_world, float delta_time)
+{
+    ForceFieldSet &fields = simulation_world.force_fields;
+    bool has_fields = fields.size() > 0;
+    // Mutual gravity and SPH accumulate on top of the columns, so they are reset to the base every step
+    bool owns_columns = has_fields || simulation_world.mutual_gravity || simulation_world.sph_fluid;
+    if (!owns_columns && !wrote_last_step)
+        return;
+    if (fields.needs_bake())
+        fields.bake(simulation_world.grid_info);
+
+    size_t n = simulation_world.position_x.size();
+    simulation_world.acc_x.resize(n, 0.0f);
+    simulation_world.acc_y.resize(n, 0.0f);
+    simulation_world.base_acc_x.resize(n, 0.0f);
+    simulation_world.base_acc_y.resize(n, 0.0f);
+    float dt = simulation_world.delta_time;
+    for (size_t i = 0; i < n; ++i)
+    {
+        vec2 acceleration(simulation_world.base_acc_x[i], simulation_world.base_acc_y[i]);
+        if (has_fields && simulation_world.inv_mass[i] != 0.0f)
+            acceleration = acceleration + fields.acceleration_at(simulation_world.position_x[i], simulation_world.position_y[i], dt);
+        simulation_world.acc_x[i] = acceleration.x;
+        simulation_world.acc_y[i] = acceleration.y;
+    }
+
+    fields.remove_impulses();
+    wrote_last_step = owns_columns;
+}
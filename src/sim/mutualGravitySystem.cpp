@@ -0,0 +1,48 @@
+#include "sim/mutualGravitySystem.hpp"
+#include "physics/world.hpp"
+#include "utils/threadPool.hpp"
+
+mutualGravitySystem::mutualGravitySystem(ThreadPool *pool) : pool(pool) {}
+mutualGravitySystem::~mutualGravitySystem() {}
+
+void mutualGravitySystem::update(world &simulation_world, float delta_time)
+{
+    if (!simulation_world.mutual_gravity)
+        return;
+
+    size_t n = simulation_world.position_x.size();
+    simulation_world.acc_x.resize(n, 0.0f);
+    simulation_world.acc_y.resize(n, 0.0f);
+    tree.build(simulation_world, pool);
+
+    // One tree walk per group serves all of its bodies; groups are in Morton
+    // order, so neighbouring tasks walk nearly the same nodes
+    const float G = simulation_world.gravitational_constant;
+    const float theta = simulation_world.barnes_hut_theta;
+    const float softening = simulation_world.gravity_softening;
+    unsigned workers = pool ? pool->size() : 1u;
+    if (lists.size() < workers)
+        lists.resize(workers);
+    slot_acc_x.resize(n);
+    slot_acc_y.resize(n);
+    auto accumulate = [&](size_t begin, size_t end, unsigned worker)
+    {
+        for (size_t g = begin; g < end; ++g)
+        {
+            int node = tree.groups[g];
+            tree.group_accelerations(int(g), theta, softening, lists[worker], slot_acc_x.data(), slot_acc_y.data());
+            for (int s = tree.body_begin[node]; s < tree.body_end[node]; ++s)
+            {
+                int i = tree.order[s];
+                if (simulation_world.inv_mass[i] <= 0.0f)
+                    continue;
+                simulation_world.acc_x[i] += G * slot_acc_x[s];
+                simulation_world.acc_y[i] += G * slot_acc_y[s];
+            }
+        }
+    };
+    if (pool && pool->size() > 1)
+        pool->parallel_for(tree.groups.size(), accumulate);
+    else
+        accumulate(0, tree.groups.size(), 0);
+}
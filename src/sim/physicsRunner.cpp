@@ -0,0 +1,143 @@
+#include "sim/physicsRunner.hpp"
+#include "sim/systemManager.hpp"
+#include <algorithm>
+#include <utility>
+
+const int PHYSICS_MAX_CATCH_UP_STEPS = 5; // Steps run back to back after a stall before the clock is reset
+
+float RenderSnapshot::alpha_at(std::chrono::steady_clock::time_point now, float fixed_dt) const
+{
+    if (!stepped || fixed_dt <= 0.0f)
+        return 1.0f;
+    float elapsed = std::chrono::duration<float>(now - stepped_at).count();
+    return std::min(std::max(elapsed / fixed_dt, 0.0f), 1.0f);
+}
+
+physicsRunner::physicsRunner(world &simulation_world_in, systemManager &manager_in, float fixed_dt)
+    : simulation_world(simulation_world_in), manager(manager_in), step_dt(fixed_dt)
+{
+    // Readers see the initial state before the first step
+    publish(false);
+    snapshots.update();
+}
+
+physicsRunner::~physicsRunner()
+{
+    stop();
+}
+
+void physicsRunner::start()
+{
+    if (running.exchange(true))
+        return;
+    thread = std::thread([this] { run(); });
+}
+
+void physicsRunner::stop()
+{
+    if (!running.exchange(false))
+        return;
+    thread.join();
+    apply_edits();
+    manager.apply_commands(simulation_world);
+}
+
+void physicsRunner::post(std::function<void(world &)> edit)
+{
+    std::lock_guard<std::mutex> lock(edits_mutex);
+    pending_edits.push_back(std::move(edit));
+}
+
+void physicsRunner::set_paused(bool pause)
+{
+    paused.store(pause, std::memory_order_relaxed);
+}
+
+const RenderSnapshot &physicsRunner::latest_snapshot()
+{
+    snapshots.update();
+    return snapshots.front();
+}
+
+void physicsRunner::apply_edits()
+{
+    {
+        std::lock_guard<std::mutex> lock(edits_mutex);
+        std::swap(pending_edits, applying_edits);
+    }
+    for (auto &edit : applying_edits)
+        edit(simulation_world);
+    applying_edits.clear();
+}
+
+void physicsRunner::publish(bool stepped)
+{
+    const world &w = simulation_world;
+    RenderSnapshot &s = snapshots.back();
+    s.step = steps.load(std::memory_order_relaxed);
+    s.stepped_at = std::chrono::steady_clock::now();
+    s.stepped = stepped;
+    s.position_x.assign(w.position_x.begin(), w.position_x.end());
+    s.position_y.assign(w.position_y.begin(), w.position_y.end());
+    s.previous_x.assign(s.position_x.begin(), s.position_x.end());
+    s.previous_y.assign(s.position_y.begin(), s.position_y.end());
+    // A removal swaps bodies between indices: before_x no longer matches by
+    // index, so the whole snapshot starts from the current positions
+    if (stepped && w.bodies_removed == removals_before)
+    {
+        // Bodies added by the step (or its edits) have no earlier position
+        size_t common = std::min(before_x.size(), s.size());
+        std::copy(before_x.begin(), before_x.begin() + common, s.previous_x.begin());
+        std::copy(before_y.begin(), before_y.begin() + common, s.previous_y.begin());
+    }
+    s.radius.assign(w.radius.begin(), w.radius.end());
+    s.mass.assign(w.mass.begin(), w.mass.end());
+    s.inv_mass.assign(w.inv_mass.begin(), w.inv_mass.end());
+    s.restitution.assign(w.restitution.begin(), w.restitution.end());
+    s.damping.assign(w.damping.begin(), w.damping.end());
+    s.friction.assign(w.friction.begin(), w.friction.end());
+    s.gravity_y = w.gravity_y;
+    s.global_damping = w.global_damping;
+    s.integrator = w.integrator;
+    s.xpbd_substeps = w.xpbd_substeps;
+    s.mutual_gravity = w.mutual_gravity;
+    s.sph_fluid = w.sph_fluid;
+    snapshots.publish();
+}
+
+void physicsRunner::run()
+{
+    using clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(step_dt));
+    auto next_step = clock::now();
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        int taken = 0;
+        while (clock::now() >= next_step && taken < PHYSICS_MAX_CATCH_UP_STEPS)
+        {
+            apply_edits();
+            bool step = !paused.load(std::memory_order_relaxed) || step_once.exchange(false, std::memory_order_relaxed);
+            if (step)
+            {
+                before_x.assign(simulation_world.position_x.begin(), simulation_world.position_x.end());
+                before_y.assign(simulation_world.position_y.begin(), simulation_world.position_y.end());
+                removals_before = simulation_world.bodies_removed;
+                manager.update(simulation_world, step_dt);
+                steps.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                // Paused: queued commands still take effect
+                manager.apply_commands(simulation_world);
+            }
+            publish(step);
+            next_step += period;
+            ++taken;
+        }
+        // Too far behind (a stall or steps slower than real time): drop the backlog
+        if (taken == PHYSICS_MAX_CATCH_UP_STEPS && clock::now() >= next_step)
+            next_step = clock::now() + period;
+        std::this_thread::sleep_until(next_step);
+    }
+}
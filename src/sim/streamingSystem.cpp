@@ -0,0 +1,382 @@
+#include "sim/streamingSystem.hpp"
+#include "physics/body.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+const uint32_t CHUNK_FILE_MAGIC = 0x4B484350; // "PCHK": one record per eviction, appended
+const uint64_t CHUNK_WRITE_BACKOFF_STEPS = 60;  // Steps a chunk stays resident after its first failed write
+const int CHUNK_WRITE_BACKOFF_MAX_SHIFT = 6;    // Each further failure doubles that, up to 64x
+
+streamingSystem::streamingSystem(const std::string &directory_in, float chunk_size_in)
+    : directory(directory_in), chunk_size(chunk_size_in > 0.0f ? chunk_size_in : 50.0f)
+{
+    std::error_code error;
+    directory_ok = std::filesystem::is_directory(directory, error);
+    if (!directory_ok)
+        report_failure("directory '" + directory + "' does not exist, every body stays in memory");
+    io_thread = std::thread([this] { io_loop(); });
+}
+
+void streamingSystem::report_failure(const std::string &what)
+{
+    // Only the first one is printed: a failing disk would fail every step
+    if (failures.fetch_add(1, std::memory_order_relaxed) == 0)
+        std::cerr << "streamingSystem: " << what << "\n";
+}
+
+streamingSystem::~streamingSystem()
+{
+    // Queued writes finish first; then the scratch files go
+    {
+        std::lock_guard<std::mutex> lock(io_mutex);
+        stopping = true;
+    }
+    io_wake.notify_all();
+    io_thread.join();
+    for (size_t c = 0; c < on_disk.size(); ++c)
+        if (on_disk[c])
+            std::remove(chunk_path(int(c)).c_str());
+}
+
+std::string streamingSystem::chunk_path(int chunk) const
+{
+    return directory + "/chunk_" + std::to_string(chunk % std::max(chunks_x, 1)) + "_" + std::to_string(chunk / std::max(chunks_x, 1)) + ".bin";
+}
+
+int streamingSystem::chunk_at(float x, float y) const
+{
+    // Bodies outside the domain belong to the border chunk
+    int cx = std::min(std::max(int(std::floor((x - origin_x) / chunk_size)), 0), chunks_x - 1);
+    int cy = std::min(std::max(int(std::floor((y - origin_y) / chunk_size)), 0), chunks_y - 1);
+    return cy * chunks_x + cx;
+}
+
+streamingSystem::ChunkState streamingSystem::state_of(int chunk_x, int chunk_y) const
+{
+    if (chunk_x < 0 || chunk_y < 0 || chunk_x >= chunks_x || chunk_y >= chunks_y)
+        return ChunkState::Resident;
+    return states[size_t(chunk_y) * chunks_x + chunk_x];
+}
+
+size_t streamingSystem::resident_chunks() const
+{
+    return size_t(std::count(states.begin(), states.end(), ChunkState::Resident));
+}
+
+// ====================================================================
+// --- STEP THREAD ---
+// ====================================================================
+
+void streamingSystem::update(world &simulation_world, float)
+{
+    if (states.empty())
+    {
+        const GridInfo &grid = simulation_world.grid_info;
+        origin_x = grid.min_x;
+        origin_y = grid.min_y;
+        chunks_x = std::max(1, int(std::ceil((grid.max_x - grid.min_x) / chunk_size)));
+        chunks_y = std::max(1, int(std::ceil((grid.max_y - grid.min_y) / chunk_size)));
+        states.assign(size_t(chunks_x) * chunks_y, ChunkState::Resident);
+        on_disk.assign(states.size(), 0);
+        write_serial.assign(states.size(), 0);
+        failed_writes.assign(states.size(), 0);
+        evict_after.assign(states.size(), 0);
+    }
+    ++steps;
+
+    apply_loaded(simulation_world);
+    if (!directory_ok)
+        return;
+
+    // Distance from the nearest observer to each chunk's rectangle decides
+    // whether it is loaded (< load radius) or kept (< evict radius)
+    const std::vector<vec2> &observers = simulation_world.stream_observers;
+    const float load_squared = simulation_world.stream_load_radius * simulation_world.stream_load_radius;
+    const float keep_radius = std::max(simulation_world.stream_evict_radius, simulation_world.stream_load_radius);
+    const float keep_squared = keep_radius * keep_radius;
+    keep.assign(states.size(), 1);
+    for (int cy = 0; cy < chunks_y; ++cy)
+        for (int cx = 0; cx < chunks_x; ++cx)
+        {
+            if (observers.empty())
+                break;
+            const float min_x = origin_x + cx * chunk_size, min_y = origin_y + cy * chunk_size;
+            float nearest_squared = 1e30f;
+            for (const vec2 &o : observers)
+            {
+                float dx = std::max(std::max(min_x - o.x, o.x - (min_x + chunk_size)), 0.0f);
+                float dy = std::max(std::max(min_y - o.y, o.y - (min_y + chunk_size)), 0.0f);
+                nearest_squared = std::min(nearest_squared, dx * dx + dy * dy);
+            }
+            const int c = cy * chunks_x + cx;
+            // A chunk whose write failed is kept until its back-off ends
+            keep[c] = nearest_squared < keep_squared || steps < evict_after[c];
+            if (states[c] == ChunkState::OnDisk && nearest_squared < load_squared)
+            {
+                states[c] = ChunkState::Loading;
+                on_disk[c] = 0; // The read deletes the file
+                IoJob job;
+                job.write = false;
+                job.chunk = c;
+                enqueue(std::move(job));
+            }
+        }
+
+    evict(simulation_world);
+}
+
+void streamingSystem::evict(world &simulation_world)
+{
+    const size_t n = simulation_world.size();
+    chunk_of_body.resize(n);
+    evicted.clear();
+    for (size_t i = 0; i < n; ++i)
+    {
+        int c = chunk_at(simulation_world.position_x[i], simulation_world.position_y[i]);
+        chunk_of_body[i] = c;
+        if (!keep[c])
+            evicted.push_back(int(i));
+    }
+    if (evicted.empty())
+        return;
+
+    // One record per chunk, bodies in index order
+    std::stable_sort(evicted.begin(), evicted.end(), [&](int a, int b) { return chunk_of_body[a] < chunk_of_body[b]; });
+    const world &w = simulation_world;
+    size_t first = 0;
+    while (first < evicted.size())
+    {
+        const int c = chunk_of_body[evicted[first]];
+        size_t last = first;
+        while (last < evicted.size() && chunk_of_body[evicted[last]] == c)
+            ++last;
+
+        IoJob job;
+        job.write = true;
+        job.truncate = !on_disk[c];
+        job.chunk = c;
+        job.previous_state = states[c];
+        job.previous_on_disk = on_disk[c];
+        job.serial = ++write_serial[c];
+        ChunkBodies &out = job.bodies;
+        out.count = uint32_t(last - first);
+        out.floats.resize(size_t(ChunkBodies::FLOAT_COLUMNS) * out.count);
+        out.layers.resize(2 * size_t(out.count));
+        out.fluid.resize(out.count);
+        const std::vector<float> *columns[ChunkBodies::FLOAT_COLUMNS] = {&w.position_x, &w.position_y, &w.previous_position_x, &w.previous_position_y,
+                                                                         &w.vel_x,      &w.vel_y,      &w.base_acc_x,          &w.base_acc_y,
+                                                                         &w.mass,       &w.inv_mass,   &w.radius,              &w.damping,
+                                                                         &w.friction,   &w.restitution};
+        for (int column = 0; column < ChunkBodies::FLOAT_COLUMNS; ++column)
+        {
+            float *target = out.floats.data() + size_t(column) * out.count;
+            for (size_t k = first; k < last; ++k)
+                target[k - first] = (*columns[column])[evicted[k]];
+        }
+        for (size_t k = first; k < last; ++k)
+        {
+            const int i = evicted[k];
+            out.layers[2 * (k - first)] = w.get_collision_category(i);
+            out.layers[2 * (k - first) + 1] = w.get_collision_mask(i);
+            out.fluid[k - first] = size_t(i) < w.fluid.size() ? w.fluid[i] : 0;
+        }
+        stored_bodies += out.count;
+        states[c] = ChunkState::OnDisk;
+        on_disk[c] = 1;
+        enqueue(std::move(job));
+        first = last;
+    }
+
+    // Highest index first: a swap-remove then only moves bodies that stay
+    std::sort(evicted.begin(), evicted.end());
+    for (size_t k = evicted.size(); k-- > 0;)
+        simulation_world.remove_body(size_t(evicted[k]));
+}
+
+void streamingSystem::apply_loaded(world &simulation_world)
+{
+    std::vector<IoJob> ready;
+    {
+        std::lock_guard<std::mutex> lock(io_mutex);
+        ready.swap(loaded);
+    }
+    for (const IoJob &entry : ready)
+    {
+        const int c = entry.chunk;
+        const ChunkBodies &in = entry.bodies;
+        const size_t count = in.count;
+        auto column = [&](int k, size_t i) { return in.floats[size_t(k) * count + i]; };
+        for (size_t i = 0; i < count; ++i)
+        {
+            body b(vec2(column(0, i), column(1, i)), vec2(column(4, i), column(5, i)), vec2(column(6, i), column(7, i)), column(8, i), column(9, i),
+                   column(10, i), column(13, i), column(11, i), column(12, i));
+            b.previous_position = vec2(column(2, i), column(3, i));
+            b.collision_category = in.layers[2 * i];
+            b.collision_mask = in.layers[2 * i + 1];
+            simulation_world.add_body(b);
+            if (in.fluid[i])
+                simulation_world.set_fluid(simulation_world.size() - 1, true);
+        }
+        stored_bodies -= std::min(stored_bodies, count);
+        if (entry.write)
+        {
+            // A failed write: undo its eviction, unless a later eviction of the
+            // chunk is in flight or a load was requested since
+            if (entry.serial == write_serial[c] && states[c] == ChunkState::OnDisk)
+            {
+                // A load that was in flight has delivered by now (jobs run in order)
+                states[c] = entry.previous_state == ChunkState::Loading ? ChunkState::Resident : entry.previous_state;
+                on_disk[c] = entry.previous_on_disk;
+            }
+            failed_writes[c] = uint8_t(std::min<int>(failed_writes[c] + 1, CHUNK_WRITE_BACKOFF_MAX_SHIFT + 1));
+            evict_after[c] = steps + (CHUNK_WRITE_BACKOFF_STEPS << (failed_writes[c] - 1));
+            continue;
+        }
+        // Evicted again while loading: those bodies went back to disk as a new file
+        if (states[c] == ChunkState::Loading)
+            states[c] = ChunkState::Resident;
+    }
+}
+
+// ====================================================================
+// --- I/O THREAD ---
+// ====================================================================
+
+void streamingSystem::enqueue(IoJob job)
+{
+    {
+        std::lock_guard<std::mutex> lock(io_mutex);
+        jobs.push_back(std::move(job));
+    }
+    io_wake.notify_one();
+}
+
+void streamingSystem::flush()
+{
+    std::unique_lock<std::mutex> lock(io_mutex);
+    io_idle.wait(lock, [this] { return jobs.empty() && !io_busy; });
+}
+
+template <typename T>
+static void write_column(std::ofstream &file, const std::vector<T> &column)
+{
+    file.write(reinterpret_cast<const char *>(column.data()), std::streamsize(column.size() * sizeof(T)));
+}
+
+template <typename T>
+static bool read_column(std::ifstream &file, std::vector<T> &column, size_t first, size_t count)
+{
+    column.resize(first + count);
+    return bool(file.read(reinterpret_cast<char *>(column.data() + first), std::streamsize(count * sizeof(T))));
+}
+
+void streamingSystem::io_loop()
+{
+    for (;;)
+    {
+        IoJob job;
+        {
+            std::unique_lock<std::mutex> lock(io_mutex);
+            io_wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return; // Stopping with nothing left to write
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            io_busy = true;
+        }
+
+        const std::string path = chunk_path(job.chunk);
+        if (job.write)
+        {
+            // Record: magic, count, then every column back to back
+            std::ofstream file(path, std::ios::binary | (job.truncate ? std::ios::trunc : std::ios::app));
+            std::streamoff record_start = 0;
+            if (file.is_open() && !job.truncate)
+            {
+                file.seekp(0, std::ios::end);
+                record_start = std::max<std::streamoff>(file.tellp(), 0);
+            }
+            file.write(reinterpret_cast<const char *>(&CHUNK_FILE_MAGIC), sizeof(CHUNK_FILE_MAGIC));
+            file.write(reinterpret_cast<const char *>(&job.bodies.count), sizeof(job.bodies.count));
+            write_column(file, job.bodies.floats);
+            write_column(file, job.bodies.layers);
+            write_column(file, job.bodies.fluid);
+            file.flush();
+            if (size_t(job.chunk) >= write_left_no_file.size())
+                write_left_no_file.resize(size_t(job.chunk) + 1, 0);
+            if (file.good())
+            {
+                write_left_no_file[job.chunk] = 0;
+                written_bytes += sizeof(uint32_t) * 2 + job.bodies.floats.size() * sizeof(float) + job.bodies.layers.size() * sizeof(uint32_t) +
+                                 job.bodies.fluid.size();
+            }
+            else
+            {
+                // Cut the partial record off and give the bodies back to the world
+                const bool opened = file.is_open();
+                file.close();
+                std::error_code error;
+                if (opened && record_start > 0)
+                    std::filesystem::resize_file(path, std::uintmax_t(record_start), error);
+                else if (opened)
+                    std::filesystem::remove(path, error);
+                write_left_no_file[job.chunk] = record_start == 0;
+                report_failure("cannot write " + path + ", its bodies stay in memory");
+                std::lock_guard<std::mutex> lock(io_mutex);
+                loaded.push_back(std::move(job));
+            }
+        }
+        else
+        {
+            // Merge every record into one column set
+            ChunkBodies all;
+            std::vector<float> floats;
+            std::ifstream file(path, std::ios::binary);
+            uint32_t magic = 0, count = 0;
+            while (file.read(reinterpret_cast<char *>(&magic), sizeof(magic)) && magic == CHUNK_FILE_MAGIC &&
+                   file.read(reinterpret_cast<char *>(&count), sizeof(count)))
+            {
+                if (!read_column(file, floats, 0, size_t(ChunkBodies::FLOAT_COLUMNS) * count) || !read_column(file, all.layers, 2 * size_t(all.count), 2 * size_t(count)) ||
+                    !read_column(file, all.fluid, all.count, count))
+                    break;
+                std::vector<float> merged(size_t(ChunkBodies::FLOAT_COLUMNS) * (all.count + count));
+                for (int column = 0; column < ChunkBodies::FLOAT_COLUMNS; ++column)
+                {
+                    std::copy_n(all.floats.begin() + size_t(column) * all.count, all.count, merged.begin() + size_t(column) * (all.count + count));
+                    std::copy_n(floats.begin() + size_t(column) * count, count, merged.begin() + size_t(column) * (all.count + count) + all.count);
+                }
+                all.floats.swap(merged);
+                all.count += count;
+            }
+            // A damaged record ends the read; the complete ones are kept. No
+            // file after a failed write is expected: that failure was counted.
+            const bool expected_missing = size_t(job.chunk) < write_left_no_file.size() && write_left_no_file[job.chunk];
+            if (!file.is_open() && !expected_missing)
+                report_failure("cannot read " + path);
+            else if (!file.eof())
+                report_failure("damaged record in " + path + ", only the records before it were loaded");
+            all.layers.resize(2 * size_t(all.count));
+            all.fluid.resize(all.count);
+            file.close();
+            std::remove(path.c_str());
+            if (size_t(job.chunk) < write_left_no_file.size())
+                write_left_no_file[job.chunk] = 0;
+            job.bodies = std::move(all);
+            std::lock_guard<std::mutex> lock(io_mutex);
+            loaded.push_back(std::move(job));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(io_mutex);
+            io_busy = false;
+        }
+        io_idle.notify_all();
+    }
+}
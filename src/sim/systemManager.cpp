@@ -1,6 +1,7 @@
 // src/sim/systemManager.cpp (CORREGIDO)
 
 #include "sim/systemManager.hpp"
+#include "physics/world.hpp"
 #include <utility>
 
 void systemManager::addSystem(std::unique_ptr<ISystem> sys)
@@ -11,6 +12,9 @@ void systemManager::addSystem(std::unique_ptr<ISystem> sys)
 
 void systemManager::update(world &world, float dt)
 {
+    // External mutations land here, before any system reads the world
+    command_queue.apply(world);
+    world.begin_step();
 
     for (const auto &system_ptr : systems)
     {
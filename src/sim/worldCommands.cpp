@@ -0,0 +1,158 @@
+#include "sim/worldCommands.hpp"
+#include "physics/body.hpp"
+#include "physics/world.hpp"
+#include <algorithm>
+#include <cstdint>
+
+WorldCommand WorldCommand::impulse(uint32_t body, const vec2 &impulse)
+{
+    WorldCommand command;
+    command.type = WorldCommandType::ApplyImpulse;
+    command.body = body;
+    command.x = impulse.x;
+    command.y = impulse.y;
+    return command;
+}
+
+WorldCommand WorldCommand::set_velocity(uint32_t body, const vec2 &velocity)
+{
+    WorldCommand command;
+    command.type = WorldCommandType::SetVelocity;
+    command.body = body;
+    command.x = velocity.x;
+    command.y = velocity.y;
+    return command;
+}
+
+WorldCommand WorldCommand::teleport(uint32_t body, const vec2 &position)
+{
+    WorldCommand command;
+    command.type = WorldCommandType::Teleport;
+    command.body = body;
+    command.x = position.x;
+    command.y = position.y;
+    return command;
+}
+
+WorldCommand WorldCommand::remove(uint32_t body)
+{
+    WorldCommand command;
+    command.type = WorldCommandType::Remove;
+    command.body = body;
+    return command;
+}
+
+WorldCommand WorldCommand::spawn(const vec2 &position, const vec2 &velocity, float mass, float radius, float restitution, float damping,
+                                 float friction)
+{
+    WorldCommand command;
+    command.type = WorldCommandType::Spawn;
+    command.x = position.x;
+    command.y = position.y;
+    command.vx = velocity.x;
+    command.vy = velocity.y;
+    command.mass = mass;
+    command.radius = radius;
+    command.restitution = restitution;
+    command.damping = damping;
+    command.friction = friction;
+    return command;
+}
+
+WorldCommandQueue::WorldCommandQueue(size_t capacity) : queue(capacity)
+{
+    batch.reserve(queue.capacity());
+}
+
+// Per-body commands, then removals (highest index first), then spawns
+static int command_group(const WorldCommand &command)
+{
+    switch (command.type)
+    {
+    case WorldCommandType::Remove:
+        return 1;
+    case WorldCommandType::Spawn:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+static bool applied_before(const WorldCommand &a, const WorldCommand &b)
+{
+    int group_a = command_group(a), group_b = command_group(b);
+    if (group_a != group_b)
+        return group_a < group_b;
+    if (group_a == 0 && a.body != b.body)
+        return a.body < b.body;
+    if (group_a == 1 && a.body != b.body)
+        return a.body > b.body;
+    return a.order < b.order;
+}
+
+size_t WorldCommandQueue::apply(world &world)
+{
+    // Only what is queued now: commands pushed meanwhile wait for the next drain
+    batch.clear();
+    WorldCommand command;
+    while (batch.size() < queue.capacity() && queue.try_pop(command))
+    {
+        command.order = uint32_t(batch.size());
+        batch.push_back(command);
+    }
+    if (batch.empty())
+        return 0;
+    std::sort(batch.begin(), batch.end(), applied_before);
+
+    // Verlet reads velocity from (position - previous): keep them in step
+    const float dt = world.delta_time;
+    auto sync_previous = [&](size_t i)
+    {
+        world.previous_position_x[i] = world.position_x[i] - world.vel_x[i] * dt;
+        world.previous_position_y[i] = world.position_y[i] - world.vel_y[i] * dt;
+    };
+
+    size_t applied = 0;
+    size_t last_removed = SIZE_MAX;
+    for (const WorldCommand &c : batch)
+    {
+        const size_t i = c.body;
+        if (c.type != WorldCommandType::Spawn && i >= world.size())
+            continue;
+        switch (c.type)
+        {
+        case WorldCommandType::ApplyImpulse:
+            world.vel_x[i] += c.x * world.inv_mass[i];
+            world.vel_y[i] += c.y * world.inv_mass[i];
+            sync_previous(i);
+            break;
+        case WorldCommandType::SetVelocity:
+            if (world.inv_mass[i] <= 0.0f)
+                continue; // static
+            world.vel_x[i] = c.x;
+            world.vel_y[i] = c.y;
+            sync_previous(i);
+            break;
+        case WorldCommandType::Teleport:
+            world.set_position(i, vec2(c.x, c.y));
+            break;
+        case WorldCommandType::Remove:
+            // Removals are sorted together: a repeat would remove the body swapped into i
+            if (i == last_removed)
+                continue;
+            world.remove_body(i);
+            last_removed = i;
+            break;
+        case WorldCommandType::Spawn:
+        {
+            float inv_mass = c.mass > 0.0f ? 1.0f / c.mass : 0.0f;
+            body spawned(vec2(c.x, c.y), vec2(c.vx, c.vy), vec2(0.0f, 0.0f), c.mass, inv_mass, c.radius, c.restitution, c.damping, c.friction);
+            spawned.previous_position = spawned.position - spawned.velocity * dt;
+            world.add_body(spawned);
+            break;
+        }
+        }
+        ++applied;
+    }
+    return applied;
+}
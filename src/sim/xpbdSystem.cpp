@@ -0,0 +1,381 @@
+#include "sim/xpbdSystem.hpp"
+#include "physics/world.hpp"
+#include <cmath>
+#include <algorithm>
+
+const float XPBD_CONTACT_MARGIN = 0.05f; // Extra reach of the per-frame contact list beyond the frame's motion
+const float XPBD_VELOCITY_EPSILON = 1e-6f; // Threshold to snap velocity to zero
+
+xpbdSystem::xpbdSystem() {}
+xpbdSystem::~xpbdSystem() {}
+
+// ====================================================================
+// --- CONTACT GATHERING (once per frame) ---
+// ====================================================================
+
+xpbdSystem::ContactRows xpbdSystem::gather_contacts(world &simulation_world, float delta_time)
+{
+    CandidatePairs candidates = broad_phase.collect_candidate_pairs(simulation_world);
+    FrameArena &arena = simulation_world.frame_arena;
+    const GridInfo &grid = simulation_world.grid_info;
+
+    ContactRows contacts;
+    contacts.body_a = arena.allocate<int>(candidates.count);
+    contacts.body_b = arena.allocate<int>(candidates.count);
+    contacts.normal_x = arena.allocate<float>(candidates.count);
+    contacts.normal_y = arena.allocate<float>(candidates.count);
+    contacts.approach_speed = arena.allocate<float>(candidates.count);
+    contacts.penetration = arena.allocate<float>(candidates.count);
+    contacts.impulse = arena.allocate<float>(candidates.count);
+    contacts.touched = arena.allocate<unsigned char>(candidates.count);
+    contacts.touching = arena.allocate<unsigned char>(candidates.count);
+
+    // A pair can only touch during this frame if its gap is covered by the
+    // distance both bodies can travel (velocity plus one frame of gravity).
+    float gravity = std::sqrt(simulation_world.gravity_x * simulation_world.gravity_x + simulation_world.gravity_y * simulation_world.gravity_y);
+    float gravity_reach = gravity * delta_time * delta_time;
+    auto reach = [&](int i)
+    {
+        if (simulation_world.inv_mass[i] == 0.0f)
+            return 0.0f;
+        float vx = simulation_world.vel_x[i];
+        float vy = simulation_world.vel_y[i];
+        return std::sqrt(vx * vx + vy * vy) * delta_time + gravity_reach;
+    };
+
+    for (size_t p = 0; p < candidates.count; ++p)
+    {
+        int a = candidates.pairs[p].first;
+        int b = candidates.pairs[p].second;
+        float dx = grid.minimum_image_x(simulation_world.position_x[b] - simulation_world.position_x[a]);
+        float dy = grid.minimum_image_y(simulation_world.position_y[b] - simulation_world.position_y[a]);
+        float gap = std::sqrt(dx * dx + dy * dy) - simulation_world.radius[a] - simulation_world.radius[b];
+        if (gap > reach(a) + reach(b) + XPBD_CONTACT_MARGIN)
+            continue;
+        contacts.body_a[contacts.count] = a;
+        contacts.body_b[contacts.count] = b;
+        contacts.touching[contacts.count] = 0;
+        contacts.touched[contacts.count] = 0;
+        contacts.impulse[contacts.count] = 0.0f;
+        ++contacts.count;
+    }
+    return contacts;
+}
+
+// ====================================================================
+// --- SUBSTEP PHASES ---
+// ====================================================================
+
+void xpbdSystem::solve_constraints(world &simulation_world, const float *inv_mass, float h)
+{
+    const ConstraintSet &constraints = simulation_world.constraints;
+    float *px = simulation_world.position_x.data();
+    float *py = simulation_world.position_y.data();
+    float inverse_h_squared = 1.0f / (h * h);
+
+    // One pass per substep, so the Lagrange multiplier starts at zero and
+    // delta_lambda = -C / (w_a + w_b + alpha / h^2).
+    for (int r : constraints.colored_rows)
+    {
+        int a = constraints.body_a[r];
+        int b = constraints.body_b[r];
+        float wa = inv_mass[a];
+        float wb = inv_mass[b];
+        float alpha = constraints.compliance[r] * inverse_h_squared;
+        float denominator = wa + wb + alpha;
+        float dx = px[b] - px[a];
+        float dy = py[b] - py[a];
+        float distance = std::sqrt(dx * dx + dy * dy);
+        if (denominator <= 0.0f || distance < 1e-9f)
+            continue;
+        float delta_lambda = -(distance - constraints.rest_length[r]) / denominator;
+        float nx = dx / distance;
+        float ny = dy / distance;
+        px[a] -= nx * delta_lambda * wa;
+        py[a] -= ny * delta_lambda * wa;
+        px[b] += nx * delta_lambda * wb;
+        py[b] += ny * delta_lambda * wb;
+    }
+}
+
+void xpbdSystem::solve_contacts(world &simulation_world, ContactRows &contacts, const float *inv_mass, float h)
+{
+    const GridInfo &grid = simulation_world.grid_info;
+    float *px = simulation_world.position_x.data();
+    float *py = simulation_world.position_y.data();
+    const float *vx = simulation_world.vel_x.data();
+    const float *vy = simulation_world.vel_y.data();
+    float alpha = simulation_world.contact_compliance / (h * h);
+
+    for (size_t k = 0; k < contacts.count; ++k)
+    {
+        int a = contacts.body_a[k];
+        int b = contacts.body_b[k];
+        float dx = grid.minimum_image_x(px[b] - px[a]);
+        float dy = grid.minimum_image_y(py[b] - py[a]);
+        float distance_squared = dx * dx + dy * dy;
+        float radius_sum = simulation_world.radius[a] + simulation_world.radius[b];
+        contacts.touching[k] = 0;
+        if (distance_squared >= radius_sum * radius_sum)
+            continue;
+
+        float distance = std::sqrt(distance_squared);
+        float nx = distance > 1e-9f ? dx / distance : 0.0f;
+        float ny = distance > 1e-9f ? dy / distance : 1.0f;
+        float wa = inv_mass[a];
+        float wb = inv_mass[b];
+        float denominator = wa + wb + alpha;
+        if (denominator <= 0.0f)
+            continue;
+
+        // Inequality constraint C = distance - radius_sum <= 0 pushes apart only
+        float delta_lambda = (radius_sum - distance) / denominator;
+        px[a] -= nx * delta_lambda * wa;
+        py[a] -= ny * delta_lambda * wa;
+        px[b] += nx * delta_lambda * wb;
+        py[b] += ny * delta_lambda * wb;
+
+        contacts.touching[k] = 1;
+        contacts.touched[k] = 1;
+        contacts.normal_x[k] = nx;
+        contacts.normal_y[k] = ny;
+        contacts.approach_speed[k] = (vx[b] - vx[a]) * nx + (vy[b] - vy[a]) * ny;
+        contacts.penetration[k] = radius_sum - distance;
+        contacts.impulse[k] += delta_lambda / h;
+    }
+}
+
+void xpbdSystem::solve_contact_velocities(world &simulation_world, ContactRows &contacts, const float *inv_mass, float h)
+{
+    float *vx = simulation_world.vel_x.data();
+    float *vy = simulation_world.vel_y.data();
+    // Approaches slower than one substep of gravity are resting contacts: no
+    // bounce, or stacks would never settle.
+    float gravity = std::sqrt(simulation_world.gravity_x * simulation_world.gravity_x + simulation_world.gravity_y * simulation_world.gravity_y);
+    float resting_speed = 2.0f * gravity * h;
+
+    for (size_t k = 0; k < contacts.count; ++k)
+    {
+        if (!contacts.touching[k])
+            continue;
+        int a = contacts.body_a[k];
+        int b = contacts.body_b[k];
+        float wa = inv_mass[a];
+        float wb = inv_mass[b];
+        if (wa + wb <= 0.0f)
+            continue;
+        float nx = contacts.normal_x[k];
+        float ny = contacts.normal_y[k];
+        float normal_speed = (vx[b] - vx[a]) * nx + (vy[b] - vy[a]) * ny;
+        float approach = contacts.approach_speed[k];
+        float restitution = approach < -resting_speed ? (simulation_world.get_restitution(a) + simulation_world.get_restitution(b)) * 0.5f : 0.0f;
+        float target = std::max(-restitution * approach, 0.0f);
+        if (normal_speed >= target)
+            continue;
+        float delta = (target - normal_speed) / (wa + wb);
+        vx[a] -= nx * delta * wa;
+        vy[a] -= ny * delta * wa;
+        vx[b] += nx * delta * wb;
+        vy[b] += ny * delta * wb;
+        contacts.impulse[k] += delta;
+    }
+}
+
+void xpbdSystem::record_contacts(world &simulation_world, const ContactRows &contacts)
+{
+    if (!simulation_world.persistent_contacts && !simulation_world.report_collision_events)
+        return;
+    broad_phase.begin_contact_recording(simulation_world);
+    for (size_t k = 0; k < contacts.count; ++k)
+    {
+        if (!contacts.touched[k])
+            continue;
+        int a = contacts.body_a[k];
+        int b = contacts.body_b[k];
+        ContactManifold manifold;
+        manifold.body_A = a;
+        manifold.body_B = b;
+        manifold.normal_direction = vec2(contacts.normal_x[k], contacts.normal_y[k]);
+        manifold.penetration_depth = contacts.penetration[k];
+        manifold.effective_restitution = (simulation_world.get_restitution(a) + simulation_world.get_restitution(b)) * 0.5f;
+        manifold.inverse_mass_sum = simulation_world.inv_mass[a] + simulation_world.inv_mass[b];
+        manifold.normal_impulse = contacts.impulse[k];
+        broad_phase.record_contact(simulation_world, manifold);
+    }
+    broad_phase.end_contact_recording(simulation_world);
+}
+
+void xpbdSystem::solve_static_and_boundary(world &simulation_world, const float *inv_mass)
+{
+    StaticGeometry &geometry = simulation_world.static_geometry;
+    bool has_geometry = geometry.size() > 0;
+    if (has_geometry && geometry.needs_bake())
+        geometry.bake(simulation_world.grid_info);
+
+    const GridInfo &grid = simulation_world.grid_info;
+    const float ground_y_limit = 0.0f;
+    const bool walls_x = !grid.wraps_x();
+    const bool walls_y = !grid.wraps_y();
+
+    size_t n = simulation_world.position_x.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (inv_mass[i] == 0.0f)
+            continue;
+        float px = simulation_world.position_x[i];
+        float py = simulation_world.position_y[i];
+        float vx = simulation_world.vel_x[i];
+        float vy = simulation_world.vel_y[i];
+        float r = simulation_world.radius[i];
+        float restitution = simulation_world.get_restitution(i);
+
+        if (has_geometry)
+        {
+            geometry.for_each_circle_contact(px, py, r, simulation_world.get_collision_category(i), simulation_world.get_collision_mask(i), [&](const StaticContact &found)
+            {
+                StaticContact contact;
+                if (!geometry.collide_circle(found.shape, px, py, r, contact))
+                    return;
+                px += contact.normal.x * contact.penetration_depth;
+                py += contact.normal.y * contact.penetration_depth;
+                float velocity_along_normal = vx * contact.normal.x + vy * contact.normal.y;
+                if (velocity_along_normal < 0.0f)
+                {
+                    float bounce = (1.0f + (restitution + geometry.shape_restitution[contact.shape]) * 0.5f) * velocity_along_normal;
+                    vx -= contact.normal.x * bounce;
+                    vy -= contact.normal.y * bounce;
+                }
+            });
+        }
+
+        if (walls_y && py - r < ground_y_limit)
+        {
+            py = ground_y_limit + r;
+            if (vy < 0.0f)
+                vy = -vy * restitution;
+        }
+        if (walls_x && px - r < grid.min_x)
+        {
+            px = grid.min_x + r;
+            if (vx < 0.0f)
+                vx = -vx * restitution;
+        }
+        if (walls_x && px + r > grid.max_x)
+        {
+            px = grid.max_x - r;
+            if (vx > 0.0f)
+                vx = -vx * restitution;
+        }
+        if (walls_y && py + r > grid.max_y)
+        {
+            py = grid.max_y - r;
+            if (vy > 0.0f)
+                vy = -vy * restitution;
+        }
+
+        simulation_world.position_x[i] = px;
+        simulation_world.position_y[i] = py;
+        simulation_world.vel_x[i] = std::fabs(vx) < XPBD_VELOCITY_EPSILON ? 0.0f : vx;
+        simulation_world.vel_y[i] = std::fabs(vy) < XPBD_VELOCITY_EPSILON ? 0.0f : vy;
+    }
+}
+
+// ====================================================================
+// --- MAIN UPDATE LOOP ---
+// ====================================================================
+
+void xpbdSystem::update(world &simulation_world, float delta_time)
+{
+    if (simulation_world.integrator != IntegratorMode::XPBD)
+        return;
+    size_t n = simulation_world.position_x.size();
+    float dt = simulation_world.delta_time;
+    if (n == 0 || dt <= 0.0f)
+        return;
+
+    int substeps = std::max(1, simulation_world.xpbd_substeps);
+    float h = dt / float(substeps);
+    FrameArena &arena = simulation_world.frame_arena;
+    arena.reset(); // Temporaries of earlier systems (or steps) are dead
+
+    // 1. Contact candidates for the whole frame
+    ContactRows contacts = gather_contacts(simulation_world, dt);
+
+    // 2. Constraint colouring, pins held at their anchors with zero inverse mass
+    ConstraintSet &constraints = simulation_world.constraints;
+    constraints.update_colors(n);
+    float *inv_mass = arena.allocate<float>(n);
+    std::copy(simulation_world.inv_mass.begin(), simulation_world.inv_mass.end(), inv_mass);
+    for (size_t p = 0; p < constraints.num_pins(); ++p)
+    {
+        int i = constraints.pin_body[p];
+        if (i < 0 || size_t(i) >= n)
+            continue;
+        simulation_world.position_x[i] = constraints.pin_x[p];
+        simulation_world.position_y[i] = constraints.pin_y[p];
+        simulation_world.vel_x[i] = 0.0f;
+        simulation_world.vel_y[i] = 0.0f;
+        inv_mass[i] = 0.0f;
+    }
+
+    // Per-body velocity decay per substep: global + per-body damping, plus the
+    // linear friction drag the Verlet path applies as an acceleration.
+    float *decay = arena.allocate<float>(n);
+    for (size_t i = 0; i < n; ++i)
+        decay[i] = std::exp(-(simulation_world.global_damping + simulation_world.get_damping(i) + simulation_world.get_friction(i)) * h);
+
+    float *start_x = arena.allocate<float>(n);
+    float *start_y = arena.allocate<float>(n);
+    float *px = simulation_world.position_x.data();
+    float *py = simulation_world.position_y.data();
+    float *vx = simulation_world.vel_x.data();
+    float *vy = simulation_world.vel_y.data();
+    float inverse_h = 1.0f / h;
+
+    // 3. Substeps
+    for (int step = 0; step < substeps; ++step)
+    {
+        // a. Predict
+        for (size_t i = 0; i < n; ++i)
+        {
+            start_x[i] = px[i];
+            start_y[i] = py[i];
+            if (inv_mass[i] == 0.0f)
+                continue;
+            vx[i] += (simulation_world.gravity_x + simulation_world.acc_x[i]) * h;
+            vy[i] += (simulation_world.gravity_y + simulation_world.acc_y[i]) * h;
+            px[i] += vx[i] * h;
+            py[i] += vy[i] * h;
+        }
+
+        // b. Position solve
+        solve_constraints(simulation_world, inv_mass, h);
+        solve_contacts(simulation_world, contacts, inv_mass, h);
+
+        // c. Velocity from the displacement
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (inv_mass[i] == 0.0f)
+                continue;
+            vx[i] = (px[i] - start_x[i]) * inverse_h * decay[i];
+            vy[i] = (py[i] - start_y[i]) * inverse_h * decay[i];
+        }
+
+        // d. Velocity solve: restitution, then static geometry and walls
+        solve_contact_velocities(simulation_world, contacts, inv_mass, h);
+        solve_static_and_boundary(simulation_world, inv_mass);
+    }
+
+    // 4. Contacts of the frame
+    record_contacts(simulation_world, contacts);
+
+    // 5. Keep the Verlet state consistent so a world can switch integrators
+    //    (and renderers can interpolate) at any frame.
+    for (size_t i = 0; i < n; ++i)
+    {
+        simulation_world.previous_position_x[i] = px[i] - vx[i] * dt;
+        simulation_world.previous_position_y[i] = py[i] - vy[i] * dt;
+    }
+    if (simulation_world.grid_info.wraps_x() || simulation_world.grid_info.wraps_y())
+        broad_phase.wrap_periodic_positions(simulation_world);
+}
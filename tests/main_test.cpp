@@ -4,6 +4,29 @@ void test_world_constructors();
 void test_world_random_initialization();
 void test_collision_elastic();
 void test_collision_static();
+void test_collision_incremental_grid();
+void test_collision_contact_cache();
+void test_collision_events();
+void test_collision_layers();
+void test_collision_tiled_broad_phase();
+void test_collision_diagonal_neighbors();
+void test_collision_periodic();
+void test_collision_neighbor_list();
+void test_collision_islands();
+void test_collision_simd_batches();
+void test_frame_arena();
+void test_spatial_query();
+void test_static_geometry();
+void test_constraints();
+void test_integrator_stability();
+void test_force_fields();
+void test_mutual_gravity();
+void test_fluid();
+void test_world_batch();
+void test_physics_runner();
+void test_world_commands();
+void test_rollback();
+void test_streaming();
 
 int main()
 {
@@ -14,8 +37,30 @@ int main()
 
     test_collision_elastic();
     test_collision_static();
+    test_collision_incremental_grid();
+    test_collision_contact_cache();
+    test_collision_events();
+    test_collision_layers();
+    test_collision_tiled_broad_phase();
+    test_collision_diagonal_neighbors();
+    test_collision_periodic();
+    test_collision_neighbor_list();
+    test_collision_islands();
+    test_collision_simd_batches();
 
-    // Removed specific integrator stability tests as only Verlet is used now.
+    test_frame_arena();
+    test_spatial_query();
+    test_static_geometry();
+    test_constraints();
+    test_integrator_stability();
+    test_force_fields();
+    test_mutual_gravity();
+    test_fluid();
+    test_world_batch();
+    test_physics_runner();
+    test_world_commands();
+    test_rollback();
+    test_streaming();
 
     std::cout << "================= TESTS FINISHED =================\n";
     return 0;
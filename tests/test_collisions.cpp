@@ -1,6 +1,14 @@
 #include "utilities/test_helpers.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "sim/xpbdSystem.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 
 // tests/test_collisions.cpp
 
@@ -53,4 +61,668 @@ void test_collision_static()
     cs.update(w, 0.016f);
 
     std::cout << "Velocity A X: " << w.vel_x[0] << ", Velocity B X: " << w.vel_x[1] << "\n";
-}
\ No newline at end of file
+}
+// Checks the CSR grid of `w` against the body positions of `at_build`.
+static int count_grid_errors(const world &w, const world &at_build)
+{
+    int errors = 0;
+    size_t in_grid = 0;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        int cell = w.get_grid_index(at_build.get_position(i));
+        if (cell < 0)
+            continue;
+        ++in_grid;
+        int slot = w.particle_sorted_slot[i];
+        bool ok = slot >= w.particle_start_indices[cell] && slot < w.particle_start_indices[cell + 1] && w.sorted_indices[slot] == (int)i;
+        errors += ok ? 0 : 1;
+    }
+    errors += (in_grid == w.sorted_indices.size()) ? 0 : 1;
+    return errors;
+}
+
+void test_collision_incremental_grid()
+{
+    std::cout << "\n--- TEST: Incremental Grid Maintenance ---\n";
+
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    w.incremental_grid = true;
+    for (int i = 0; i < 300; ++i)
+        w.add_body(create_body(-60.0f + (i % 30) * 4.0f, 5.0f + (i / 30) * 4.0f, (i % 7) - 3.0f, 0, 1, 1.0f, 0.3f));
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+
+    size_t moved_while_falling = 0;
+    for (int t = 0; t < 600; ++t)
+    {
+        manager.update(w, w.delta_time);
+        if (t > 0 && t < 60)
+            moved_while_falling += w.grid_moved_bodies;
+    }
+
+    // Resolution moves bodies after the grid is built, so check against the
+    // positions the grid was built from.
+    movementSystem ms;
+    collisionSystem cs;
+    ms.update(w, w.delta_time);
+    world at_build = w;
+    cs.update(w, w.delta_time);
+    int errors = count_grid_errors(w, at_build);
+
+    std::cout << "Grid errors after 600 incremental steps: " << errors << " (Should be 0)\n";
+    std::cout << "Bodies re-binned during the first second: " << moved_while_falling << ", once settled: " << w.grid_moved_bodies << " (Should be near 0)\n";
+}
+
+void test_collision_contact_cache()
+{
+    std::cout << "\n--- TEST: Persistent Contact Cache ---\n";
+
+    // A rests on static B for a while, then is lifted away
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    w.persistent_contacts = true;
+    w.add_body(create_body(0, 2.95f, 0, 0, 1, 1.0f, 0.0f));
+    w.add_body(create_body(0, 1.0f, 0, 0, 0, 1.0f, 0.0f));
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+
+    manager.update(w, w.delta_time);
+    const ContactCacheEntry *entry = w.contacts.find(0, 1);
+    bool began = entry && w.contacts.began(*entry);
+
+    for (int t = 0; t < 30; ++t)
+        manager.update(w, w.delta_time);
+    entry = w.contacts.find(1, 0);
+    bool persisted = entry && w.contacts.touching(*entry) && !w.contacts.began(*entry);
+
+    w.set_position(0, vec2(0, 20.0f));
+    manager.update(w, w.delta_time);
+    entry = w.contacts.find(0, 1);
+    bool ended = entry && w.contacts.ended(*entry);
+
+    for (uint32_t t = 0; t <= w.contacts.max_age_frames; ++t)
+        manager.update(w, w.delta_time);
+    bool evicted = w.contacts.find(0, 1) == nullptr;
+
+    std::cout << "Contact began: " << began << ", persisted: " << persisted << ", ended: " << ended
+              << ", evicted: " << evicted << " (Should be 1, 1, 1, 1)\n";
+
+    // Removing a body drops only its contacts; the body swapped into its slot
+    // keeps its contact under the new index, still persisting (no new Begin)
+    world pile;
+    pile.gravity_x = 0.0f;
+    pile.gravity_y = -9.8f;
+    pile.delta_time = 0.016f;
+    pile.persistent_contacts = true;
+    pile.add_body(create_body(0, 2.95f, 0, 0, 1, 1.0f, 0.0f));  // 0 on static 1
+    pile.add_body(create_body(0, 1.0f, 0, 0, 0, 1.0f, 0.0f));
+    pile.add_body(create_body(10, 2.95f, 0, 0, 1, 1.0f, 0.0f)); // 2 on static 3
+    pile.add_body(create_body(10, 1.0f, 0, 0, 0, 1.0f, 0.0f));
+    for (int t = 0; t < 30; ++t)
+        manager.update(pile, pile.delta_time);
+    pile.remove_body(0); // Static body 3 moves to index 0
+    const ContactCacheEntry *moved = pile.contacts.find(0, 2);
+    bool rekeyed = moved && moved->manifold.body_A == 0 && moved->manifold.body_B == 2 && pile.contacts.find(0, 1) == nullptr;
+    manager.update(pile, pile.delta_time);
+    moved = pile.contacts.find(2, 0);
+    bool still_persisting = moved && pile.contacts.touching(*moved) && !pile.contacts.began(*moved);
+    std::cout << "After a removal, contact re-keyed: " << rekeyed << ", still persisting: " << still_persisting << " (Should be 1, 1)\n";
+
+    // A pair recorded with body_A > body_B: after a removal moves body 3 to
+    // index 0, the normal must still point from the moved body to body 1
+    ContactCache cache;
+    cache.begin_frame();
+    ContactManifold reversed;
+    reversed.body_A = 3;
+    reversed.body_B = 1;
+    reversed.normal_direction = vec2(1.0f, 0.0f); // From 3 to 1
+    cache.record(reversed);
+    cache.on_body_removed(0, 3);
+    const ContactCacheEntry *flipped = cache.find(0, 1);
+    bool normal_kept = flipped && flipped->manifold.body_A == 0 && flipped->manifold.normal_direction.x == 1.0f;
+    std::cout << "Reversed pair re-keyed with its normal from A to B: " << normal_kept << " (Should be 1)\n";
+
+    // Same through the events: the End event of a re-keyed pair points from body_A to body_B
+    world events;
+    events.gravity_x = 0.0f;
+    events.gravity_y = 0.0f;
+    events.delta_time = 0.016f;
+    events.report_collision_events = true;
+    events.add_body(create_body(-30.0f, 20.0f, 0, 0, 1, 1.0f, 0.0f)); // Removed later
+    events.add_body(create_body(1.5f, 20.0f, 0, 0, 1, 1.0f, 0.0f));
+    events.add_body(create_body(0.0f, 20.0f, 0, 0, 1, 1.0f, 0.0f));
+    manager.update(events, events.delta_time);
+    events.remove_body(0); // Body 2 moves to index 0
+    events.set_position(1, vec2(30.0f, 20.0f));
+    manager.update(events, events.delta_time);
+    bool end_normal_ok = false;
+    for (const CollisionEvent &event : events.collision_events.events())
+        if (event.type == CollisionEventType::End && event.body_A == 0 && event.body_B == 1)
+            end_normal_ok = event.normal.x > 0.9f; // Body 0 (was 2) sat left of body 1
+    std::cout << "End event normal of the re-keyed pair from A to B: " << end_normal_ok << " (Should be 1)\n";
+}
+
+void test_collision_events()
+{
+    std::cout << "\n--- TEST: Collision Event Stream ---\n";
+
+    // Two bodies approach head-on, bounce, and separate
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 0.016f;
+    w.report_collision_events = true;
+    body A = create_body(-2.0f, 10.0f, 5, 0, 1, 1.0f, 1.0f);
+    body B = create_body(2.0f, 10.0f, -5, 0, 1, 1.0f, 1.0f);
+    A.collision_category = 1u << 0;
+    B.collision_category = 1u << 1;
+    // Verlet derives velocity from the previous position
+    A.previous_position = A.position - A.velocity * w.delta_time;
+    B.previous_position = B.position - B.velocity * w.delta_time;
+    w.add_body(A);
+    w.add_body(B);
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+
+    int begins = 0, ends = 0;
+    float begin_impulse = 0.0f;
+    std::vector<CollisionEvent> filtered_out;
+    for (int t = 0; t < 60; ++t)
+    {
+        manager.update(w, w.delta_time);
+        for (const auto &event : w.collision_events.events())
+        {
+            if (event.type == CollisionEventType::Begin)
+            {
+                ++begins;
+                begin_impulse = event.impulse;
+            }
+            if (event.type == CollisionEventType::End)
+                ++ends;
+        }
+        // Neither body is on layer 2, and no impulse reaches 1e6
+        w.collision_events.filter(w, CollisionEventFilter{1u << 2, 0.0f}, filtered_out);
+        w.collision_events.filter(w, CollisionEventFilter{~0u, 1e6f}, filtered_out);
+    }
+
+    std::cout << "Begin events: " << begins << ", End events: " << ends << " (Should be 1, 1)\n";
+    std::cout << "Begin impulse: " << begin_impulse << " (Should be > 0), filtered events: " << filtered_out.size() << " (Should be 0)\n";
+
+    // Same collision under XPBD: xpbdSystem feeds the cache and the events
+    world xpbd;
+    xpbd.gravity_x = 0.0f;
+    xpbd.gravity_y = 0.0f;
+    xpbd.delta_time = 0.016f;
+    xpbd.integrator = IntegratorMode::XPBD;
+    xpbd.report_collision_events = true;
+    xpbd.add_body(A);
+    xpbd.add_body(B);
+    systemManager xpbd_manager;
+    xpbd_manager.addSystem(std::make_unique<xpbdSystem>());
+    xpbd_manager.addSystem(std::make_unique<collisionSystem>());
+    int xpbd_begins = 0, xpbd_ends = 0;
+    float xpbd_impulse = 0.0f;
+    bool cached = false;
+    for (int t = 0; t < 60; ++t)
+    {
+        xpbd_manager.update(xpbd, xpbd.delta_time);
+        for (const auto &event : xpbd.collision_events.events())
+        {
+            if (event.type == CollisionEventType::Begin)
+            {
+                ++xpbd_begins;
+                xpbd_impulse = event.impulse;
+                cached = xpbd.contacts.find(0, 1) != nullptr;
+            }
+            if (event.type == CollisionEventType::End)
+                ++xpbd_ends;
+        }
+    }
+    std::cout << "XPBD Begin / End events: " << xpbd_begins << " / " << xpbd_ends << " (Should be 1 / 1)\n";
+    std::cout << "XPBD Begin impulse: " << xpbd_impulse << ", pair cached: " << cached << " (Should be > 0, 1)\n";
+}
+
+void test_collision_layers()
+{
+    std::cout << "\n--- TEST: Collision Layers (category/mask) ---\n";
+
+    const uint32_t ACTOR = 1u << 0;
+    const uint32_t DEBRIS = 1u << 1;
+
+    // Same overlapping setup as the elastic test, once debris-vs-debris and once debris-vs-actor
+    auto run = [&](uint32_t category_B, uint32_t mask_B)
+    {
+        body A = create_body(-1.0f, 10.0f, 1, 0, 1, 1.0f, 1.0f);
+        body B = create_body(0.9f, 10.0f, -1, 0, 1, 1.0f, 1.0f);
+        A.collision_category = DEBRIS;
+        A.collision_mask = ACTOR;
+        B.collision_category = category_B;
+        B.collision_mask = mask_B;
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = 0.0f;
+        w.delta_time = 0.016f;
+        w.add_body(A);
+        w.add_body(B);
+        collisionSystem cs;
+        cs.update(w, w.delta_time);
+        return w.vel_x[0];
+    };
+
+    std::cout << "Debris vs debris, velocity A X: " << run(DEBRIS, ACTOR) << " (Should be 1, no collision)\n";
+    std::cout << "Debris vs actor, velocity A X: " << run(ACTOR, ACTOR | DEBRIS) << " (Should be -1)\n";
+}
+
+void test_collision_tiled_broad_phase()
+{
+    std::cout << "\n--- TEST: Tiled Broad Phase vs Pair List ---\n";
+
+    // Overlapping lattice spanning several 8x8 cell blocks; neighbours at 1.2
+    // and diagonals at 1.7 touch, the next ring (2.4) does not. Every 7th body is static.
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 0.016f;
+    w.persistent_contacts = true;
+    const int side = 70;
+    for (int i = 0; i < side * side; ++i)
+        w.add_body(create_body(-50.0f + (i % side) * 1.2f, -50.0f + (i / side) * 1.2f, 0, 0, i % 7 == 0 ? 0.0f : 1.0f, 1.0f, 0.5f));
+
+    size_t expected = 0;
+    for (size_t a = 0; a < w.size(); ++a)
+        for (size_t b = a + 1; b < w.size(); ++b)
+        {
+            float dx = w.position_x[a] - w.position_x[b];
+            float dy = w.position_y[a] - w.position_y[b];
+            float reach = w.radius[a] + w.radius[b];
+            if ((w.inv_mass[a] != 0.0f || w.inv_mass[b] != 0.0f) && dx * dx + dy * dy <= reach * reach)
+                ++expected;
+        }
+
+    world tiled = w;
+    tiled.tiled_broad_phase = true;
+    collisionSystem cs;
+    cs.update(w, w.delta_time);
+    cs.update(tiled, tiled.delta_time);
+
+    size_t mismatches = 0;
+    w.contacts.for_each([&](const ContactCacheEntry &entry)
+    {
+        if (!tiled.contacts.find(entry.manifold.body_A, entry.manifold.body_B))
+            ++mismatches;
+    });
+    std::cout << "Contacts (brute force / pair list / tiled): " << expected << " / " << w.contacts.size() << " / " << tiled.contacts.size() << " (Should be equal)\n";
+    std::cout << "Pair-list contacts missing from tiled: " << mismatches << " (Should be 0)\n";
+}
+
+void test_collision_diagonal_neighbors()
+{
+    std::cout << "\n--- TEST: Contacts Across Cell Diagonals ---\n";
+
+    // Two bodies approaching each other across the corner at (10, 10), where four
+    // cells meet. Each pair sits in diagonally opposite cells: (+x,-y)/(-x,+y)
+    // is the down-left neighbour, (-x,-y)/(+x,+y) the down-right one.
+    auto run = [&](float sign_x, bool tiled)
+    {
+        body A = create_body(10.0f + 0.3f * sign_x, 9.7f, -1.0f * sign_x, 1.0f, 1, 0.5f, 1.0f);
+        body B = create_body(10.0f - 0.3f * sign_x, 10.3f, 1.0f * sign_x, -1.0f, 1, 0.5f, 1.0f);
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = 0.0f;
+        w.delta_time = 0.016f;
+        w.tiled_broad_phase = tiled;
+        w.add_body(A);
+        w.add_body(B);
+        int cell_A = w.get_grid_index(vec2(w.position_x[0], w.position_y[0]));
+        int cell_B = w.get_grid_index(vec2(w.position_x[1], w.position_y[1]));
+        bool diagonal = cell_A != cell_B && std::abs(cell_A % w.grid_info.num_cells_x - cell_B % w.grid_info.num_cells_x) == 1 &&
+                        std::abs(cell_A / w.grid_info.num_cells_x - cell_B / w.grid_info.num_cells_x) == 1;
+        collisionSystem cs;
+        cs.update(w, w.delta_time);
+        // Elastic head-on collision along the diagonal: A's velocity reverses
+        return diagonal && w.vel_x[0] * sign_x > 0.0f && w.vel_y[0] < 0.0f;
+    };
+
+    std::cout << "Down-left diagonal resolved (pair list / tiled): " << run(1.0f, false) << " / " << run(1.0f, true) << " (Should be 1 / 1)\n";
+    std::cout << "Down-right diagonal resolved (pair list / tiled): " << run(-1.0f, false) << " / " << run(-1.0f, true) << " (Should be 1 / 1)\n";
+
+    // Neighbour table: every adjacent cell pair appears exactly once
+    world w;
+    int nx = w.grid_info.num_cells_x, ny = w.grid_info.num_cells_y;
+    int expected_links = (nx - 1) * ny + nx * (ny - 1) + 2 * (nx - 1) * (ny - 1);
+    int links = 0;
+    for (int n : w.grid_info.cell_neighbors)
+        links += n >= 0 ? 1 : 0;
+    std::cout << "Neighbour table links: " << links << " (Should be " << expected_links << ")\n";
+}
+
+void test_collision_periodic()
+{
+    std::cout << "\n--- TEST: Periodic Boundaries ---\n";
+
+    auto make_periodic_world = [](bool tiled)
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = 0.0f;
+        w.delta_time = 0.016f;
+        w.grid_info.periodic_x = true;
+        w.grid_info.periodic_y = true;
+        w.tiled_broad_phase = tiled;
+        w.resize_grid();
+        return w;
+    };
+
+    // 1. Head-on contact across the x seam: A just right of min_x moving left, B just left of max_x moving right
+    auto seam_collision = [&](bool tiled)
+    {
+        world w = make_periodic_world(tiled);
+        w.add_body(create_body(w.grid_info.min_x + 0.3f, 10.0f, -1.0f, 0, 1, 0.5f, 1.0f));
+        w.add_body(create_body(w.grid_info.max_x - 0.3f, 10.0f, 1.0f, 0, 1, 0.5f, 1.0f));
+        collisionSystem cs;
+        cs.update(w, w.delta_time);
+        return w.vel_x[0] > 0.0f && w.vel_x[1] < 0.0f;
+    };
+    std::cout << "Collision across the seam (pair list / tiled): " << seam_collision(false) << " / " << seam_collision(true) << " (Should be 1 / 1)\n";
+
+    // 2. A body leaving through max_x re-enters at min_x with its velocity
+    world w = make_periodic_world(false);
+    w.add_body(create_body(w.grid_info.max_x - 0.2f, 10.0f, 5.0f, 0, 1, 0.5f, 1.0f));
+    w.previous_position_x[0] = w.position_x[0] - 5.0f * w.delta_time;
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    for (int t = 0; t < 5; ++t)
+        manager.update(w, w.delta_time);
+    bool wrapped = w.position_x[0] >= w.grid_info.min_x && w.position_x[0] < w.grid_info.min_x + 1.0f;
+    std::cout << "Wrapped to the min_x side: " << wrapped << ", velocity X: " << w.vel_x[0] << " (Should be 1, ~5)\n";
+
+    // 3. Lattice straddling both seams: contacts match a minimum-image brute force
+    size_t found[2] = {0, 0};
+    size_t expected = 0;
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        world lattice = make_periodic_world(mode == 1);
+        lattice.persistent_contacts = true;
+        const int side = 12;
+        for (int i = 0; i < side * side; ++i)
+        {
+            float x = lattice.grid_info.max_x - 7.0f + (i % side) * 1.2f;
+            float y = lattice.grid_info.max_y - 7.0f + (i / side) * 1.2f;
+            x = x >= lattice.grid_info.max_x ? x - lattice.grid_info.period_x() : x;
+            y = y >= lattice.grid_info.max_y ? y - lattice.grid_info.period_y() : y;
+            lattice.add_body(create_body(x, y, 0, 0, 1, 1.0f, 0.5f));
+        }
+        if (mode == 0)
+        {
+            for (size_t a = 0; a < lattice.size(); ++a)
+                for (size_t b = a + 1; b < lattice.size(); ++b)
+                {
+                    float dx = lattice.grid_info.minimum_image_x(lattice.position_x[a] - lattice.position_x[b]);
+                    float dy = lattice.grid_info.minimum_image_y(lattice.position_y[a] - lattice.position_y[b]);
+                    float reach = lattice.radius[a] + lattice.radius[b];
+                    if (dx * dx + dy * dy <= reach * reach)
+                        ++expected;
+                }
+        }
+        collisionSystem cs;
+        cs.update(lattice, lattice.delta_time);
+        found[mode] = lattice.contacts.size();
+    }
+    std::cout << "Contacts (brute force / pair list / tiled): " << expected << " / " << found[0] << " / " << found[1] << " (Should be equal)\n";
+}
+
+void test_collision_neighbor_list()
+{
+    std::cout << "\n--- TEST: Verlet Neighbour List (skin reuse) ---\n";
+
+    // Dense granular gas: radius 0.5 at spacing 1.05, random speeds up to ~1.4 m/s
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 1.0f / 60.0f;
+    w.neighbor_lists = true;
+    w.neighbor_skin = 0.4f;
+    const int side = 25;
+    std::srand(3);
+    for (int i = 0; i < side * side; ++i)
+    {
+        float vx = float(std::rand()) / float(RAND_MAX) * 2.0f - 1.0f;
+        float vy = float(std::rand()) / float(RAND_MAX) * 2.0f - 1.0f;
+        w.add_body(create_body(-13.0f + (i % side) * 1.05f, 10.0f + (i / side) * 1.05f, vx, vy, 1, 0.5f, 0.9f));
+        w.previous_position_x[i] = w.position_x[i] - vx * w.delta_time;
+        w.previous_position_y[i] = w.position_y[i] - vy * w.delta_time;
+    }
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+
+    // Invariant: whenever the list is reused, every overlapping pair is in it
+    const int frames = 240;
+    int missing = 0;
+    int checked_frames = 0;
+    for (int t = 0; t < frames; ++t)
+    {
+        manager.update(w, w.delta_time);
+        if (w.neighbor_list.needs_rebuild(w, w.neighbor_skin))
+            continue;
+        ++checked_frames;
+        for (size_t a = 0; a < w.size(); ++a)
+            for (size_t b = a + 1; b < w.size(); ++b)
+            {
+                float dx = w.position_x[a] - w.position_x[b];
+                float dy = w.position_y[a] - w.position_y[b];
+                float reach = w.radius[a] + w.radius[b];
+                if (dx * dx + dy * dy < reach * reach && !w.neighbor_list.contains(int(a), int(b)))
+                    ++missing;
+            }
+    }
+    std::cout << "Frames checked with a reusable list: " << checked_frames << " (Should be > 0)\n";
+    std::cout << "Overlapping pairs missing from the list: " << missing << " (Should be 0)\n";
+    std::cout << "List builds over " << frames << " frames: " << w.neighbor_list.rebuild_count << " (Should be < 40)\n";
+
+    // Adding a body forces a rebuild
+    uint64_t builds = w.neighbor_list.rebuild_count;
+    w.add_body(create_body(40.0f, 10.0f, 0, 0, 1, 0.5f));
+    manager.update(w, w.delta_time);
+    std::cout << "Rebuilt after add_body: " << (w.neighbor_list.rebuild_count == builds + 1) << " (Should be 1)\n";
+
+    // A skin wider than the cell allows is clamped: the list still holds every
+    // overlapping pair of two bodies drifting towards each other across cells
+    world wide;
+    wide.gravity_x = 0.0f;
+    wide.gravity_y = 0.0f;
+    wide.delta_time = 1.0f / 60.0f;
+    wide.neighbor_lists = true;
+    wide.neighbor_skin = 20.0f;
+    wide.add_body(create_body(1.0f, 10.0f, 0, 0, 1, 2.0f));
+    wide.add_body(create_body(5.6f, 10.0f, 0, 0, 1, 2.0f));
+    collisionSystem collide;
+    collide.update(wide, wide.delta_time);
+    float clamped_skin = wide.grid_info.cell_size - 4.0f;
+    std::cout << "Clamped skin used for the build: " << (wide.neighbor_list.built_skin == clamped_skin) << " (Should be 1)\n";
+    std::cout << "Pair within the clamped skin listed: " << wide.neighbor_list.contains(0, 1) << " (Should be 1)\n";
+
+    // Bodies wider than half a cell leave no skin: grid pairs are used instead
+    wide.add_body(create_body(30.0f, 10.0f, 0, 0, 1, 3.0f));
+    wide.add_body(create_body(34.0f, 10.0f, 0, 0, 1, 3.0f));
+    collide.update(wide, wide.delta_time);
+    std::cout << "List left unused for large bodies: " << wide.neighbor_list.needs_rebuild(wide, 0.0f) << " (Should be 1)\n";
+    std::cout << "Large overlapping bodies pushed apart: " << (wide.position_x[3] - wide.position_x[2] > 4.0f) << " (Should be 1)\n";
+}
+
+void test_collision_islands()
+{
+    std::cout << "\n--- TEST: Contact Islands (union-find, thread pool) ---\n";
+
+    // Six overlapping 4x4 clumps far apart, each bridged to its neighbour by a
+    // shared static post: statics must not merge islands.
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    w.persistent_contacts = true;
+    const int clumps = 6;
+    for (int c = 0; c < clumps; ++c)
+    {
+        float origin_x = -75.0f + c * 25.0f;
+        for (int i = 0; i < 16; ++i)
+            w.add_body(create_body(origin_x + (i % 4) * 0.9f, 20.0f + (i / 4) * 0.9f, 0, 0, 1, 0.5f, 0.3f));
+        if (c + 1 < clumps)
+        {
+            // Post touching this clump's right column and a lone body on its right
+            w.add_body(create_body(origin_x + 3.6f, 20.0f, 0, 0, 0, 0.5f, 0.3f));
+            w.add_body(create_body(origin_x + 4.5f, 20.0f, 0, 0, 1, 0.5f, 0.3f));
+        }
+    }
+
+    world islands = w;
+    islands.island_solving = true;
+    ThreadPool pool(4);
+    systemManager serial_manager;
+    serial_manager.addSystem(std::make_unique<movementSystem>());
+    serial_manager.addSystem(std::make_unique<collisionSystem>());
+    systemManager island_manager;
+    island_manager.addSystem(std::make_unique<movementSystem>());
+    island_manager.addSystem(std::make_unique<collisionSystem>(&pool));
+
+    serial_manager.update(w, w.delta_time);
+    island_manager.update(islands, islands.delta_time);
+    std::cout << "Islands in the first step: " << islands.contact_island_count << " (Should be 11)\n";
+
+    for (int t = 1; t < 180; ++t)
+    {
+        serial_manager.update(w, w.delta_time);
+        island_manager.update(islands, islands.delta_time);
+    }
+    size_t differing = 0;
+    for (size_t i = 0; i < w.size(); ++i)
+        if (w.position_x[i] != islands.position_x[i] || w.position_y[i] != islands.position_y[i] ||
+            w.vel_x[i] != islands.vel_x[i] || w.vel_y[i] != islands.vel_y[i])
+            ++differing;
+    std::cout << "Bodies differing from the serial solve after 180 steps: " << differing << " (Should be 0)\n";
+    std::cout << "Cached contacts serial / islands: " << w.contacts.size() << " / " << islands.contacts.size() << " (Should be equal)\n";
+}
+
+void test_collision_simd_batches()
+{
+    std::cout << "\n--- TEST: SIMD Contact Batches vs Scalar Resolve ---\n";
+
+    // Disjoint colliding pairs (no shared bodies): batch order cannot matter,
+    // so one step must match the scalar resolver exactly
+    world pairs;
+    pairs.gravity_x = 0.0f;
+    pairs.gravity_y = 0.0f;
+    pairs.delta_time = 1.0f / 60.0f;
+    pairs.persistent_contacts = true;
+    std::srand(11);
+    for (int i = 0; i < 300; ++i)
+    {
+        float x = -90.0f + (i % 30) * 6.0f;
+        float y = -90.0f + (i / 30) * 6.0f;
+        float offset_y = float(std::rand()) / float(RAND_MAX) - 0.5f;
+        float speed = float(std::rand()) / float(RAND_MAX) * 4.0f;
+        pairs.add_body(create_body(x, y, speed, 0, 1, 0.5f, 0.4f));
+        pairs.add_body(create_body(x + 0.8f, y + offset_y, -speed, 0, i % 5 == 0 ? 0.0f : 2.0f, 0.5f, 0.8f));
+    }
+    world batched = pairs;
+    batched.simd_contact_solver = true;
+    collisionSystem cs;
+    cs.update(pairs, pairs.delta_time);
+    cs.update(batched, batched.delta_time);
+    float worst = 0.0f;
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        worst = std::max(worst, std::fabs(pairs.position_x[i] - batched.position_x[i]) + std::fabs(pairs.position_y[i] - batched.position_y[i]));
+        worst = std::max(worst, std::fabs(pairs.vel_x[i] - batched.vel_x[i]) + std::fabs(pairs.vel_y[i] - batched.vel_y[i]));
+        worst = std::max(worst, std::fabs(pairs.previous_position_x[i] - batched.previous_position_x[i]) + std::fabs(pairs.previous_position_y[i] - batched.previous_position_y[i]));
+    }
+    std::cout << "Contacts scalar / batched: " << pairs.contacts.size() << " / " << batched.contacts.size() << " (Should be equal)\n";
+    std::cout << "Worst state difference on disjoint pairs: " << worst << " (Should be 0)\n";
+
+    // Same across the periodic seams (minimum image inside the batch)
+    world seam;
+    seam.gravity_x = 0.0f;
+    seam.gravity_y = 0.0f;
+    seam.delta_time = 1.0f / 60.0f;
+    seam.grid_info.periodic_x = true;
+    seam.grid_info.periodic_y = true;
+    seam.resize_grid();
+    for (int i = 0; i < 20; ++i)
+    {
+        float y = -90.0f + i * 9.0f;
+        seam.add_body(create_body(-99.7f, y, -1.0f - 0.1f * i, 0, 1, 0.5f, 0.5f));
+        seam.add_body(create_body(99.6f, y + 0.2f, 1.0f, 0, 1, 0.5f, 0.5f));
+        seam.add_body(create_body(y, -99.7f, 0, -1.0f, 1, 0.5f, 0.5f));
+        seam.add_body(create_body(y + 0.3f, 99.6f, 0, 1.0f + 0.1f * i, 1, 0.5f, 0.5f));
+    }
+    world seam_batched = seam;
+    seam_batched.simd_contact_solver = true;
+    cs.update(seam, seam.delta_time);
+    cs.update(seam_batched, seam_batched.delta_time);
+    float seam_worst = 0.0f;
+    for (size_t i = 0; i < seam.size(); ++i)
+        seam_worst = std::max(seam_worst, std::fabs(seam.vel_x[i] - seam_batched.vel_x[i]) + std::fabs(seam.vel_y[i] - seam_batched.vel_y[i]) +
+                                              std::fabs(seam.position_x[i] - seam_batched.position_x[i]) + std::fabs(seam.position_y[i] - seam_batched.position_y[i]));
+    std::cout << "Seam pairs batched: " << seam_batched.contact_batch_count << " batches, worst difference " << seam_worst << " (Should be > 0 batches, 0)\n";
+
+    // Dense pile: bodies share contacts, so batches must split them
+    auto make_pile = [](bool simd)
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = -9.8f;
+        w.delta_time = 1.0f / 60.0f;
+        w.simd_contact_solver = simd;
+        for (int i = 0; i < 30 * 6; ++i)
+            w.add_body(create_body(-15.0f + (i % 30) * 1.0f, 0.6f + (i / 30) * 1.0f, 0, 0, 1, 0.5f, 0.1f));
+        return w;
+    };
+    world scalar_pile = make_pile(false);
+    world simd_pile = make_pile(true);
+    systemManager scalar_manager;
+    scalar_manager.addSystem(std::make_unique<movementSystem>());
+    scalar_manager.addSystem(std::make_unique<collisionSystem>());
+    systemManager simd_manager;
+    simd_manager.addSystem(std::make_unique<movementSystem>());
+    simd_manager.addSystem(std::make_unique<collisionSystem>());
+    for (int t = 0; t < 240; ++t)
+    {
+        scalar_manager.update(scalar_pile, scalar_pile.delta_time);
+        simd_manager.update(simd_pile, simd_pile.delta_time);
+    }
+    auto mean_overlap = [](const world &w)
+    {
+        float total = 0.0f;
+        int touching = 0;
+        for (size_t a = 0; a < w.size(); ++a)
+            for (size_t b = a + 1; b < w.size(); ++b)
+            {
+                float dx = w.position_x[a] - w.position_x[b];
+                float dy = w.position_y[a] - w.position_y[b];
+                float overlap = w.radius[a] + w.radius[b] - std::sqrt(dx * dx + dy * dy);
+                if (overlap > 0.0f)
+                {
+                    total += overlap;
+                    ++touching;
+                }
+            }
+        return touching > 0 ? total / touching : 0.0f;
+    };
+    auto highest_body = [](const world &w) { return *std::max_element(w.position_y.begin(), w.position_y.end()); };
+    std::cout << "Mean overlap scalar / SIMD: " << mean_overlap(scalar_pile) << " / " << mean_overlap(simd_pile) << " (Should be close)\n";
+    std::cout << "Pile height scalar / SIMD: " << highest_body(scalar_pile) << " / " << highest_body(simd_pile) << " (Should be close)\n";
+    std::cout << "Batches in the last step: " << simd_pile.contact_batch_count << " (Should be > 0)\n";
+}
@@ -0,0 +1,155 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/constraintSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+// tests/test_constraints.cpp
+
+static float body_distance(const world &w, int a, int b)
+{
+    float dx = w.position_x[a] - w.position_x[b];
+    float dy = w.position_y[a] - w.position_y[b];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// side x side cloth hanging from its two top corners, structural rows only
+static world make_cloth(int side)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    for (int i = 0; i < side * side; ++i)
+        w.add_body(create_body(-10.0f + (i % side) * 1.0f, 80.0f - (i / side) * 1.0f, 0, 0, 1, 0.2f, 0.0f));
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x)
+        {
+            int i = y * side + x;
+            if (x + 1 < side)
+                w.constraints.add_distance(i, i + 1, 1.0f);
+            if (y + 1 < side)
+                w.constraints.add_distance(i, i + side, 1.0f);
+        }
+    w.constraints.add_pin(0, vec2(w.position_x[0], w.position_y[0]));
+    w.constraints.add_pin(side - 1, vec2(w.position_x[side - 1], w.position_y[side - 1]));
+    return w;
+}
+
+void test_constraints_rope_and_pin()
+{
+    std::cout << "\n--- TEST: Constraints (pinned rope under gravity) ---\n";
+
+    // 10-link rope pinned at its first body, starting horizontal
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    w.constraints.iterations = 16;
+    for (int i = 0; i <= 10; ++i)
+        w.add_body(create_body(float(i), 60.0f, 0, 0, 1, 0.2f, 0.0f));
+    for (int i = 0; i < 10; ++i)
+        w.constraints.add_distance(i, i + 1, 1.0f);
+    w.constraints.add_pin(0, vec2(0.0f, 60.0f));
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<constraintSystem>());
+    float max_stretch = 0.0f;
+    float lowest_end = w.position_y[10];
+    for (int t = 0; t < 300; ++t)
+    {
+        manager.update(w, w.delta_time);
+        lowest_end = std::min(lowest_end, w.position_y[10]);
+        for (int i = 0; i < 10; ++i)
+            max_stretch = std::max(max_stretch, std::fabs(body_distance(w, i, i + 1) - 1.0f));
+    }
+    std::cout << "Pinned body: (" << w.position_x[0] << ", " << w.position_y[0] << ") (Should be (0, 60))\n";
+    std::cout << "Lowest point of the swinging rope end: " << lowest_end << " (Should be ~50, one rope length below the pin)\n";
+    std::cout << "Max link stretch over 300 steps: " << max_stretch << " (Should be < 0.05)\n";
+    std::cout << "Colours for a chain: " << w.constraints.num_colors() << " (Should be 2)\n";
+}
+
+void test_constraints_spring()
+{
+    std::cout << "\n--- TEST: Constraints (spring vs rigid distance) ---\n";
+
+    auto stretched_pair = [](float stiffness)
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = 0.0f;
+        w.delta_time = 0.016f;
+        w.constraints.iterations = 1;
+        w.add_body(create_body(0.0f, 50.0f, 0, 0, 1, 0.2f));
+        w.add_body(create_body(4.0f, 50.0f, 0, 0, 1, 0.2f));
+        w.constraints.add_spring(0, 1, 2.0f, stiffness);
+        constraintSystem cs;
+        cs.update(w, w.delta_time);
+        return body_distance(w, 0, 1);
+    };
+    std::cout << "Distance after one pass, rigid: " << stretched_pair(1.0f) << " (Should be 2)\n";
+    std::cout << "Distance after one pass, spring k=0.25: " << stretched_pair(0.25f) << " (Should be 3.5)\n";
+}
+
+void test_constraints_coloring_and_parallel()
+{
+    std::cout << "\n--- TEST: Constraints (graph colouring, parallel batches) ---\n";
+
+    world serial = make_cloth(40);
+    world parallel = serial;
+
+    serial.constraints.update_colors(serial.size());
+    const ConstraintSet &set = serial.constraints;
+    int conflicts = 0;
+    std::vector<int> seen(serial.size(), -1);
+    for (size_t c = 0; c < set.num_colors(); ++c)
+        for (int k = set.color_start[c]; k < set.color_start[c + 1]; ++k)
+        {
+            int r = set.colored_rows[k];
+            for (int body : {set.body_a[r], set.body_b[r]})
+            {
+                conflicts += seen[body] == int(c) ? 1 : 0;
+                seen[body] = int(c);
+            }
+        }
+    std::cout << "Rows: " << set.num_rows() << ", coloured: " << set.colored_rows.size() << " (Should be equal)\n";
+    std::cout << "Colours: " << set.num_colors() << ", bodies shared inside a colour: " << conflicts << " (Should be <= 4, 0)\n";
+
+    ThreadPool pool(4);
+    systemManager serial_manager, parallel_manager;
+    serial_manager.addSystem(std::make_unique<movementSystem>());
+    serial_manager.addSystem(std::make_unique<constraintSystem>());
+    parallel_manager.addSystem(std::make_unique<movementSystem>());
+    parallel_manager.addSystem(std::make_unique<constraintSystem>(&pool));
+    for (int t = 0; t < 60; ++t)
+    {
+        serial_manager.update(serial, serial.delta_time);
+        parallel_manager.update(parallel, parallel.delta_time);
+    }
+    int mismatches = 0;
+    for (size_t i = 0; i < serial.size(); ++i)
+        mismatches += (serial.position_x[i] != parallel.position_x[i] || serial.position_y[i] != parallel.position_y[i]) ? 1 : 0;
+    std::cout << "Pooled vs serial position mismatches: " << mismatches << " (Should be 0)\n";
+
+    // Swap-removal keeps rows consistent
+    world removed = make_cloth(4);
+    size_t rows_before = removed.constraints.num_rows();
+    removed.remove_body(5); // interior body with 4 rows; body 15 moves into slot 5
+    bool renumbered = true;
+    for (size_t r = 0; r < removed.constraints.num_rows(); ++r)
+        renumbered &= removed.constraints.body_a[r] < int(removed.size()) && removed.constraints.body_b[r] < int(removed.size());
+    std::cout << "Rows after removing an interior body: " << removed.constraints.num_rows() << " of " << rows_before
+              << ", all indices valid: " << renumbered << " (Should be 20 of 24, 1)\n";
+}
+
+void test_constraints()
+{
+    test_constraints_rope_and_pin();
+    test_constraints_spring();
+    test_constraints_coloring_and_parallel();
+}
@@ -0,0 +1,188 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/fluidSystem.hpp"
+#include "sim/forceFieldSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+// tests/test_fluid.cpp
+
+static world make_fluid_world()
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.0f;
+    w.sph_fluid = true;
+    return w;
+}
+
+// Brute-force SPH over every pair, with the same kernels as fluidSystem
+static void reference_fluid(const world &w, std::vector<float> &rho, std::vector<float> &ax, std::vector<float> &ay)
+{
+    const float pi = 3.14159265f;
+    float h = w.fluid_smoothing_radius;
+    float h2 = h * h;
+    size_t n = w.size();
+    rho.assign(n, 0.0f);
+    ax.assign(n, 0.0f);
+    ay.assign(n, 0.0f);
+    std::vector<float> p(n, 0.0f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            float dx = w.position_x[j] - w.position_x[i], dy = w.position_y[j] - w.position_y[i];
+            float q = std::max(h2 - (dx * dx + dy * dy), 0.0f);
+            rho[i] += w.mass[j] * 4.0f / (pi * std::pow(h, 8.0f)) * q * q * q;
+        }
+        p[i] = w.fluid_stiffness * std::max(rho[i] - w.fluid_rest_density, 0.0f);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            float dx = w.position_x[j] - w.position_x[i], dy = w.position_y[j] - w.position_y[i];
+            float r = std::sqrt(dx * dx + dy * dy);
+            if (i == j || r >= h)
+                continue;
+            float push = w.mass[j] * (p[i] / (rho[i] * rho[i]) + p[j] / (rho[j] * rho[j])) * 30.0f / (pi * std::pow(h, 5.0f)) * (h - r) * (h - r) / r;
+            float drag = w.fluid_viscosity / rho[i] * w.mass[j] / rho[j] * 40.0f / (pi * std::pow(h, 5.0f)) * (h - r);
+            ax[i] += drag * (w.vel_x[j] - w.vel_x[i]) - push * dx;
+            ay[i] += drag * (w.vel_y[j] - w.vel_y[i]) - push * dy;
+        }
+    }
+}
+
+void test_fluid_kernels()
+{
+    std::cout << "\n--- TEST: SPH Fluid (grid neighbours vs all pairs) ---\n";
+
+    // 21x21 lattice of unit spacing and unit mass (rest density 1), squeezed
+    // a little and jittered so pressure and viscosity are non-zero
+    world w = make_fluid_world();
+    w.fluid_rest_density = 0.9f;
+    std::srand(3);
+    auto jitter = [] { return 0.1f * (float(std::rand()) / float(RAND_MAX) - 0.5f); };
+    for (int y = 0; y < 21; ++y)
+        for (int x = 0; x < 21; ++x)
+            w.add_body(create_body(x * 0.95f + jitter(), y * 0.95f + jitter(), jitter(), jitter(), 1, 0.1f));
+    for (size_t i = 0; i < w.size(); ++i)
+        w.set_fluid(i, true);
+
+    // The collision pass builds the grid (no contacts at this spacing)
+    collisionSystem collisions;
+    collisions.update(w, w.delta_time);
+    fluidSystem fluid;
+    fluid.update(w, w.delta_time);
+
+    std::vector<float> rho, ax, ay;
+    reference_fluid(w, rho, ax, ay);
+    float worst_density = 0.0f, worst_acceleration = 0.0f, largest = 0.0f;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        worst_density = std::max(worst_density, std::fabs(fluid.density_of(i) - rho[i]) / rho[i]);
+        worst_acceleration = std::max(worst_acceleration, std::max(std::fabs(w.acc_x[i] - ax[i]), std::fabs(w.acc_y[i] - ay[i])));
+        largest = std::max(largest, std::max(std::fabs(ax[i]), std::fabs(ay[i])));
+    }
+    size_t center = 10 * 21 + 10;
+    std::cout << "Fluid particles: " << fluid.num_particles() << " (Should be 441)\n";
+    std::cout << "Density at the lattice center: " << fluid.density_of(center) << " (Should be ~1.1, 1 / 0.95^2)\n";
+    std::cout << "Worst relative density difference to all pairs: " << worst_density << " (Should be ~0)\n";
+    std::cout << "Worst acceleration difference to all pairs: " << worst_acceleration << " of " << largest << " (Should be ~0)\n";
+
+    // Symmetric pressure and viscosity: internal forces cancel
+    float net_x = 0.0f, net_y = 0.0f;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        net_x += w.mass[i] * w.acc_x[i];
+        net_y += w.mass[i] * w.acc_y[i];
+    }
+    std::cout << "Net internal force: (" << net_x << ", " << net_y << ") (Should be ~0)\n";
+
+    // Same result on a pool
+    ThreadPool pool(4);
+    world pooled = w;
+    std::fill(pooled.acc_x.begin(), pooled.acc_x.end(), 0.0f);
+    std::fill(pooled.acc_y.begin(), pooled.acc_y.end(), 0.0f);
+    fluidSystem pooled_fluid(&pool);
+    pooled_fluid.update(pooled, pooled.delta_time);
+    float difference = 0.0f;
+    for (size_t i = 0; i < w.size(); ++i)
+        difference = std::max(difference, std::max(std::fabs(pooled.acc_x[i] - w.acc_x[i]), std::fabs(pooled.acc_y[i] - w.acc_y[i])));
+    std::cout << "Serial vs pooled acceleration difference: " << difference << " (Should be 0)\n";
+
+    // Stepped with the collision pass only (no forceFieldSystem, no
+    // integrator) nothing moves, so the accelerations must not build up
+    world still = w;
+    systemManager fluid_only;
+    fluid_only.addSystem(std::make_unique<collisionSystem>());
+    fluid_only.addSystem(std::make_unique<fluidSystem>());
+    for (int t = 0; t < 200; ++t)
+        fluid_only.update(still, still.delta_time);
+    float drift = 0.0f;
+    for (size_t i = 0; i < w.size(); ++i)
+        drift = std::max(drift, std::max(std::fabs(still.acc_x[i] - w.acc_x[i]), std::fabs(still.acc_y[i] - w.acc_y[i])));
+    std::cout << "Acceleration change after 200 steps without forceFieldSystem: " << drift << " (Should be ~0)\n";
+
+    // Bodies not flagged as fluid are ignored
+    w.set_fluid(center, false);
+    fluid.update(w, w.delta_time);
+    std::cout << "Particles / density of an unflagged body: " << fluid.num_particles() << " / " << fluid.density_of(center)
+              << " (Should be 440 / 0)\n";
+}
+
+void test_fluid_dam_break()
+{
+    std::cout << "\n--- TEST: SPH Fluid (dam break in a box) ---\n";
+
+    world w = make_fluid_world();
+    w.gravity_y = -9.8f;
+    w.grid_info.min_x = 0.0f;
+    w.grid_info.max_x = 60.0f;
+    w.grid_info.min_y = 0.0f;
+    w.grid_info.max_y = 40.0f;
+    w.resize_grid();
+    w.fluid_smoothing_radius = 2.5f;
+    w.fluid_rest_density = 1.0f;
+    w.fluid_stiffness = 40.0f;
+    w.fluid_viscosity = 1.0f;
+    // 15x30 column against the left wall
+    for (int y = 0; y < 30; ++y)
+        for (int x = 0; x < 15; ++x)
+            w.add_body(create_body(0.5f + x, 0.5f + y, 0, 0, 1, 0.4f, 0.0f));
+    for (size_t i = 0; i < w.size(); ++i)
+        w.set_fluid(i, true);
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<forceFieldSystem>());
+    manager.addSystem(std::make_unique<fluidSystem>());
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    for (int step = 0; step < 360; ++step)
+        manager.update(w, w.delta_time);
+
+    float front = 0.0f, top = 0.0f;
+    bool finite = true;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        front = std::max(front, w.position_x[i]);
+        top = std::max(top, w.position_y[i]);
+        finite &= std::isfinite(w.position_x[i]) && std::isfinite(w.position_y[i]);
+    }
+    std::cout << "All positions finite: " << (finite ? "yes" : "no") << " (Should be yes)\n";
+    std::cout << "Front / top after 6 s: " << front << " / " << top << " (Should be > 15 / < 30, the column collapsed)\n";
+}
+
+void test_fluid()
+{
+    test_fluid_kernels();
+    test_fluid_dam_break();
+}
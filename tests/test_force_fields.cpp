@@ -0,0 +1,134 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/forceFieldSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+// tests/test_force_fields.cpp
+
+static world make_field_world()
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.0f;
+    return w;
+}
+
+void test_force_fields_kinds()
+{
+    std::cout << "\n--- TEST: Force Fields (well, wind, impulse) ---\n";
+
+    world w = make_field_world();
+    w.add_body(create_body(14.0f, 50.0f, 0, 0, 1, 0.5f));  // 4 m right of the well
+    w.add_body(create_body(30.0f, 50.0f, 0, 0, 1, 0.5f));  // outside the well
+    w.add_body(create_body(-40.0f, 60.0f, 0, 0, 1, 0.5f)); // inside the wind zone
+    w.add_body(create_body(-40.0f, 20.0f, 0, 0, 1, 0.5f)); // below the wind zone
+    w.force_fields.add_gravity_well(vec2(10.0f, 50.0f), 8.0f, 20.0f);
+    w.force_fields.add_wind(vec2(-50.0f, 40.0f), vec2(-30.0f, 80.0f), vec2(3.0f, 0.0f));
+
+    forceFieldSystem fields;
+    fields.update(w, w.delta_time);
+    std::cout << "Well pull at half radius: (" << w.acc_x[0] << ", " << w.acc_y[0] << ") (Should be (-10, 0))\n";
+    std::cout << "Outside the well: (" << w.acc_x[1] << ", " << w.acc_y[1] << ") (Should be (0, 0))\n";
+    std::cout << "Wind inside / outside the zone: " << w.acc_x[2] << " / " << w.acc_x[3] << " (Should be 3 / 0)\n";
+
+    // Impulse: one step of delta_v / dt, then gone
+    world blast = make_field_world();
+    blast.add_body(create_body(0.0f, 52.0f, 0, 0, 1, 0.5f));
+    blast.add_body(create_body(0.0f, 50.0f, 0, 0, 0, 0.5f)); // static: untouched
+    blast.force_fields.add_radial_impulse(vec2(0.0f, 50.0f), 4.0f, 10.0f);
+    blast.previous_position_y[0] = blast.position_y[0];
+    systemManager manager;
+    manager.addSystem(std::make_unique<forceFieldSystem>());
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.update(blast, blast.delta_time);
+    float first_step = blast.position_y[0] - 52.0f;
+    manager.update(blast, blast.delta_time);
+    float second_step = blast.position_y[0] - 52.0f - first_step;
+    std::cout << "Fields left after the blast: " << blast.force_fields.size() << " (Should be 0)\n";
+    std::cout << "Displacement per step after the blast: " << first_step << ", " << second_step
+              << " (Should be ~0.0833 each, 5 m/s outward)\n";
+    std::cout << "Static body acceleration: " << blast.acc_y[1] << " (Should be 0)\n";
+    std::cout << "Acceleration cleared once the last field is gone: " << blast.acc_y[0] << " (Should be 0)\n";
+
+    // A body's own acceleration (add_body) is kept under the fields
+    world thrust = make_field_world();
+    body rocket = create_body(-40.0f, 60.0f, 0, 0, 1, 0.5f);
+    rocket.acceleration = vec2(0.0f, 2.0f);
+    thrust.add_body(rocket);
+    thrust.previous_position_y[0] = thrust.position_y[0];
+    thrust.force_fields.add_wind(vec2(-50.0f, 40.0f), vec2(-30.0f, 80.0f), vec2(3.0f, 0.0f));
+    systemManager thrust_manager;
+    thrust_manager.addSystem(std::make_unique<forceFieldSystem>());
+    thrust_manager.addSystem(std::make_unique<movementSystem>());
+    for (int t = 0; t < 60; ++t)
+        thrust_manager.update(thrust, thrust.delta_time);
+    std::cout << "Own acceleration + wind: (" << thrust.acc_x[0] << ", " << thrust.acc_y[0] << ") (Should be (3, 2))\n";
+    std::cout << "Velocity after 1 s: (" << thrust.vel_x[0] << ", " << thrust.vel_y[0] << ") (Should be ~(3, 2))\n";
+    thrust.force_fields.clear();
+    thrust_manager.update(thrust, thrust.delta_time);
+    thrust_manager.update(thrust, thrust.delta_time);
+    std::cout << "Once the wind is gone: (" << thrust.acc_x[0] << ", " << thrust.acc_y[0] << ") (Should be (0, 2))\n";
+}
+
+void test_force_fields_culling()
+{
+    std::cout << "\n--- TEST: Force Fields (grid culling vs all fields) ---\n";
+
+    world w = make_field_world();
+    std::srand(7);
+    auto random_in = [](float lo, float hi) { return lo + (hi - lo) * float(std::rand()) / float(RAND_MAX); };
+    for (int i = 0; i < 4000; ++i)
+        w.add_body(create_body(random_in(-110.0f, 110.0f), random_in(-110.0f, 110.0f), 0, 0, 1, 0.3f));
+    for (int f = 0; f < 150; ++f)
+        w.force_fields.add_gravity_well(vec2(random_in(-120.0f, 120.0f), random_in(-120.0f, 120.0f)), random_in(2.0f, 15.0f), random_in(-20.0f, 20.0f));
+    for (int f = 0; f < 20; ++f)
+    {
+        vec2 corner(random_in(-120.0f, 100.0f), random_in(-120.0f, 100.0f));
+        w.force_fields.add_wind(corner, vec2(corner.x + random_in(1.0f, 30.0f), corner.y + random_in(1.0f, 30.0f)), vec2(random_in(-5.0f, 5.0f), random_in(-5.0f, 5.0f)));
+    }
+
+    forceFieldSystem fields;
+    fields.update(w, w.delta_time);
+
+    float worst = 0.0f;
+    int affected = 0;
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        vec2 expected(0.0f, 0.0f);
+        for (size_t f = 0; f < w.force_fields.size(); ++f)
+        {
+            vec2 a = w.force_fields.field_acceleration(int(f), w.position_x[i], w.position_y[i], w.delta_time);
+            expected.x += a.x;
+            expected.y += a.y;
+        }
+        affected += (expected.x != 0.0f || expected.y != 0.0f) ? 1 : 0;
+        worst = std::max(worst, std::max(std::fabs(expected.x - w.acc_x[i]), std::fabs(expected.y - w.acc_y[i])));
+    }
+    std::cout << "Bodies inside some field: " << affected << " (Should be > 0)\n";
+    std::cout << "Worst difference to evaluating every field: " << worst << " (Should be ~0)\n";
+
+    // Moving a well re-bins it
+    w.force_fields.clear();
+    int well = w.force_fields.add_gravity_well(vec2(-80.0f, -80.0f), 5.0f, 10.0f);
+    w.add_body(create_body(60.0f, 60.0f, 0, 0, 1, 0.3f));
+    size_t probe = w.size() - 1;
+    fields.update(w, w.delta_time);
+    float before = w.acc_x[probe];
+    w.force_fields.set_center(well, vec2(62.0f, 60.0f));
+    fields.update(w, w.delta_time);
+    std::cout << "Probe acceleration before / after moving the well onto it: " << before << " / " << w.acc_x[probe]
+              << " (Should be 0 / 6)\n";
+}
+
+void test_force_fields()
+{
+    test_force_fields_kinds();
+    test_force_fields_culling();
+}
@@ -0,0 +1,129 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/mutualGravitySystem.hpp"
+#include "sim/systemManager.hpp"
+#include "physics/spatialQuery.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <iostream>
+
+// tests/test_frame_arena.cpp
+
+// Every operator new of the test binary is counted, so the steady-state tests
+// see real heap allocations and not only the frame arena's blocks
+static std::atomic<uint64_t> heap_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++heap_allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void test_frame_arena_reuse()
+{
+    std::cout << "\n--- TEST: Frame Arena (no allocations in steady state) ---\n";
+
+    FrameArena arena(64);
+    int *a = arena.allocate<int>(8);
+    double *b = arena.allocate<double>(64); // forces an overflow block
+    a[0] = 1;
+    b[63] = 2.0;
+    uint64_t after_growth = arena.allocation_count();
+    arena.reset(); // coalesces into one block
+    arena.allocate<int>(8);
+    arena.allocate<double>(64);
+    arena.reset();
+    std::cout << "Arena blocks: growth=" << after_growth << " after reuse=" << arena.allocation_count()
+              << " (Should be " << after_growth + 1 << ")\n";
+}
+
+void test_frame_arena_simulation_steady_state()
+{
+    std::cout << "\n--- TEST: Frame Arena (simulation steady state) ---\n";
+
+    // A small pile of bodies resting on the ground
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    for (int i = 0; i < 200; ++i)
+        w.add_body(create_body(-20.0f + (i % 20) * 2.1f, 1.0f + (i / 20) * 2.1f, 0, 0, 1, 1.0f, 0.5f));
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+
+    for (int t = 0; t < 60; ++t)
+        manager.update(w, w.delta_time);
+
+    uint64_t before = w.frame_arena.allocation_count();
+    uint64_t heap_before = heap_allocations;
+    for (int t = 0; t < 120; ++t)
+        manager.update(w, w.delta_time);
+    uint64_t heap_after = heap_allocations;
+    uint64_t after = w.frame_arena.allocation_count();
+
+    std::cout << "Arena heap allocations during 120 steady-state steps: " << (after - before) << " (Should be 0)\n";
+    std::cout << "operator new calls during those steps: " << (heap_after - heap_before) << " (Should be 0)\n";
+
+    // Stepping collisionSystem directly, without a manager, reuses the arena too
+    collisionSystem collisions;
+    collisions.update(w, w.delta_time);
+    size_t reserved = w.frame_arena.bytes_reserved();
+    for (int t = 0; t < 120; ++t)
+        collisions.update(w, w.delta_time);
+    std::cout << "Arena bytes reserved after 120 direct collision updates: " << w.frame_arena.bytes_reserved() << " (Should be " << reserved
+              << ")\n";
+}
+
+void test_frame_arena_gravity_and_queries()
+{
+    std::cout << "\n--- TEST: Frame Arena (mutual gravity and k-nearest, no heap) ---\n";
+
+    // The same pile with a weak mutual pull, so the Barnes-Hut tree is rebuilt every step
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    w.mutual_gravity = true;
+    w.gravitational_constant = 0.01f;
+    for (int i = 0; i < 200; ++i)
+        w.add_body(create_body(-20.0f + (i % 20) * 2.1f, 1.0f + (i / 20) * 2.1f, 0, 0, 1, 1.0f, 0.5f));
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<mutualGravitySystem>());
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    for (int t = 0; t < 60; ++t)
+        manager.update(w, w.delta_time);
+
+    uint64_t heap_before = heap_allocations;
+    for (int t = 0; t < 120; ++t)
+        manager.update(w, w.delta_time);
+    std::cout << "operator new calls during 120 steps with mutual gravity: " << (heap_allocations - heap_before) << " (Should be 0)\n";
+
+    // k-nearest into a reserved output
+    spatialQuery query(w);
+    std::vector<int> nearest;
+    nearest.reserve(8 * 500);
+    heap_before = heap_allocations;
+    for (int q = 0; q < 500; ++q)
+        query.query_k_nearest(vec2(-20.0f + 0.08f * q, 5.0f), 8, nearest);
+    std::cout << "operator new calls during 500 k-nearest queries: " << (heap_allocations - heap_before) << ", hits " << nearest.size()
+              << " (Should be 0, 4000)\n";
+}
+
+void test_frame_arena()
+{
+    test_frame_arena_reuse();
+    test_frame_arena_simulation_steady_state();
+    test_frame_arena_gravity_and_queries();
+}
@@ -1,10 +1,16 @@
 #include "utilities/test_helpers.hpp"
 #include "sim/movementSystem.hpp"
+#include "sim/constraintSystem.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/xpbdSystem.hpp"
 #include "sim/systemManager.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 
+// tests/test_integrator_stability.cpp
+
 // This test checks a basic fall simulation using the default Verlet integrator.
 void test_verlet_movement_simple()
 {
@@ -38,16 +44,243 @@ void test_verlet_movement_simple()
     std::cout << "Body final position Y after 5 steps: " << w.position_y[0] << " (Should be < 5)\n";
 }
 
-// Since main_test.cpp no longer calls a wrapper, this function is the replacement.
-void test_integrator_stability_wrapper(int type, const char *name)
+// Full pipeline: the world's integrator mode decides which systems act.
+static void add_all_systems(systemManager &manager)
+{
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<constraintSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    manager.addSystem(std::make_unique<xpbdSystem>());
+}
+
+static const char *integrator_name(IntegratorMode mode)
 {
-    // The original wrapper now calls the simplified test for movement stability.
-    // The arguments 'type' and 'name' are ignored, but we keep the signature
-    // to avoid changing main_test.cpp if we only simplify.
-    // However, since we agreed to remove the stability tests from main_test.cpp,
-    // this wrapper is generally deleted. For completeness, I'll delete the file
-    // and rely on a simpler test in another file, or rename this one.
+    switch (mode)
+    {
+    case IntegratorMode::XPBD:
+        return "XPBD";
+    case IntegratorMode::ExplicitEuler:
+        return "Explicit Euler";
+    case IntegratorMode::SemiImplicitEuler:
+        return "Semi-implicit Euler";
+    default:
+        return "Verlet";
+    }
+}
+
+void test_integrator_free_fall_and_bounce()
+{
+    std::cout << "\n--- TEST: Integrators (free fall and elastic bounce) ---\n";
+
+    float fall_errors[2] = {0.0f, 0.0f};
+    for (IntegratorMode mode : {IntegratorMode::Verlet, IntegratorMode::XPBD})
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = -9.8f;
+        w.delta_time = 1.0f / 60.0f;
+        w.global_damping = 0.0f;
+        w.integrator = mode;
+        w.add_body(create_body(0.0f, 50.0f, 0, 0, 1, 0.5f, 1.0f));
+        systemManager manager;
+        add_all_systems(manager);
+
+        // 1 s of free fall: y = 50 - g / 2
+        for (int t = 0; t < 60; ++t)
+            manager.update(w, w.delta_time);
+        float &fall_error = fall_errors[mode == IntegratorMode::XPBD ? 1 : 0];
+        fall_error = std::fabs(w.position_y[0] - (50.0f - 0.5f * 9.8f));
+
+        // Elastic ball: peak height of the last bounce after ~20 s
+        float peak = 0.0f;
+        for (int t = 60; t < 1200; ++t)
+        {
+            manager.update(w, w.delta_time);
+            if (t >= 1000)
+                peak = std::max(peak, w.position_y[0]);
+        }
+        std::cout << integrator_name(mode) << ": free-fall error after 1 s: " << fall_error
+                  << ", late bounce peak: " << peak << "\n";
+    }
+    std::cout << "XPBD free-fall error: " << fall_errors[1] << " (Should be < 0.1, below Verlet's " << fall_errors[0] << ")\n";
+}
+
+void test_integrator_stack()
+{
+    std::cout << "\n--- TEST: Integrators (resting stack of 10 circles) ---\n";
+
+    bool xpbd_holds = false;
+    for (IntegratorMode mode : {IntegratorMode::Verlet, IntegratorMode::XPBD})
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = -9.8f;
+        w.delta_time = 1.0f / 60.0f;
+        w.integrator = mode;
+        for (int i = 0; i < 10; ++i)
+            w.add_body(create_body(0.0f, 0.5f + float(i), 0, 0, 1, 0.5f, 0.0f));
+        systemManager manager;
+        add_all_systems(manager);
+
+        float worst_overlap = 0.0f;
+        for (int t = 0; t < 300; ++t)
+        {
+            manager.update(w, w.delta_time);
+            if (t < 200)
+                continue;
+            for (int i = 0; i + 1 < 10; ++i)
+                worst_overlap = std::max(worst_overlap, 1.0f - (w.position_y[i + 1] - w.position_y[i]));
+        }
+        float speed = 0.0f;
+        for (size_t i = 0; i < w.size(); ++i)
+            speed = std::max(speed, std::fabs(w.vel_y[i]));
+        std::cout << integrator_name(mode) << ": top of the stack: " << w.position_y[9]
+                  << ", worst overlap once settled: " << worst_overlap
+                  << ", max |vel_y|: " << speed << "\n";
+        if (mode == IntegratorMode::XPBD)
+            xpbd_holds = std::fabs(w.position_y[9] - 9.5f) < 0.05f && worst_overlap < 0.01f && speed < 0.01f;
+    }
+    std::cout << "XPBD stack at rest at its ideal height (9.5): " << xpbd_holds << " (Should be 1)\n";
+}
+
+void test_integrator_rope()
+{
+    std::cout << "\n--- TEST: Integrators (pinned rope at equal solver cost) ---\n";
+
+    // Verlet gets 4 relaxation passes per frame, XPBD 4 substeps of one pass
+    float stretch[2] = {0.0f, 0.0f};
+    for (IntegratorMode mode : {IntegratorMode::Verlet, IntegratorMode::XPBD})
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = -9.8f;
+        w.delta_time = 1.0f / 60.0f;
+        w.integrator = mode;
+        w.xpbd_substeps = 4;
+        w.constraints.iterations = 4;
+        for (int i = 0; i <= 20; ++i)
+            w.add_body(create_body(float(i) - 10.0f, 80.0f, 0, 0, 1, 0.2f, 0.0f));
+        for (int i = 0; i < 20; ++i)
+            w.constraints.add_distance(i, i + 1, 1.0f);
+        w.constraints.add_pin(0, vec2(-10.0f, 80.0f));
+        systemManager manager;
+        add_all_systems(manager);
+
+        float &max_stretch = stretch[mode == IntegratorMode::XPBD ? 1 : 0];
+        for (int t = 0; t < 300; ++t)
+        {
+            manager.update(w, w.delta_time);
+            float length = 0.0f;
+            for (int i = 0; i < 20; ++i)
+            {
+                float dx = w.position_x[i + 1] - w.position_x[i];
+                float dy = w.position_y[i + 1] - w.position_y[i];
+                length += std::sqrt(dx * dx + dy * dy);
+            }
+            max_stretch = std::max(max_stretch, length / 20.0f - 1.0f);
+        }
+        std::cout << integrator_name(mode) << ": pinned body: (" << w.position_x[0] << ", " << w.position_y[0]
+                  << ") (Should be (-10, 80)), max mean link stretch: " << max_stretch << "\n";
+    }
+    std::cout << "XPBD stretch below Verlet stretch: " << (stretch[1] < stretch[0]) << " (Should be 1)\n";
+}
 
-    // Let's assume you rename this file to test_movement.cpp and call the function directly.
+void test_integrator_xpbd_compliance()
+{
+    std::cout << "\n--- TEST: XPBD (compliant spring under load) ---\n";
+
+    // A 2 kg body hanging from a pin on a spring of compliance 0.01 m/N
+    // settles at m * g * compliance below its rest length. Kept near the
+    // origin: a substep of gravity (g h^2) is only a few float ulps at y ~ 60.
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 4.0f;
+    w.integrator = IntegratorMode::XPBD;
+    w.add_body(create_body(0.0f, 6.0f, 0, 0, 1, 0.2f, 0.0f));
+    w.add_body(create_body(0.0f, 4.0f, 0, 0, 2, 0.2f, 0.0f));
+    w.constraints.add_spring(0, 1, 2.0f, 1.0f, 0.01f);
+    w.constraints.add_pin(0, vec2(0.0f, 6.0f));
+    systemManager manager;
+    add_all_systems(manager);
+    for (int t = 0; t < 600; ++t)
+        manager.update(w, w.delta_time);
+
+    float extension = (w.position_y[0] - w.position_y[1]) - 2.0f;
+    std::cout << "Static extension: " << extension << " (Should be ~0.196)\n";
+
+    // Contact compliance lets a resting body sink into a static one
+    world soft;
+    soft.gravity_x = 0.0f;
+    soft.gravity_y = -9.8f;
+    soft.delta_time = 1.0f / 60.0f;
+    soft.integrator = IntegratorMode::XPBD;
+    soft.contact_compliance = 0.001f;
+    soft.add_body(create_body(0.0f, 20.0f, 0, 0, 0, 1.0f, 0.0f));
+    soft.add_body(create_body(0.0f, 21.9f, 0, 0, 1, 1.0f, 0.0f));
+    systemManager soft_manager;
+    add_all_systems(soft_manager);
+    for (int t = 0; t < 600; ++t)
+        soft_manager.update(soft, soft.delta_time);
+    std::cout << "Soft contact penetration: " << 2.0f - (soft.position_y[1] - soft.position_y[0]) << " (Should be ~0.0098)\n";
+}
+
+void test_integrator_schemes()
+{
+    std::cout << "\n--- TEST: Integrators (explicit / semi-implicit Euler vs Verlet kernels) ---\n";
+
+    // Elastic ball bouncing for 20 s without damping: the late peak shows
+    // whether the scheme gains or loses energy.
+    float peaks[3] = {0.0f, 0.0f, 0.0f};
+    const IntegratorMode modes[3] = {IntegratorMode::Verlet, IntegratorMode::SemiImplicitEuler, IntegratorMode::ExplicitEuler};
+    for (int m = 0; m < 3; ++m)
+    {
+        world w;
+        w.gravity_x = 0.0f;
+        w.gravity_y = -9.8f;
+        w.delta_time = 1.0f / 60.0f;
+        w.global_damping = 0.0f;
+        w.integrator = modes[m];
+        w.add_body(create_body(0.0f, 50.0f, 0, 0, 1, 0.5f, 1.0f));
+        systemManager manager;
+        add_all_systems(manager);
+        for (int t = 0; t < 1200; ++t)
+        {
+            manager.update(w, w.delta_time);
+            if (t >= 1000)
+                peaks[m] = std::max(peaks[m], w.position_y[0]);
+        }
+        std::cout << integrator_name(modes[m]) << ": late bounce peak: " << peaks[m] << "\n";
+    }
+    std::cout << "Explicit Euler gains energy, semi-implicit does not: " << (peaks[2] > 50.0f && peaks[1] < peaks[2])
+              << " (Should be 1)\n";
+
+    // Non-gravity kernels: per-body acceleration column, then drag features
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.0f;
+    w.integrator = IntegratorMode::SemiImplicitEuler;
+    w.add_body(create_body(0.0f, 50.0f, 0, 0, 1, 0.5f));
+    w.add_body(create_body(0.0f, 20.0f, 10.0f, 0, 1, 0.5f));
+    w.acc_x[0] = 2.0f;
+    w.friction[1] = 1.0f;
+    systemManager manager;
+    add_all_systems(manager);
+    for (int t = 0; t < 60; ++t)
+        manager.update(w, w.delta_time);
+    std::cout << "Body under acc_x = 2 for 1 s: x = " << w.position_x[0] << " (Should be ~1)\n";
+    std::cout << "Body with friction 1 after 1 s: vel_x = " << w.vel_x[1] << " (Should be ~3.7, 10 / e)\n";
+}
+
+void test_integrator_stability()
+{
     test_verlet_movement_simple();
-}
\ No newline at end of file
+    test_integrator_free_fall_and_bounce();
+    test_integrator_stack();
+    test_integrator_rope();
+    test_integrator_xpbd_compliance();
+    test_integrator_schemes();
+}
@@ -0,0 +1,151 @@
+#include "utilities/test_helpers.hpp"
+#include "physics/barnesHutTree.hpp"
+#include "sim/forceFieldSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/mutualGravitySystem.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+// tests/test_mutual_gravity.cpp
+
+static world make_cluster(int count, unsigned seed)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.0f;
+    w.mutual_gravity = true;
+    std::srand(seed);
+    for (int i = 0; i < count; ++i)
+    {
+        // Uniform disc of radius 80 with a dense core
+        float angle = 6.2831853f * float(std::rand()) / float(RAND_MAX);
+        float r = 80.0f * std::pow(float(std::rand()) / float(RAND_MAX), i % 3 == 0 ? 2.0f : 0.5f);
+        float m = 0.5f + float(std::rand()) / float(RAND_MAX);
+        w.add_body(create_body(r * std::cos(angle), r * std::sin(angle), 0, 0, m, 0.1f));
+    }
+    return w;
+}
+
+void test_mutual_gravity_accuracy()
+{
+    std::cout << "\n--- TEST: Barnes-Hut Accuracy vs Direct Sum ---\n";
+
+    world w = make_cluster(3000, 5);
+    BarnesHutTree tree;
+    tree.build(w);
+
+    auto relative_errors = [&](float theta)
+    {
+        std::vector<float> errors;
+        for (size_t s = 0; s < w.size(); s += 7)
+        {
+            vec2 approx = tree.acceleration_at_slot(int(s), theta, w.gravity_softening);
+            vec2 exact = tree.direct_acceleration_at_slot(int(s), w.gravity_softening);
+            float ex = approx.x - exact.x, ey = approx.y - exact.y;
+            errors.push_back(std::sqrt(ex * ex + ey * ey) / std::max(std::sqrt(exact.x * exact.x + exact.y * exact.y), 1e-6f));
+        }
+        std::sort(errors.begin(), errors.end());
+        return errors;
+    };
+    std::vector<float> exact = relative_errors(0.0f);
+    std::vector<float> half = relative_errors(0.5f);
+    std::vector<float> wide = relative_errors(1.0f);
+    std::cout << "Nodes for " << w.size() << " bodies: " << tree.num_nodes() << " (Should be > 0)\n";
+    std::cout << "Worst relative error with theta 0: " << exact.back() << " (Should be ~0)\n";
+    std::cout << "Median / worst relative error with theta 0.5: " << half[half.size() / 2] << " / " << half.back() << " (Should be < 0.02 / < 0.2)\n";
+    std::cout << "Median relative error with theta 1: " << wide[wide.size() / 2] << " (Should be < 0.1)\n";
+
+    // Group walks never accept a cell the per-body walk would open
+    std::vector<float> group_x(w.size()), group_y(w.size());
+    BarnesHutTree::InteractionList list;
+    for (size_t g = 0; g < tree.groups.size(); ++g)
+        tree.group_accelerations(int(g), 0.5f, w.gravity_softening, list, group_x.data(), group_y.data());
+    float group_worst = 0.0f;
+    for (size_t s = 0; s < w.size(); s += 7)
+    {
+        vec2 exact = tree.direct_acceleration_at_slot(int(s), w.gravity_softening);
+        float ex = group_x[s] - exact.x, ey = group_y[s] - exact.y;
+        group_worst = std::max(group_worst, std::sqrt(ex * ex + ey * ey) / std::max(std::sqrt(exact.x * exact.x + exact.y * exact.y), 1e-6f));
+    }
+    std::cout << "Worst relative error of the group walk with theta 0.5: " << group_worst << " (Should be <= " << half.back() << ")\n";
+
+    // Root holds the whole mass
+    float total = 0.0f;
+    for (size_t i = 0; i < w.size(); ++i)
+        total += w.mass[i];
+    std::cout << "Root mass / total mass: " << tree.mass[0] << " / " << total << " (Should be equal)\n";
+}
+
+void test_mutual_gravity_system()
+{
+    std::cout << "\n--- TEST: Mutual Gravity System ---\n";
+
+    // Two equal bodies 10 m apart fall towards each other; momentum stays zero
+    world pair;
+    pair.gravity_x = 0.0f;
+    pair.gravity_y = 0.0f;
+    pair.delta_time = 1.0f / 60.0f;
+    pair.global_damping = 0.0f;
+    pair.mutual_gravity = true;
+    pair.gravitational_constant = 50.0f;
+    pair.add_body(create_body(-5.0f, 50.0f, 0, 0, 2, 0.5f));
+    pair.add_body(create_body(5.0f, 50.0f, 0, 0, 2, 0.5f));
+    systemManager manager;
+    manager.addSystem(std::make_unique<forceFieldSystem>());
+    manager.addSystem(std::make_unique<mutualGravitySystem>());
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.update(pair, pair.delta_time);
+    std::cout << "Initial pull on the left body: " << pair.acc_x[0] << " (Should be ~1, G m / d^2)\n";
+    for (int t = 0; t < 60; ++t)
+        manager.update(pair, pair.delta_time);
+    std::cout << "Gap after one second: " << pair.position_x[1] - pair.position_x[0] << " (Should be < 10)\n";
+    std::cout << "Net momentum: " << pair.mass[0] * pair.vel_x[0] + pair.mass[1] * pair.vel_x[1] << " (Should be ~0)\n";
+    std::cout << "Acceleration not accumulated across steps: " << pair.acc_x[0] << " (Should be ~1.2)\n";
+
+    // Stepped alone (no forceFieldSystem, no integrator) the bodies don't move,
+    // so the pull must stay the same step after step
+    world still = pair;
+    systemManager gravity_only;
+    gravity_only.addSystem(std::make_unique<mutualGravitySystem>());
+    gravity_only.update(still, still.delta_time);
+    const float first_pull = still.acc_x[0];
+    for (int t = 0; t < 200; ++t)
+        gravity_only.update(still, still.delta_time);
+    std::cout << "Pull after 1 / 201 steps without forceFieldSystem: " << first_pull << " / " << still.acc_x[0] << " (Should be equal)\n";
+
+    // Parallel build and force pass give the serial result
+    world serial = make_cluster(20000, 9);
+    world parallel = serial;
+    ThreadPool pool(4);
+    mutualGravitySystem serial_gravity;
+    mutualGravitySystem parallel_gravity(&pool);
+    serial_gravity.update(serial, serial.delta_time);
+    parallel_gravity.update(parallel, parallel.delta_time);
+    float worst = 0.0f;
+    for (size_t i = 0; i < serial.size(); ++i)
+        worst = std::max(worst, std::fabs(serial.acc_x[i] - parallel.acc_x[i]) + std::fabs(serial.acc_y[i] - parallel.acc_y[i]));
+    std::cout << "Serial vs pooled acceleration difference: " << worst << " (Should be 0)\n";
+
+    // 100k bodies, for information
+    world large = make_cluster(100000, 13);
+    mutualGravitySystem large_gravity(&pool);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    large_gravity.update(large, large.delta_time);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "100k bodies, theta 0.5: " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms, " << large_gravity.last_tree().num_nodes() << " nodes\n";
+}
+
+void test_mutual_gravity()
+{
+    test_mutual_gravity_accuracy();
+    test_mutual_gravity_system();
+}
@@ -0,0 +1,127 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/physicsRunner.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/tripleBuffer.hpp"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// tests/test_physics_runner.cpp
+
+struct CounterPair
+{
+    uint64_t value = 0;
+    uint64_t check = 0; // Always ~value when the slot is consistent
+};
+
+void test_triple_buffer()
+{
+    std::cout << "\n--- TEST: Triple Buffer ---\n";
+
+    const uint64_t writes = 200000;
+    TripleBuffer<CounterPair> buffer;
+    buffer.back() = CounterPair{0, ~uint64_t(0)};
+    buffer.publish();
+    std::thread writer([&]
+    {
+        for (uint64_t v = 1; v <= writes; ++v)
+        {
+            CounterPair &slot = buffer.back();
+            slot.value = v;
+            slot.check = ~v;
+            buffer.publish();
+        }
+    });
+
+    bool consistent = true, monotonic = true;
+    uint64_t last = 0, updates = 0;
+    while (last < writes)
+    {
+        if (!buffer.update())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ++updates;
+        const CounterPair &seen = buffer.front();
+        consistent &= seen.check == ~seen.value;
+        monotonic &= seen.value >= last;
+        last = seen.value;
+    }
+    writer.join();
+    std::cout << "Reader saw torn values: " << (consistent ? "no" : "yes") << " (Should be no)\n";
+    std::cout << "Values never went backwards: " << (monotonic ? "yes" : "no") << " (Should be yes)\n";
+    std::cout << "Last value read: " << last << " (Should be " << writes << ")\n";
+    std::cout << "Updates taken: " << updates << " (Should be > 0, intermediate values are skipped)\n";
+}
+
+void test_physics_runner_thread()
+{
+    std::cout << "\n--- TEST: Physics Runner ---\n";
+
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 120.0f;
+    w.add_body(create_body(0.0f, 100.0f, 0.0f, 0.0f, 1, 0.5f));
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+
+    const float fixed_dt = 1.0f / 120.0f;
+    physicsRunner runner(w, manager, fixed_dt);
+    const RenderSnapshot &initial = runner.latest_snapshot();
+    std::cout << "Initial snapshot bodies / height: " << initial.size() << " / " << initial.position_y[0] << " (Should be 1 / 100)\n";
+
+    runner.start();
+    runner.post([](world &sim) { sim.add_body(create_body(5.0f, 50.0f, 0.0f, 0.0f, 1, 0.5f)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    const RenderSnapshot &running = runner.latest_snapshot();
+    std::cout << "Steps taken: " << runner.steps_taken() << " (Should be > 0)\n";
+    std::cout << "Bodies in the snapshot: " << running.size() << " (Should be 2, the posted body was added)\n";
+    std::cout << "Body 0 fell: " << (running.position_y[0] < 100.0f ? "yes" : "no") << " (Should be yes)\n";
+
+    // Interpolation goes from the previous step to the latest one
+    vec2 start = running.interpolated_position(0, 0.0f);
+    vec2 end = running.interpolated_position(0, 1.0f);
+    std::cout << "Interpolated at 0 / 1: " << start.y << " / " << end.y << " (Should be previous_y / position_y: " << running.previous_y[0] << " / "
+              << running.position_y[0] << ")\n";
+
+    // Paused: no steps are taken until one is requested
+    runner.set_paused(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    uint64_t paused_at = runner.steps_taken();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::cout << "Steps while paused: " << runner.steps_taken() - paused_at << " (Should be 0)\n";
+    runner.request_step();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::cout << "Steps after a single-step request: " << runner.steps_taken() - paused_at << " (Should be 1)\n";
+
+    // A step that removes a body and spawns another keeps the count but swaps
+    // indices: the snapshot must not interpolate from the old body 0
+    runner.post([&](world &)
+    {
+        manager.commands().push(WorldCommand::remove(0));
+        manager.commands().push(WorldCommand::spawn(vec2(-20.0f, 80.0f), vec2(0.0f, 0.0f), 1.0f, 0.5f));
+        runner.request_step();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const RenderSnapshot &swapped = runner.latest_snapshot();
+    bool starts_at_current = swapped.size() == 2;
+    for (size_t i = 0; starts_at_current && i < swapped.size(); ++i)
+        starts_at_current = swapped.previous_x[i] == swapped.position_x[i] && swapped.previous_y[i] == swapped.position_y[i];
+    std::cout << "After a removal, snapshot previous = position: " << (starts_at_current ? "yes" : "no") << " (Should be yes)\n";
+
+    // Edits posted just before stop() are still applied
+    runner.post([](world &sim) { sim.position_x[0] = 42.0f; });
+    runner.stop();
+    std::cout << "Edit posted before stop: x = " << w.position_x[0] << " (Should be 42)\n";
+}
+
+void test_physics_runner()
+{
+    test_triple_buffer();
+    test_physics_runner_thread();
+}
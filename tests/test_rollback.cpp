@@ -0,0 +1,123 @@
+#include "utilities/test_helpers.hpp"
+#include "physics/rollbackBuffer.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// tests/test_rollback.cpp
+
+// Rows of bodies piled on the floor; the first `resting` rows are static
+static world make_pile(int columns, int rows, int resting)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 1.0f / 60.0f;
+    w.grid_info.min_x = -100.0f;
+    w.grid_info.max_x = 100.0f;
+    w.grid_info.min_y = 0.0f;
+    w.grid_info.max_y = 200.0f;
+    w.resize_grid();
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < columns; ++c)
+        {
+            float x = -95.0f + float(c) * 1.3f + (r % 2) * 0.3f;
+            float y = 0.6f + float(r) * 1.3f;
+            w.add_body(create_body(x, y, 0.0f, 0.0f, r < resting ? 0.0f : 1.0f, 0.5f, 0.5f));
+        }
+    return w;
+}
+
+static float state_difference(const world &a, const world &b)
+{
+    float worst = 0.0f;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        worst = std::max(worst, std::fabs(a.position_x[i] - b.position_x[i]) + std::fabs(a.position_y[i] - b.position_y[i]));
+        worst = std::max(worst, std::fabs(a.vel_x[i] - b.vel_x[i]) + std::fabs(a.vel_y[i] - b.vel_y[i]));
+    }
+    return worst;
+}
+
+void test_rollback()
+{
+    std::cout << "\n--- TEST: Rollback Buffer ---\n";
+
+    // 20k bodies: 140 columns x 143 rows, the lower 100 rows static
+    world w = make_pile(140, 143, 100);
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    for (int step = 0; step < 5; ++step)
+        manager.update(w, w.delta_time);
+
+    RollbackBuffer rollback(16);
+    RollbackBuffer tracked(16, true);
+    rollback.save(w, 0);
+    tracked.save(w, 0);
+    for (uint64_t frame = 1; frame <= 8; ++frame)
+    {
+        manager.update(w, w.delta_time);
+        rollback.save(w, frame);
+        tracked.save(w, frame);
+    }
+    world first_run = w;
+
+    // Restore frame 0 and resimulate the same 8 frames: same result
+    auto t0 = std::chrono::high_resolution_clock::now();
+    bool restored = rollback.restore(w, 0);
+    for (uint64_t frame = 1; frame <= 8; ++frame)
+    {
+        manager.update(w, w.delta_time);
+        rollback.save(w, frame);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "Bodies: " << w.size() << " (Should be 20020)\n";
+    std::cout << "Restored frame 0: " << (restored ? "yes" : "no") << " (Should be yes)\n";
+    std::cout << "Resimulated vs first run: " << state_difference(w, first_run) << " (Should be 0)\n";
+
+    // The buffer's own cost is the copy in and out (best of 5, the machine is
+    // shared); the resimulated frames cost what 8 steps cost, not the buffer
+    double save_ms = 1e9, restore_ms = 1e9;
+    for (int repeat = 0; repeat < 5; ++repeat)
+    {
+        auto t2 = std::chrono::high_resolution_clock::now();
+        rollback.save(first_run, 8);
+        auto t3 = std::chrono::high_resolution_clock::now();
+        rollback.restore(w, 0);
+        auto t4 = std::chrono::high_resolution_clock::now();
+        save_ms = std::min(save_ms, std::chrono::duration<double, std::milli>(t3 - t2).count());
+        restore_ms = std::min(restore_ms, std::chrono::duration<double, std::milli>(t4 - t3).count());
+    }
+    double resimulate_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    std::cout << "Save / restore at 20k bodies: " << save_ms << " / " << restore_ms << " ms (Should be < 1 / < 1)\n";
+    std::cout << "Restore + 8 resimulated frames: " << resimulate_ms << " ms (for information, 8 steps' cost)\n";
+
+    // Dirty tracking: static rows never change, only the moving blocks are copied
+    world dirty = first_run;
+    world full = first_run;
+    tracked.restore_dirty(dirty, 3);
+    size_t dirty_blocks = tracked.last_restored_blocks;
+    tracked.restore(full, 3);
+    std::cout << "Blocks copied, dirty / full restore: " << dirty_blocks << " / " << tracked.last_restored_blocks << " (Should be first < second)\n";
+    std::cout << "Dirty vs full restore: " << state_difference(dirty, full) << " (Should be 0)\n";
+
+    // The ring only holds the last 16 frames, and only for the same bodies
+    for (uint64_t frame = 9; frame <= 30; ++frame)
+        rollback.save(w, frame);
+    std::cout << "Frames held / oldest: " << rollback.frames_held() << " / " << rollback.oldest_frame() << " (Should be 16 / 15)\n";
+    std::cout << "Restore a dropped frame: " << (rollback.restore(w, 3) ? "yes" : "no") << " (Should be no)\n";
+    w.add_body(create_body(0.0f, 150.0f, 0.0f, 0.0f, 1.0f, 0.5f));
+    std::cout << "Restore after adding a body: " << (rollback.restore(w, 20) ? "yes" : "no") << " (Should be no)\n";
+
+    // Saving an older frame again replaces the history after it
+    rollback.save(w, 25);
+    std::cout << "Newest frame after re-saving 25: " << rollback.newest_frame() << " (Should be 25)\n";
+    std::cout << "Frame 26 still held: " << (rollback.holds(26) ? "yes" : "no") << " (Should be no)\n";
+}
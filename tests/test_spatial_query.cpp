@@ -0,0 +1,176 @@
+#include "utilities/test_helpers.hpp"
+#include "physics/spatialQuery.hpp"
+#include "sim/collisionSystem.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// tests/test_spatial_query.cpp
+// Every query is compared against a brute-force scan over all bodies.
+
+static world make_query_world()
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 0.016f;
+    // Deterministic scatter of small bodies over the upper half of the grid
+    unsigned seed = 12345u;
+    auto next = [&seed]()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return float(seed >> 8) / float(1u << 24);
+    };
+    for (int i = 0; i < 500; ++i)
+        w.add_body(create_body(-95.0f + 190.0f * next(), 2.0f + 95.0f * next(), 0, 0, 1, 0.3f + 1.5f * next()));
+
+    // Build the grid the queries read
+    collisionSystem cs;
+    cs.update(w, 0.0f);
+    return w;
+}
+
+void test_spatial_query_radius_and_aabb()
+{
+    std::cout << "\n--- TEST: Spatial Query (AABB / radius vs brute force) ---\n";
+    world w = make_query_world();
+    spatialQuery query(w);
+
+    int mismatches = 0;
+    for (int q = 0; q < 50; ++q)
+    {
+        vec2 c(-90.0f + q * 3.7f, 5.0f + q * 1.7f);
+        float r = 2.0f + (q % 7);
+
+        std::vector<int> got;
+        query.query_radius(c, r, got);
+        std::vector<int> expected;
+        for (size_t i = 0; i < w.size(); ++i)
+        {
+            float dx = w.position_x[i] - c.x, dy = w.position_y[i] - c.y;
+            float reach = r + w.radius[i];
+            if (dx * dx + dy * dy <= reach * reach)
+                expected.push_back((int)i);
+        }
+        std::sort(got.begin(), got.end());
+        mismatches += (got != expected);
+
+        AABB box{vec2(c.x - r, c.y - 0.5f * r), vec2(c.x + r, c.y + 0.5f * r)};
+        got.clear();
+        query.query_aabb(box, got);
+        expected.clear();
+        for (size_t i = 0; i < w.size(); ++i)
+        {
+            float px = w.position_x[i], py = w.position_y[i];
+            float dx = px - std::min(std::max(px, box.min.x), box.max.x);
+            float dy = py - std::min(std::max(py, box.min.y), box.max.y);
+            if (dx * dx + dy * dy <= w.radius[i] * w.radius[i])
+                expected.push_back((int)i);
+        }
+        std::sort(got.begin(), got.end());
+        mismatches += (got != expected);
+    }
+    std::cout << "AABB/radius query mismatches: " << mismatches << " (Should be 0)\n";
+
+    // Removing bodies leaves the grid stale: nothing is reported (no stale
+    // indices) until collisionSystem rebuilds it
+    for (int i = 0; i < 100; ++i)
+        w.remove_body(w.size() - 1);
+    std::vector<int> stale;
+    query.query_radius(vec2(0.0f, 50.0f), 200.0f, stale);
+    std::cout << "Bodies reported by a stale grid: " << stale.size() << " (Should be 0)\n";
+    collisionSystem cs;
+    cs.update(w, 0.0f);
+    spatialQuery rebuilt(w);
+    std::vector<int> all;
+    rebuilt.query_radius(vec2(0.0f, 50.0f), 200.0f, all);
+    std::cout << "Bodies reported after the rebuild: " << all.size() << " (Should be " << w.size() << ")\n";
+}
+
+void test_spatial_query_k_nearest_and_raycast()
+{
+    std::cout << "\n--- TEST: Spatial Query (k-nearest / raycast vs brute force) ---\n";
+    world w = make_query_world();
+    spatialQuery query(w);
+
+    int knn_mismatches = 0;
+    int ray_mismatches = 0;
+    for (int q = 0; q < 50; ++q)
+    {
+        vec2 p(-80.0f + q * 3.1f, 10.0f + q * 1.3f);
+        std::vector<int> got;
+        query.query_k_nearest(p, 5, got);
+        std::vector<std::pair<float, int>> all;
+        for (size_t i = 0; i < w.size(); ++i)
+        {
+            float dx = w.position_x[i] - p.x, dy = w.position_y[i] - p.y;
+            all.emplace_back(dx * dx + dy * dy, (int)i);
+        }
+        std::sort(all.begin(), all.end());
+        for (int k = 0; k < 5; ++k)
+            knn_mismatches += (k >= (int)got.size() || got[k] != all[k].second);
+
+        float angle = q * 0.37f;
+        Ray ray{vec2(-99.0f, 1.0f + q), vec2(std::cos(angle), std::sin(angle) * 0.5f), 150.0f};
+        RayHit hit;
+        query.raycast(ray, hit);
+        float best = 1e30f;
+        int best_body = -1;
+        float len = std::sqrt(dot(ray.direction, ray.direction));
+        vec2 d = ray.direction * (1.0f / len);
+        for (size_t i = 0; i < w.size(); ++i)
+        {
+            float mx = ray.origin.x - w.position_x[i], my = ray.origin.y - w.position_y[i];
+            float b = mx * d.x + my * d.y;
+            float c = mx * mx + my * my - w.radius[i] * w.radius[i];
+            float disc = b * b - c;
+            if (disc < 0.0f || (c > 0.0f && b > 0.0f))
+                continue;
+            float t = std::max(-b - std::sqrt(disc), 0.0f);
+            if (t <= ray.max_distance && t < best)
+            {
+                best = t;
+                best_body = (int)i;
+            }
+        }
+        ray_mismatches += (hit.body != best_body);
+    }
+    std::cout << "k-nearest mismatches: " << knn_mismatches << " (Should be 0)\n";
+    std::cout << "Raycast mismatches: " << ray_mismatches << " (Should be 0)\n";
+}
+
+void test_spatial_query_batched()
+{
+    std::cout << "\n--- TEST: Spatial Query (batched, thread pool) ---\n";
+    world w = make_query_world();
+    ThreadPool pool(4);
+    spatialQuery query(w, &pool);
+
+    std::vector<vec2> centers;
+    std::vector<float> radii;
+    for (int q = 0; q < 2000; ++q)
+    {
+        centers.emplace_back(-95.0f + (q % 100) * 1.9f, 2.0f + (q / 100) * 4.7f);
+        radii.push_back(1.0f + (q % 5));
+    }
+    QueryResults results;
+    query.query_radius_batch(centers.data(), radii.data(), centers.size(), results);
+
+    int mismatches = 0;
+    for (size_t q = 0; q < centers.size(); ++q)
+    {
+        std::vector<int> single;
+        query.query_radius(centers[q], radii[q], single);
+        std::vector<int> batched(results.begin(q), results.end(q));
+        mismatches += (single != batched);
+    }
+    std::cout << "Batched queries: " << results.num_queries() << ", mismatches vs single: " << mismatches << " (Should be 0)\n";
+}
+
+void test_spatial_query()
+{
+    test_spatial_query_radius_and_aabb();
+    test_spatial_query_k_nearest_and_raycast();
+    test_spatial_query_batched();
+}
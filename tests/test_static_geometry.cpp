@@ -0,0 +1,131 @@
+#include "utilities/test_helpers.hpp"
+#include "physics/staticGeometry.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+// tests/test_static_geometry.cpp
+
+void test_static_geometry_shapes()
+{
+    std::cout << "\n--- TEST: Static Geometry (circle vs segment / polygon) ---\n";
+
+    StaticGeometry geometry;
+    // 4x4 box centered at (30, 10), given clockwise to exercise the re-winding
+    vec2 box[4] = {vec2(28, 8), vec2(28, 12), vec2(32, 12), vec2(32, 8)};
+    int poly = geometry.add_polygon(box, 4);
+    int seg = geometry.add_segment(vec2(-5, 0), vec2(5, 0));
+
+    StaticContact c;
+    bool face = geometry.collide_circle(poly, 27.8f, 10.0f, 0.5f, c);
+    std::cout << "Face contact: " << face << " normal (" << c.normal.x << ", " << c.normal.y << ") depth " << c.penetration_depth
+              << " (Should be 1, (-1, 0), 0.3)\n";
+    bool inside = geometry.collide_circle(poly, 30.0f, 11.8f, 0.5f, c);
+    std::cout << "Center inside: " << inside << " normal (" << c.normal.x << ", " << c.normal.y << ") depth " << c.penetration_depth
+              << " (Should be 1, (0, 1), 0.7)\n";
+    bool corner = geometry.collide_circle(poly, 32.3f, 12.3f, 0.5f, c);
+    std::cout << "Corner contact: " << corner << " normal (" << c.normal.x << ", " << c.normal.y << ") depth " << c.penetration_depth
+              << " (Should be 1, (0.707, 0.707), ~0.076)\n";
+    bool miss = geometry.collide_circle(poly, 32.5f, 12.5f, 0.5f, c);
+    std::cout << "Corner miss: " << miss << " (Should be 0)\n";
+    bool below = geometry.collide_circle(seg, 1.0f, -0.2f, 0.5f, c);
+    std::cout << "Segment from below: " << below << " normal (" << c.normal.x << ", " << c.normal.y << ") depth " << c.penetration_depth
+              << " (Should be 1, (0, -1), 0.3)\n";
+}
+
+void test_static_geometry_simulation()
+{
+    std::cout << "\n--- TEST: Static Geometry (bodies resting on level colliders) ---\n";
+
+    // A ball dropped on a floor made of two chained segments, right above the joint
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = -9.8f;
+    w.delta_time = 0.016f;
+    w.static_geometry.add_segment(vec2(-20, 10), vec2(0, 10), 0.0f);
+    w.static_geometry.add_segment(vec2(0, 10), vec2(20, 10), 0.0f);
+    w.add_body(create_body(0.0f, 15.0f, 0, 0, 1, 0.5f, 0.0f));
+
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+    for (int t = 0; t < 240; ++t)
+        manager.update(w, w.delta_time);
+    std::cout << "Resting height on chained segments: " << w.position_y[0] << " (Should be ~10.5)\n";
+
+    // A circle overlapping the joint is pushed out once, not once per segment
+    world joint;
+    joint.gravity_x = 0.0f;
+    joint.gravity_y = 0.0f;
+    joint.delta_time = 0.016f;
+    joint.static_geometry.add_segment(vec2(-20, 20), vec2(0, 20));
+    joint.static_geometry.add_segment(vec2(0, 20), vec2(20, 20));
+    joint.add_body(create_body(0.0f, 20.3f, 0, 0, 1, 0.5f));
+    collisionSystem cs;
+    cs.update(joint, joint.delta_time);
+    std::cout << "Height after joint push-out: " << joint.position_y[0] << " (Should be 20.5)\n";
+}
+
+void test_static_geometry_grid()
+{
+    std::cout << "\n--- TEST: Static Geometry (baked grid vs brute force) ---\n";
+
+    unsigned seed = 777u;
+    auto next = [&seed]()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return float(seed >> 8) / float(1u << 24);
+    };
+
+    world w;
+    StaticGeometry &geometry = w.static_geometry;
+    for (int i = 0; i < 1500; ++i)
+    {
+        vec2 a(-95.0f + 190.0f * next(), -95.0f + 190.0f * next());
+        vec2 b = a + vec2(-15.0f + 30.0f * next(), -15.0f + 30.0f * next());
+        geometry.add_segment(a, b);
+    }
+    for (int i = 0; i < 300; ++i)
+    {
+        vec2 c(-95.0f + 190.0f * next(), -95.0f + 190.0f * next());
+        float size = 0.5f + 8.0f * next();
+        vec2 tri[3] = {c, c + vec2(size, 0.0f), c + vec2(size * next(), size)};
+        geometry.add_polygon(tri, 3);
+    }
+    geometry.bake(w.grid_info);
+
+    int mismatches = 0;
+    for (int q = 0; q < 2000; ++q)
+    {
+        float cx = -100.0f + 200.0f * next();
+        float cy = -100.0f + 200.0f * next();
+        float r = 0.2f + 3.0f * next();
+
+        std::vector<int> found;
+        geometry.for_each_circle_contact(cx, cy, r, 1u, ~0u, [&](const StaticContact &contact)
+        {
+            found.push_back(contact.shape);
+        });
+        std::vector<int> expected;
+        for (int s = 0; s < int(geometry.size()); ++s)
+        {
+            StaticContact contact;
+            if (geometry.collide_circle(s, cx, cy, r, contact))
+                expected.push_back(s);
+        }
+        std::sort(found.begin(), found.end());
+        mismatches += found == expected ? 0 : 1;
+    }
+    std::cout << "Circle queries vs brute force mismatches: " << mismatches << " (Should be 0)\n";
+}
+
+void test_static_geometry()
+{
+    test_static_geometry_shapes();
+    test_static_geometry_simulation();
+    test_static_geometry_grid();
+}
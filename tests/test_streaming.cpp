@@ -0,0 +1,163 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/streamingSystem.hpp"
+#include "sim/systemManager.hpp"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+
+// tests/test_streaming.cpp
+
+// Resting bodies on a lattice over a 400 x 400 domain above the floor (8 x 8 chunks of 50)
+static world make_open_world()
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = 0.0f;
+    w.delta_time = 1.0f / 60.0f;
+    w.global_damping = 0.0f;
+    w.grid_info.min_x = -200.0f;
+    w.grid_info.max_x = 200.0f;
+    w.grid_info.min_y = 0.0f;
+    w.grid_info.max_y = 400.0f;
+    w.resize_grid();
+    for (float y = 2.5f; y < 400.0f; y += 5.0f)
+        for (float x = -197.5f; x < 200.0f; x += 5.0f)
+            w.add_body(create_body(x, y, 0.0f, 0.0f, 1.0f, 0.5f));
+    return w;
+}
+
+static int find_body_near(const world &w, float x, float y)
+{
+    for (size_t i = 0; i < w.size(); ++i)
+        if (std::fabs(w.position_x[i] - x) < 1e-3f && std::fabs(w.position_y[i] - y) < 1e-3f)
+            return int(i);
+    return -1;
+}
+
+void test_streaming()
+{
+    std::cout << "\n--- TEST: Chunk Streaming ---\n";
+
+    world w = make_open_world();
+    const size_t total = w.size();
+    // A far body with distinctive properties, to check the round trip
+    body marked = create_body(171.0f, 371.0f, 0.0f, 0.0f, 3.5f, 0.7f, 0.3f);
+    marked.damping = 0.25f;
+    marked.friction = 0.4f;
+    marked.collision_category = 4u;
+    marked.collision_mask = 6u;
+    w.add_body(marked);
+    w.set_fluid(w.size() - 1, true);
+
+    auto streaming = std::make_unique<streamingSystem>(".", 50.0f);
+    streamingSystem *streamer = streaming.get();
+    systemManager manager;
+    manager.addSystem(std::move(streaming));
+    manager.addSystem(std::make_unique<movementSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>());
+
+    // Time the full world first (no observers: everything stays resident)
+    manager.update(w, w.delta_time);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < 20; ++step)
+        manager.update(w, w.delta_time);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "Resident bodies without observers: " << w.size() << " (Should be " << total + 1 << ")\n";
+
+    // One observer in the middle of a corner chunk: only that chunk stays
+    w.stream_observers = {vec2(-175.0f, 25.0f)};
+    w.stream_load_radius = 10.0f;
+    w.stream_evict_radius = 20.0f;
+    manager.update(w, w.delta_time);
+    streamer->flush();
+    std::cout << "Chunks: " << streamer->num_chunks_x() << " x " << streamer->num_chunks_y() << " (Should be 8 x 8)\n";
+    std::cout << "Resident chunks / bodies: " << streamer->resident_chunks() << " / " << w.size() << " (Should be 1 / 100)\n";
+    std::cout << "Bodies on disk: " << streamer->bodies_on_disk() << " (Should be " << total + 1 - 100 << ")\n";
+    std::cout << "Far chunk on disk: " << (streamer->state_of(7, 7) == streamingSystem::ChunkState::OnDisk ? "yes" : "no") << " (Should be yes)\n";
+    std::cout << "Bytes written: " << streamer->bytes_written() << " (for information)\n";
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < 20; ++step)
+        manager.update(w, w.delta_time);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    double full_ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / 20.0;
+    double streamed_ms = std::chrono::duration<double, std::milli>(t3 - t2).count() / 20.0;
+    std::cout << "Step with all " << total + 1 << " bodies / with the observer's area only: " << full_ms << " / " << streamed_ms
+              << " ms (Should be first > second)\n";
+
+    // Walk the observer to the other corner: those chunks load back in the background
+    w.stream_observers = {vec2(175.0f, 375.0f)};
+    manager.update(w, w.delta_time); // Queues the reads, evicts the old corner
+    streamer->flush();
+    manager.update(w, w.delta_time); // Applies the reads
+    std::cout << "Resident bodies after moving: " << w.size() << " (Should be 101)\n";
+    std::cout << "Bodies conserved (resident + on disk): " << w.size() + streamer->bodies_on_disk() << " (Should be " << total + 1 << ")\n";
+    std::cout << "Old corner on disk: " << (streamer->state_of(0, 0) == streamingSystem::ChunkState::OnDisk ? "yes" : "no") << " (Should be yes)\n";
+
+    int back = find_body_near(w, 171.0f, 371.0f);
+    bool same = back >= 0 && w.mass[back] == 3.5f && w.inv_mass[back] == marked.inv_mass && w.radius[back] == 0.7f && w.restitution[back] == 0.3f &&
+                w.damping[back] == 0.25f && w.friction[back] == 0.4f && w.collision_category[back] == 4u && w.collision_mask[back] == 6u &&
+                w.fluid[back] == 1;
+    std::cout << "Marked body loaded back with all its properties: " << (same ? "yes" : "no") << " (Should be yes)\n";
+
+    // Without observers nothing is evicted, and nothing loads either
+    w.stream_observers.clear();
+    manager.update(w, w.delta_time);
+    std::cout << "Chunks on disk with no observers: " << 64 - streamer->resident_chunks() << " (Should be 63, they wait for an observer)\n";
+    std::cout << "Resident bodies with no observers: " << w.size() << " (Should be 101, nothing more is evicted)\n";
+
+    // Missing directory: reported, and every body stays in the world
+    world missing = make_open_world();
+    streamingSystem no_disk("./no_such_streaming_dir", 50.0f);
+    missing.stream_observers = {vec2(-175.0f, 25.0f)};
+    missing.stream_load_radius = 10.0f;
+    missing.stream_evict_radius = 20.0f;
+    no_disk.update(missing, missing.delta_time);
+    no_disk.flush();
+    std::cout << "Missing directory: failures " << no_disk.io_failures() << ", resident bodies " << missing.size() << " (Should be 1, " << total
+              << ")\n";
+
+    // A chunk file that cannot be written (a directory sits at its path):
+    // its bodies come back on the next step instead of being lost
+    const std::string scratch = "./streaming_fail_scratch";
+    std::filesystem::create_directories(scratch + "/chunk_7_7.bin");
+    {
+        world failing = make_open_world();
+        streamingSystem unwritable(scratch, 50.0f);
+        failing.stream_observers = {vec2(-175.0f, 25.0f)};
+        failing.stream_load_radius = 10.0f;
+        failing.stream_evict_radius = 20.0f;
+        unwritable.update(failing, failing.delta_time);
+        unwritable.flush();
+        failing.stream_observers.clear(); // Nothing more is evicted or loaded
+        unwritable.update(failing, failing.delta_time);
+        std::cout << "Failed write: failures > 0: " << (unwritable.io_failures() > 0 ? "yes" : "no") << " (Should be yes)\n";
+        std::cout << "Far chunk's body back in the world: " << (find_body_near(failing, 197.5f, 397.5f) >= 0 ? "yes" : "no") << " (Should be yes)\n";
+        std::cout << "Resident bodies: " << failing.size() << " (Should be 200, the observer's chunk and the unwritable one)\n";
+        std::cout << "Unwritable chunk after the failure: " << (unwritable.state_of(7, 7) == streamingSystem::ChunkState::Resident ? "resident" : "not resident")
+                  << " (Should be resident)\n";
+
+        // The observer stays away: the chunk is not retried every step
+        const uint64_t failures_before = unwritable.io_failures();
+        failing.stream_observers = {vec2(-175.0f, 25.0f)};
+        for (int t = 0; t < 30; ++t)
+        {
+            unwritable.update(failing, failing.delta_time);
+            unwritable.flush();
+        }
+        std::cout << "Write failures over the next 30 steps: " << unwritable.io_failures() - failures_before << ", resident bodies " << failing.size()
+                  << " (Should be 0, 200)\n";
+
+        // Coming back loads nothing and reports nothing
+        failing.stream_observers = {vec2(197.5f, 397.5f)};
+        unwritable.update(failing, failing.delta_time);
+        unwritable.flush();
+        unwritable.update(failing, failing.delta_time);
+        std::cout << "Failures after returning to the chunk: " << unwritable.io_failures() - failures_before << " (Should be 0)\n";
+    }
+    std::filesystem::remove_all(scratch);
+}
@@ -0,0 +1,190 @@
+#include "utilities/test_helpers.hpp"
+#include "physics/worldBatch.hpp"
+#include "sim/collisionSystem.hpp"
+#include "sim/movementSystem.hpp"
+#include "sim/systemManager.hpp"
+#include "utils/threadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+// tests/test_world_batch.cpp
+
+// Verlet reads velocity from (position - previous): match the bodies' velocities
+static void sync_previous_positions(world &w)
+{
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        w.previous_position_x[i] = w.position_x[i] - w.vel_x[i] * w.delta_time;
+        w.previous_position_y[i] = w.position_y[i] - w.vel_y[i] * w.delta_time;
+    }
+}
+
+// A small box of `count` bouncing bodies with its own gravity
+static world make_small_world(int count, float gravity, unsigned seed)
+{
+    world w;
+    w.gravity_x = 0.0f;
+    w.gravity_y = gravity;
+    w.delta_time = 1.0f / 60.0f;
+    w.grid_info.min_x = 0.0f;
+    w.grid_info.max_x = 40.0f;
+    w.grid_info.min_y = 0.0f;
+    w.grid_info.max_y = 40.0f;
+    w.resize_grid();
+    std::srand(seed);
+    auto random_in = [](float lo, float hi) { return lo + (hi - lo) * float(std::rand()) / float(RAND_MAX); };
+    for (int i = 0; i < count; ++i)
+        w.add_body(create_body(random_in(1.0f, 39.0f), random_in(1.0f, 39.0f), random_in(-5.0f, 5.0f), random_in(-5.0f, 5.0f), 1, 0.5f, 0.8f));
+    sync_previous_positions(w);
+    return w;
+}
+
+static float world_difference(const WorldBatch &a, int world_a, const WorldBatch &b, int world_b)
+{
+    float worst = 0.0f;
+    for (int i = 0; i < a.world_size(world_a); ++i)
+    {
+        vec2 pa = a.position(world_a, i), pb = b.position(world_b, i);
+        worst = std::max(worst, std::max(std::fabs(pa.x - pb.x), std::fabs(pa.y - pb.y)));
+    }
+    return worst;
+}
+
+void test_world_batch_kernels()
+{
+    std::cout << "\n--- TEST: World Batch (per-world kernels) ---\n";
+
+    // Free fall matches movementSystem (same Verlet policy)
+    world falling = make_small_world(0, -9.8f, 1);
+    falling.global_damping = 0.3f;
+    falling.add_body(create_body(20.0f, 35.0f, 1.0f, 0.0f, 1, 0.5f));
+    sync_previous_positions(falling);
+    WorldBatch batch;
+    batch.add_world(falling);
+    systemManager manager;
+    manager.addSystem(std::make_unique<movementSystem>());
+    for (int step = 0; step < 60; ++step)
+    {
+        batch.step();
+        manager.update(falling, falling.delta_time);
+    }
+    vec2 batched = batch.position(0, 0);
+    std::cout << "Free fall, batch vs movementSystem: (" << batched.x << ", " << batched.y << ") vs (" << falling.position_x[0] << ", "
+              << falling.position_y[0] << ") (Should be equal)\n";
+
+    // Head-on elastic pair swaps velocities
+    world pair = make_small_world(0, 0.0f, 1);
+    pair.global_damping = 0.0f;
+    pair.add_body(create_body(18.0f, 20.0f, 2.0f, 0.0f, 1, 0.5f, 1.0f));
+    pair.add_body(create_body(22.0f, 20.0f, -2.0f, 0.0f, 1, 0.5f, 1.0f));
+    sync_previous_positions(pair);
+    WorldBatch pair_batch;
+    pair_batch.add_world(pair);
+    for (int step = 0; step < 90; ++step)
+        pair_batch.step();
+    std::cout << "Velocities after the collision: " << pair_batch.vel_x[0] << ", " << pair_batch.vel_x[1] << " (Should be ~-2, ~2)\n";
+
+    // Per-world gravity: the same bodies fall further under stronger gravity
+    WorldBatch gravities;
+    gravities.add_world(make_small_world(20, -2.0f, 9));
+    gravities.add_world(make_small_world(20, -20.0f, 9));
+    for (int step = 0; step < 30; ++step)
+        gravities.step();
+    float mean_weak = 0.0f, mean_strong = 0.0f;
+    for (int i = 0; i < 20; ++i)
+    {
+        mean_weak += gravities.position(0, i).y / 20.0f;
+        mean_strong += gravities.position(1, i).y / 20.0f;
+    }
+    std::cout << "Mean height, g = 2 / g = 20: " << mean_weak << " / " << mean_strong << " (Should be first > second)\n";
+}
+
+void test_world_batch_runner()
+{
+    std::cout << "\n--- TEST: World Batch (thousands of worlds) ---\n";
+
+    // 2000 worlds of 10 to 200 bodies, each with its own gravity
+    const int worlds = 2000;
+    WorldBatch batch;
+    size_t bodies = 0;
+    for (int w = 0; w < worlds; ++w)
+    {
+        batch.add_world(make_small_world(10 + (w * 37) % 191, -1.0f - float(w % 10), unsigned(w)));
+        bodies += size_t(10 + (w * 37) % 191);
+    }
+    WorldBatch pooled = batch;
+    WorldBatch alone;
+    alone.add_world(make_small_world(10 + (777 * 37) % 191, -1.0f - float(777 % 10), 777u));
+
+    ThreadPool pool(4);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < 120; ++step)
+        batch.step();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < 120; ++step)
+    {
+        pooled.step(&pool);
+        alone.step();
+    }
+
+    float worst_pooled = 0.0f;
+    for (int w = 0; w < worlds; ++w)
+        worst_pooled = std::max(worst_pooled, world_difference(batch, w, pooled, w));
+    std::cout << "Worlds / bodies: " << batch.num_worlds() << " / " << batch.num_bodies() << " (Should be 2000 / " << bodies << ")\n";
+    std::cout << "Serial vs pooled difference: " << worst_pooled << " (Should be 0)\n";
+    std::cout << "World 777 in the batch vs alone: " << world_difference(batch, 777, alone, 0) << " (Should be 0, worlds never interact)\n";
+
+    // Nothing leaves its box and contacts are being resolved
+    bool inside = true;
+    uint64_t contacts = 0;
+    for (int w = 0; w < worlds; ++w)
+    {
+        contacts += batch.contact_count[w];
+        for (int i = 0; i < batch.world_size(w); ++i)
+        {
+            vec2 p = batch.position(w, i);
+            inside &= p.x >= 0.0f && p.x <= 40.0f && p.y >= 0.0f && p.y <= 40.0f;
+        }
+    }
+    std::cout << "All bodies inside their walls: " << (inside ? "yes" : "no") << " (Should be yes)\n";
+    std::cout << "Contacts on the last step: " << contacts << " (Should be > 0)\n";
+
+    // Reset one world: it replays its first run exactly, the others carry on
+    vec2 before = batch.position(5, 0);
+    batch.reset_world(777);
+    for (int step = 0; step < 120; ++step)
+        batch.step();
+    std::cout << "World 777 replayed after reset: " << world_difference(batch, 777, alone, 0) << " (Should be 0)\n";
+    std::cout << "Other worlds kept going: " << (batch.position(5, 0).x != before.x || batch.position(5, 0).y != before.y ? "yes" : "no")
+              << " (Should be yes)\n";
+
+    // Same worlds as one world + systemManager each
+    std::vector<world> separate;
+    std::vector<std::unique_ptr<systemManager>> managers;
+    for (int w = 0; w < worlds; ++w)
+    {
+        separate.push_back(make_small_world(10 + (w * 37) % 191, -1.0f - float(w % 10), unsigned(w)));
+        managers.push_back(std::make_unique<systemManager>());
+        managers.back()->addSystem(std::make_unique<movementSystem>());
+        managers.back()->addSystem(std::make_unique<collisionSystem>());
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int step = 0; step < 10; ++step)
+        for (int w = 0; w < worlds; ++w)
+            managers[w]->update(separate[w], separate[w].delta_time);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    double batch_ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / 120.0;
+    double separate_ms = std::chrono::duration<double, std::milli>(t3 - t2).count() / 10.0;
+    std::cout << "Step of " << worlds << " worlds, batch / separate managers: " << batch_ms << " / " << separate_ms << " ms (for information)\n";
+}
+
+void test_world_batch()
+{
+    test_world_batch_kernels();
+    test_world_batch_runner();
+}
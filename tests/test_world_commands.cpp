@@ -0,0 +1,143 @@
+#include "utilities/test_helpers.hpp"
+#include "sim/systemManager.hpp"
+#include "sim/worldCommands.hpp"
+#include "utils/mpscQueue.hpp"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// tests/test_world_commands.cpp
+
+void test_mpsc_queue()
+{
+    std::cout << "\n--- TEST: MPSC Queue ---\n";
+
+    // Four producers, one consumer draining concurrently
+    const int producers = 4;
+    const uint32_t per_producer = 50000;
+    MpscQueue<uint32_t> queue(256);
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> rejected{0};
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&, p]
+        {
+            for (uint32_t i = 0; i < per_producer; ++i)
+            {
+                uint32_t value = uint32_t(p) << 24 | i;
+                while (!queue.try_push(value))
+                {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    std::vector<uint32_t> next(producers, 0);
+    bool in_order = true;
+    uint64_t received = 0;
+    uint32_t value;
+    while (received < uint64_t(producers) * per_producer)
+    {
+        if (!queue.try_pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t producer = value >> 24;
+        in_order &= (value & 0xFFFFFF) == next[producer];
+        next[producer] = (value & 0xFFFFFF) + 1;
+        ++received;
+    }
+    for (auto &t : threads)
+        t.join();
+    std::cout << "Values received: " << received << " (Should be " << producers * per_producer << ")\n";
+    std::cout << "Each producer's values in order, none lost or repeated: " << (in_order ? "yes" : "no") << " (Should be yes)\n";
+    std::cout << "Queue empty afterwards: " << (queue.try_pop(value) ? "no" : "yes") << " (Should be yes)\n";
+    std::cout << "Pushes rejected while full: " << rejected.load() << " (for information, capacity " << queue.capacity() << ")\n";
+
+    // Bounded: a full queue refuses instead of growing
+    MpscQueue<uint32_t> small(4);
+    int accepted = 0;
+    for (uint32_t i = 0; i < 10; ++i)
+        accepted += small.try_push(i) ? 1 : 0;
+    std::cout << "Pushes accepted by a queue of 4: " << accepted << " (Should be 4)\n";
+}
+
+void test_world_command_apply()
+{
+    std::cout << "\n--- TEST: World Commands ---\n";
+
+    world w;
+    w.delta_time = 1.0f / 60.0f;
+    for (int i = 0; i < 6; ++i)
+        w.add_body(create_body(float(i) * 10.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.5f));
+    WorldCommandQueue commands(64);
+
+    // Same body: applied in arrival order even though the batch is sorted
+    commands.push(WorldCommand::impulse(3, vec2(4.0f, 0.0f)));
+    commands.push(WorldCommand::teleport(1, vec2(-5.0f, 7.0f)));
+    commands.push(WorldCommand::teleport(3, vec2(100.0f, 100.0f)));
+    commands.push(WorldCommand::impulse(3, vec2(0.0f, 2.0f)));
+    commands.push(WorldCommand::set_velocity(0, vec2(1.0f, 1.0f)));
+    commands.push(WorldCommand::impulse(99, vec2(1.0f, 1.0f))); // No such body
+    size_t applied = commands.apply(w);
+    std::cout << "Commands applied: " << applied << " (Should be 5, the unknown body is dropped)\n";
+    std::cout << "Body 3 after impulse, teleport, impulse: pos (" << w.position_x[3] << ", " << w.position_y[3] << ") vel (" << w.vel_x[3] << ", "
+              << w.vel_y[3] << ") (Should be (100, 100) vel (0, 1))\n";
+    std::cout << "Body 1 teleported: (" << w.position_x[1] << ", " << w.position_y[1] << ") (Should be (-5, 7))\n";
+    float implied = (w.position_x[0] - w.previous_position_x[0]) / w.delta_time;
+    std::cout << "Body 0 velocity / implied by Verlet state: " << w.vel_x[0] << " / " << implied << " (Should be 1 / 1)\n";
+
+    // Removals by descending index: every listed body goes, whatever the order posted
+    float kept_x = w.position_x[2];
+    commands.push(WorldCommand::remove(1));
+    commands.push(WorldCommand::remove(5));
+    commands.push(WorldCommand::remove(4));
+    commands.push(WorldCommand::spawn(vec2(1.0f, 2.0f), vec2(3.0f, 0.0f), 4.0f, 1.5f));
+    commands.apply(w);
+    bool kept = false;
+    for (size_t i = 0; i < w.size(); ++i)
+        kept |= w.position_x[i] == kept_x;
+    std::cout << "Bodies after 3 removals and a spawn: " << w.size() << " (Should be 4)\n";
+    std::cout << "Body that was not removed still there: " << (kept ? "yes" : "no") << " (Should be yes)\n";
+    size_t spawned = w.size() - 1;
+    std::cout << "Spawned body: pos (" << w.position_x[spawned] << ", " << w.position_y[spawned] << ") inv_mass " << w.inv_mass[spawned]
+              << " (Should be (1, 2) inv_mass 0.25)\n";
+
+    // The same body removed twice in one drain is removed once
+    commands.push(WorldCommand::remove(0));
+    commands.push(WorldCommand::remove(0));
+    applied = commands.apply(w);
+    std::cout << "Double removal of body 0: applied " << applied << ", bodies left " << w.size() << " (Should be 1, 3)\n";
+
+    // systemManager drains the queue at the start of update, from any thread
+    systemManager manager;
+    world pushed;
+    pushed.delta_time = 1.0f / 60.0f;
+    pushed.add_body(create_body(0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&manager]
+        {
+            for (int i = 0; i < 250; ++i)
+                while (!manager.commands().push(WorldCommand::impulse(0, vec2(0.01f, 0.0f))))
+                    std::this_thread::yield();
+        });
+    // Step while the producers are still pushing
+    for (int step = 0; step < 100000 && pushed.vel_x[0] < 9.999f; ++step)
+    {
+        manager.update(pushed, pushed.delta_time);
+        std::this_thread::yield();
+    }
+    for (auto &t : threads)
+        t.join();
+    std::cout << "Velocity after 1000 impulses of 0.01 from 4 threads: " << pushed.vel_x[0] << " (Should be ~10)\n";
+}
+
+void test_world_commands()
+{
+    test_mpsc_queue();
+    test_world_command_apply();
+}
@@ -6,13 +6,24 @@
 #include <string>
 #include <vector>
 #include <ctime>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <memory>
 #include <sys/stat.h>
 
 #include "physics/world.hpp"
 #include "physics/body.hpp"
+#include "physics/worldBatch.hpp"
+#include "physics/rollbackBuffer.hpp"
 #include "sim/systemManager.hpp"
 #include "sim/movementSystem.hpp"
 #include "sim/collisionSystem.hpp"
+#include "sim/fluidSystem.hpp"
+#include "sim/forceFieldSystem.hpp"
+#include "sim/mutualGravitySystem.hpp"
+#include "sim/xpbdSystem.hpp"
+#include "utils/threadPool.hpp"
 
 // Minimal mkdir -p for portability
 static void ensure_dir(const std::string &path)
@@ -37,6 +48,17 @@ int main(int argc, char **argv)
     int N = 1000;
     int frames = 1000;
     int warmup = 100;
+    bool incremental_grid = false;
+    bool tiled_broad_phase = false;
+    int xpbd_substeps = 0;
+    float neighbor_skin = 0.0f;
+    int island_threads = 0;
+    bool simd_contacts = false;
+    float gravity_theta = -1.0f;
+    float sph_radius = 0.0f;
+    int batch_worlds = 0;
+    int rollback_frames = 0;
+    IntegratorMode integrator = IntegratorMode::Verlet;
     for (int i = 1; i < argc; ++i)
     {
         std::string a = argv[i];
@@ -46,6 +68,30 @@ int main(int argc, char **argv)
             frames = std::stoi(argv[++i]);
         if (a == "--warmup" && i + 1 < argc)
             warmup = std::stoi(argv[++i]);
+        if (a == "--incremental-grid")
+            incremental_grid = true;
+        if (a == "--tiled-broad-phase")
+            tiled_broad_phase = true;
+        if (a == "--neighbor-list" && i + 1 < argc)
+            neighbor_skin = std::stof(argv[++i]);
+        if (a == "--simd-contacts")
+            simd_contacts = true;
+        if (a == "--mutual-gravity" && i + 1 < argc)
+            gravity_theta = std::stof(argv[++i]);
+        if (a == "--sph" && i + 1 < argc)
+            sph_radius = std::stof(argv[++i]);
+        if (a == "--batch" && i + 1 < argc)
+            batch_worlds = std::stoi(argv[++i]);
+        if (a == "--rollback" && i + 1 < argc)
+            rollback_frames = std::stoi(argv[++i]);
+        if (a == "--islands" && i + 1 < argc)
+            island_threads = std::stoi(argv[++i]);
+        if (a == "--xpbd" && i + 1 < argc)
+            xpbd_substeps = std::stoi(argv[++i]);
+        if (a == "--semi-implicit-euler")
+            integrator = IntegratorMode::SemiImplicitEuler;
+        if (a == "--explicit-euler")
+            integrator = IntegratorMode::ExplicitEuler;
     }
 
     ensure_dir("benchmarks");
@@ -70,13 +116,71 @@ int main(int argc, char **argv)
     sim_world.gravity_x = 0.0f;
     sim_world.gravity_y = -9.8f;
     sim_world.delta_time = 1.0f / 60.0f;
+    sim_world.incremental_grid = incremental_grid;
+    sim_world.tiled_broad_phase = tiled_broad_phase;
+    if (neighbor_skin > 0.0f)
+    {
+        sim_world.neighbor_lists = true;
+        sim_world.neighbor_skin = neighbor_skin;
+    }
+    sim_world.island_solving = island_threads > 0;
+    sim_world.simd_contact_solver = simd_contacts;
+    if (gravity_theta >= 0.0f)
+    {
+        sim_world.mutual_gravity = true;
+        sim_world.barnes_hut_theta = gravity_theta;
+    }
+    sim_world.integrator = integrator;
+    if (xpbd_substeps > 0)
+    {
+        sim_world.integrator = IntegratorMode::XPBD;
+        sim_world.xpbd_substeps = xpbd_substeps;
+    }
     for (auto &b : bodies)
         sim_world.add_body(b);
+    if (sph_radius > 0.0f)
+    {
+        // Every body is a fluid particle, at rest at the lattice spacing
+        sim_world.sph_fluid = true;
+        sim_world.fluid_smoothing_radius = sph_radius;
+        sim_world.fluid_rest_density = 1.0f / (spacing * spacing);
+        for (size_t i = 0; i < sim_world.size(); ++i)
+            sim_world.set_fluid(i, true);
+    }
 
     // Prepare systems
+    std::unique_ptr<ThreadPool> pool;
+    if (island_threads > 0)
+        pool = std::make_unique<ThreadPool>(unsigned(island_threads));
     systemManager manager;
+    manager.addSystem(std::make_unique<forceFieldSystem>());
+    manager.addSystem(std::make_unique<mutualGravitySystem>(pool.get()));
+    manager.addSystem(std::make_unique<fluidSystem>(pool.get()));
     manager.addSystem(std::make_unique<movementSystem>());
-    manager.addSystem(std::make_unique<collisionSystem>());
+    manager.addSystem(std::make_unique<collisionSystem>(pool.get()));
+    manager.addSystem(std::make_unique<xpbdSystem>());
+
+    // Batched mode: batch_worlds copies of the world stepped together
+    if (batch_worlds > 0)
+    {
+        WorldBatch batch;
+        for (int w = 0; w < batch_worlds; ++w)
+            batch.add_world(sim_world);
+        for (int i = 0; i < warmup; ++i)
+            batch.step(pool.get());
+        std::ofstream out(out_csv);
+        out << "frame,total_us,broad_us,narrow_us,resolve_us\n";
+        for (int f = 0; f < frames; ++f)
+        {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            batch.step(pool.get());
+            auto t1 = std::chrono::high_resolution_clock::now();
+            out << f << "," << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << ",0,0,0\n";
+        }
+        out.close();
+        std::cout << "Wrote " << out_csv << "\n";
+        return 0;
+    }
 
     // Warmup
     for (int i = 0; i < warmup; ++i)
@@ -84,6 +188,11 @@ int main(int argc, char **argv)
         manager.update(sim_world, sim_world.delta_time);
     }
 
+    // Rollback mode: every frame restores rollback_frames back and resimulates them
+    RollbackBuffer rollback(size_t(std::max(rollback_frames, 0)) + 1);
+    if (rollback_frames > 0)
+        rollback.save(sim_world, 0);
+
     // Measurement
     std::ofstream out(out_csv);
     out << "frame,total_us,broad_us,narrow_us,resolve_us\n";
@@ -92,6 +201,18 @@ int main(int argc, char **argv)
     {
         auto t0 = std::chrono::high_resolution_clock::now();
         manager.update(sim_world, sim_world.delta_time);
+        if (rollback_frames > 0)
+        {
+            uint64_t frame = uint64_t(f) + 1;
+            rollback.save(sim_world, frame);
+            uint64_t target = frame > uint64_t(rollback_frames) ? frame - uint64_t(rollback_frames) : 0;
+            if (rollback.restore(sim_world, target))
+                for (uint64_t resimulated = target + 1; resimulated <= frame; ++resimulated)
+                {
+                    manager.update(sim_world, sim_world.delta_time);
+                    rollback.save(sim_world, resimulated);
+                }
+        }
         auto t1 = std::chrono::high_resolution_clock::now();
         auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
 